@@ -16,6 +16,7 @@
 #include "StPicoD0EventMaker/StKaonPion.h"
 #include "StPicoD0AnaMaker.h"
 #include "StPicoHFMaker/StHFCuts.h"
+#include "StPicoHFMaker/StHFDaughter.h"
 
 ClassImp(StPicoD0AnaMaker)
 
@@ -54,6 +55,7 @@ Int_t StPicoD0AnaMaker::Init()
 
    if (!mHFCuts)
     mHFCuts = new StHFCuts;   
+   mHFCuts->finalize();
 
    // -------------- USER VARIABLES -------------------------
    
@@ -80,10 +82,22 @@ Int_t StPicoD0AnaMaker::Make()
 {
    readNextEvent();
 
+   // replay of the StPicoD0Event files only, using the stored kaons and pions
    if (!mPicoDstMaker)
    {
-      LOG_WARN << " StPicoD0AnaMaker - No PicoDstMaker! Skip! " << endm;
-      return kStWarn;
+      TClonesArray const * aKaonPion = mPicoD0Event->kaonPionArray();
+
+      for (int idx = 0; idx < aKaonPion->GetEntries(); ++idx)
+      {
+         StKaonPion const* kp = (StKaonPion*)aKaonPion->At(idx);
+         if(!kp) continue;
+
+         StHFDaughter const* kaon = mPicoD0Event->daughter(kp->kaonIdx());
+         StHFDaughter const* pion = mPicoD0Event->daughter(kp->pionIdx());
+         if(!isGoodReplayPair(kp, kaon, pion)) continue;
+      }
+
+      return kStOK;
    }
 
    StPicoDst const* picoDst = mPicoDstMaker->picoDst();
@@ -126,15 +140,23 @@ bool StPicoD0AnaMaker::isGoodPair(StKaonPion const* const kp) const
   StPicoTrack const* kaon = mPicoDstMaker->picoDst()->track(kp->kaonIdx());
   StPicoTrack const* pion = mPicoDstMaker->picoDst()->track(kp->pionIdx());
 
-  //  To be replaced by mHFCuts->isGoodSecondaryVertexPair(kp))
-  bool pairCuts = kp->m() > mHFCuts->cutSecondaryPairMassMin() && 
-    kp->m() < mHFCuts->cutSecondaryPairMassMax() &&
-    std::cos(kp->pointingAngle()) > mHFCuts->cutSecondaryPairCosThetaMin() &&
-    kp->decayLength()  > mHFCuts->cutSecondaryPairDecayLengthMin() && 
-    kp->decayLength()  < mHFCuts->cutSecondaryPairDecayLengthMax() &&
-    kp->dcaDaughters() < mHFCuts->cutSecondaryPairDcaDaughtersMax();
+  return (mHFCuts->isGoodTrack(kaon) && mHFCuts->isGoodTrack(pion) &&
+	  mHFCuts->isTPCKaon(kaon) && mHFCuts->isTPCPion(pion) && 
+	  isGoodPairCuts(kp));
+}
+//-----------------------------------------------------------------------------
+bool StPicoD0AnaMaker::isGoodReplayPair(StKaonPion const* const kp, StHFDaughter const* const kaon, 
+                                        StHFDaughter const* const pion) const
+{
+  if(!kp || !kaon || !pion) return false;
 
   return (mHFCuts->isGoodTrack(kaon) && mHFCuts->isGoodTrack(pion) &&
 	  mHFCuts->isTPCKaon(kaon) && mHFCuts->isTPCPion(pion) && 
-	  pairCuts);
+	  isGoodPairCuts(kp));
+}
+//-----------------------------------------------------------------------------
+bool StPicoD0AnaMaker::isGoodPairCuts(StKaonPion const* const kp) const
+{
+  // secondary pair cuts of mHFCuts, as for StHFPair
+  return mHFCuts->isGoodSecondaryVertexPair(kp->m(), kp->cosPointingAngle(), kp->decayLength(), kp->dcaDaughters());
 }
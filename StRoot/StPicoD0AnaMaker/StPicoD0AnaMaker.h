@@ -7,6 +7,11 @@
  *
  *  Please write your analysis in the ::Make() function.
  *
+ *  Without StPicoDstMaker (picoDstMaker = NULL) only the StPicoD0Event 
+ *  files are read. They have to be written with 
+ *  StPicoD0EventMaker::setStoreDaughters(true), the kaons and pions
+ *  are then taken from StPicoD0Event::daughter(...)
+ *
  *  Authors:  Xin Dong        (xdong@lbl.gov)
  *            Michael Lomnitz (mrlomnitz@lbl.gov)
  *            Mustafa Mustafa (mmustafa@lbl.gov)
@@ -25,6 +30,7 @@ class StPicoD0Event;
 class StKaonPion;
 class StPicoDstMaker;
 class StHFCuts;
+class StHFDaughter;
 
 
 class StPicoD0AnaMaker : public StMaker
@@ -47,6 +53,8 @@ class StPicoD0AnaMaker : public StMaker
     void readNextEvent();
 
     bool isGoodPair(StKaonPion const*) const;
+    bool isGoodReplayPair(StKaonPion const*, StHFDaughter const* kaon, StHFDaughter const* pion) const;
+    bool isGoodPairCuts(StKaonPion const*) const;
 
     StPicoDstMaker* mPicoDstMaker;
     StPicoD0Event* mPicoD0Event;
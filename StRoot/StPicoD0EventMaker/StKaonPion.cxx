@@ -10,12 +10,15 @@
 #include "phys_constants.h"
 #include "SystemOfUnits.h"
 #include "StPicoDstMaker/StPicoTrack.h"
+#include "StPicoHFMaker/StHFTrackCache.h"
+#include "StPicoHFMaker/StHFTrackTable.h"
+#include "StPicoHFMaker/StHFPairKernel.h"
 
 ClassImp(StKaonPion)
 
 
 StKaonPion::StKaonPion(): mLorentzVector(),
-   mPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+   mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
    mKaonDca(std::numeric_limits<float>::quiet_NaN()), mPionDca(std::numeric_limits<float>::quiet_NaN()),
    mKaonIdx(std::numeric_limits<unsigned short>::quiet_NaN()), mPionIdx(std::numeric_limits<unsigned short>::quiet_NaN()),
    mDcaDaughters(std::numeric_limits<float>::quiet_NaN()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN())
@@ -24,17 +27,23 @@ StKaonPion::StKaonPion(): mLorentzVector(),
 }
 //------------------------------------
 StKaonPion::StKaonPion(StKaonPion const * t) : mLorentzVector(t->mLorentzVector),
-   mPointingAngle(t->mPointingAngle), mDecayLength(t->mDecayLength),
+   mCosPointingAngle(t->mCosPointingAngle), mDecayLength(t->mDecayLength),
    mKaonDca(t->mKaonDca), mPionDca(t->mPionDca),
    mKaonIdx(t->mKaonIdx), mPionIdx(t->mPionIdx),
    mDcaDaughters(t->mDcaDaughters), mCosThetaStar(t->mCosThetaStar)
 {
 }
 //------------------------------------
+float StKaonPion::pointingAngle() const
+{
+   // pointing angle from the stored cos, prefer cosPointingAngle() for cuts
+   return std::acos(mCosPointingAngle);
+}
+//------------------------------------
 StKaonPion::StKaonPion(StPicoTrack const * const kaon, StPicoTrack const * const pion,
                        unsigned short const kIdx, unsigned short const pIdx,
                        StThreeVectorF const & vtx, float const bField) : mLorentzVector(),
-   mPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+   mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
    mKaonDca(std::numeric_limits<float>::quiet_NaN()), mPionDca(std::numeric_limits<float>::quiet_NaN()),
    mKaonIdx(kIdx), mPionIdx(pIdx),
    mDcaDaughters(std::numeric_limits<float>::quiet_NaN()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN())
@@ -46,25 +55,90 @@ StKaonPion::StKaonPion(StPicoTrack const * const kaon, StPicoTrack const * const
       return;
    }
 
+   StHFCachedTrack const k(kaon, kIdx, vtx, bField);
+   StHFCachedTrack const p(pion, pIdx, vtx, bField);
+
+   createPair(k, p, vtx, bField);
+}
+//------------------------------------
+StKaonPion::StKaonPion(StHFCachedTrack const & kaon, StHFCachedTrack const & pion,
+                       StThreeVectorF const & vtx, float const bField) : mLorentzVector(),
+   mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+   mKaonDca(std::numeric_limits<float>::quiet_NaN()), mPionDca(std::numeric_limits<float>::quiet_NaN()),
+   mKaonIdx(kaon.idx()), mPionIdx(pion.idx()),
+   mDcaDaughters(std::numeric_limits<float>::quiet_NaN()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN())
+{
+   if (kaon.id() == pion.id())
+   {
+      mKaonIdx = std::numeric_limits<unsigned short>::quiet_NaN();
+      mPionIdx = std::numeric_limits<unsigned short>::quiet_NaN();
+      return;
+   }
+
+   createPair(kaon, pion, vtx, bField);
+}
+//------------------------------------
+StKaonPion::StKaonPion(StHFTrackTable const & table, unsigned int const kRow, unsigned int const pRow,
+                       bool const singlePrecision) : mLorentzVector(),
+   mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+   mKaonDca(std::numeric_limits<float>::quiet_NaN()), mPionDca(std::numeric_limits<float>::quiet_NaN()),
+   mKaonIdx(table.idx()[kRow]), mPionIdx(table.idx()[pRow]),
+   mDcaDaughters(std::numeric_limits<float>::quiet_NaN()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN())
+{
+   if (table.id()[kRow] == table.id()[pRow])
+   {
+      mKaonIdx = std::numeric_limits<unsigned short>::quiet_NaN();
+      mPionIdx = std::numeric_limits<unsigned short>::quiet_NaN();
+      return;
+   }
+
+   // straight lines approximation, vertex relative to primary vertex
+   StHFPairKinematics kin;
+   if (singlePrecision) StHFPairKernel::straightLinePairSingle(table, kRow, pRow, kin);
+   else StHFPairKernel::straightLinePair(table, kRow, pRow, kin);
+
+   mDcaDaughters = kin.dcaDaughters;
+
+   // calculate Lorentz vector of kaon-pion pair
+   StThreeVectorF const kMomAtDca(kin.p1Mom[0], kin.p1Mom[1], kin.p1Mom[2]);
+   StThreeVectorF const pMomAtDca(kin.p2Mom[0], kin.p2Mom[1], kin.p2Mom[2]);
+
+   StLorentzVectorF const kFourMom(kMomAtDca, kMomAtDca.massHypothesis(M_KAON_PLUS));
+   StLorentzVectorF const pFourMom(pMomAtDca, pMomAtDca.massHypothesis(M_PION_PLUS));
+
+   mLorentzVector = kFourMom + pFourMom;
+
+   // calculate cosThetaStar
+   StLorentzVectorF const kpFourMomReverse(-mLorentzVector.px(), -mLorentzVector.py(), -mLorentzVector.pz(), mLorentzVector.e());
+   StLorentzVectorF const kFourMomStar = kFourMom.boost(kpFourMomReverse);
+   mCosThetaStar = std::cos(kFourMomStar.vect().angle(mLorentzVector.vect()));
+
+   // calculate cos of pointing angle and decay length
+   StThreeVectorF const vtxToV0(kin.v0[0], kin.v0[1], kin.v0[2]);
+   mCosPointingAngle = StHFPairKernel::cosAngle(vtxToV0.x(), vtxToV0.y(), vtxToV0.z(),
+                                                mLorentzVector.px(), mLorentzVector.py(), mLorentzVector.pz());
+   mDecayLength = vtxToV0.mag();
+
+   // DCA of tracks to primary vertex
+   mKaonDca = table.dca()[kRow];
+   mPionDca = table.dca()[pRow];
+}
+//------------------------------------
+void StKaonPion::createPair(StHFCachedTrack const & kaon, StHFCachedTrack const & pion,
+                            StThreeVectorF const & vtx, float const bField)
+{
    /// prefixes code:
    ///   k means kaon
    ///   p means pion
    ///   kp means kaon-pion pair
 
-
-   // to be used for testing with preview II pico production
-   StPhysicalHelixD kHelix = kaon->dcaGeometry().helix();
-   StPhysicalHelixD pHelix = pion->dcaGeometry().helix();
-
-   // move origins of helices to the primary vertex origin
-   kHelix.moveOrigin(kHelix.pathLength(vtx));
-   pHelix.moveOrigin(pHelix.pathLength(vtx));
+   // helices of cached tracks have their origins already moved to the primary vertex
+   StPhysicalHelixD const & kHelix = kaon.helix();
+   StPhysicalHelixD const & pHelix = pion.helix();
 
    // use straight lines approximation to get point of DCA of kaon-pion pair
-   StThreeVectorF const kMom = kHelix.momentum(bField * kilogauss);
-   StThreeVectorF const pMom = pHelix.momentum(bField * kilogauss);
-   StPhysicalHelixD const kStraightLine(kMom, kHelix.origin(), 0, kaon->charge());
-   StPhysicalHelixD const pStraightLine(pMom, pHelix.origin(), 0, pion->charge());
+   StPhysicalHelixD const kStraightLine(kaon.momentum(), kHelix.origin(), 0, kaon.charge());
+   StPhysicalHelixD const pStraightLine(pion.momentum(), pHelix.origin(), 0, pion.charge());
 
    pair<double, double> const ss = kStraightLine.pathLengths(pStraightLine);
    StThreeVectorF const kAtDcaToPion = kStraightLine.at(ss.first);
@@ -87,13 +161,14 @@ StKaonPion::StKaonPion(StPicoTrack const * const kaon, StPicoTrack const * const
    StLorentzVectorF const kFourMomStar = kFourMom.boost(kpFourMomReverse);
    mCosThetaStar = std::cos(kFourMomStar.vect().angle(mLorentzVector.vect()));
 
-   // calculate pointing angle and decay length
+   // calculate cos of pointing angle and decay length
    StThreeVectorF const vtxToV0 = (kAtDcaToPion + pAtDcaToKaon) * 0.5 - vtx;
-   mPointingAngle = vtxToV0.angle(mLorentzVector.vect());
+   mCosPointingAngle = StHFPairKernel::cosAngle(vtxToV0.x(), vtxToV0.y(), vtxToV0.z(),
+                                                mLorentzVector.px(), mLorentzVector.py(), mLorentzVector.pz());
    mDecayLength = vtxToV0.mag();
 
-   // calculate DCA of tracks to primary vertex
-   mKaonDca = (kHelix.origin() - vtx).mag();
-   mPionDca = (pHelix.origin() - vtx).mag();
+   // DCA of tracks to primary vertex
+   mKaonDca = kaon.dca();
+   mPionDca = pion.dca();
 }
 #endif // __ROOT__
@@ -6,6 +6,14 @@
  *  A specialized pair class for calculating K-π pair 
  *  lorentz vector and topological decay parameters 
  *  and storing them.
+ *  Can also be created from entries of the event-wise 
+ *  track cache (StPicoHFMaker/StHFTrackCache) or from
+ *  rows of the structure-of-arrays track table 
+ *  (StPicoHFMaker/StHFTrackTable), in double precision
+ *  or float only (singlePrecision, see StHFPairKernel).
+ *  The cos of the pointing angle is stored, pointingAngle()
+ *  returns its acos. Version 1 stored the angle, it is converted
+ *  when reading (read rule in StPicoD0EventMakerLinkDef.h).
  *
  *  Authors:  Xin Dong        (xdong@lbl.gov)
  *            Michael Lomnitz (mrlomnitz@lbl.gov)
@@ -21,6 +29,8 @@
 
 class StPicoTrack;
 class StPicoEvent;
+class StHFCachedTrack;
+class StHFTrackTable;
 
 class StKaonPion : public TObject
 {
@@ -29,6 +39,9 @@ class StKaonPion : public TObject
   StKaonPion(StKaonPion const *);
   StKaonPion(StPicoTrack const * kaon, StPicoTrack const * pion,unsigned short kIdx,unsigned short pIdx,
              StThreeVectorF const & vtx, float bField);
+  StKaonPion(StHFCachedTrack const & kaon, StHFCachedTrack const & pion,
+             StThreeVectorF const & vtx, float bField);
+  StKaonPion(StHFTrackTable const & table, unsigned int kRow, unsigned int pRow, bool singlePrecision = false);
   ~StKaonPion() {}// please keep this non-virtual and NEVER inherit from this class 
 
   StLorentzVectorF const & lorentzVector() const;
@@ -36,6 +49,7 @@ class StKaonPion : public TObject
   float pt()   const;
   float eta()  const;
   float phi()  const;
+  float cosPointingAngle() const;
   float pointingAngle() const;
   float decayLength() const;
   float kaonDca() const;
@@ -49,9 +63,13 @@ class StKaonPion : public TObject
   // disable copy constructor and assignment operator by making them private (once C++11 is available in STAR you can use delete specifier instead)
   StKaonPion(StKaonPion const &);
   StKaonPion& operator=(StKaonPion const &);
+
+  void createPair(StHFCachedTrack const & kaon, StHFCachedTrack const & pion,
+                  StThreeVectorF const & vtx, float bField);
+
   StLorentzVectorF mLorentzVector; // this owns four float only
 
-  float mPointingAngle;
+  float mCosPointingAngle; // cos of pointing angle, until version 1 mPointingAngle
   float mDecayLength;
   float mKaonDca;
   float mPionDca;
@@ -62,14 +80,14 @@ class StKaonPion : public TObject
   float mDcaDaughters;
   float mCosThetaStar; 
 
-  ClassDef(StKaonPion,1)
+  ClassDef(StKaonPion,2)
 };
 inline StLorentzVectorF const & StKaonPion::lorentzVector() const { return mLorentzVector;}
 inline float StKaonPion::m()    const { return mLorentzVector.m();}
 inline float StKaonPion::pt()   const { return mLorentzVector.perp();}
 inline float StKaonPion::eta()  const { return mLorentzVector.pseudoRapidity();}
 inline float StKaonPion::phi()  const { return mLorentzVector.phi();}
-inline float StKaonPion::pointingAngle() const { return mPointingAngle;}
+inline float StKaonPion::cosPointingAngle() const { return mCosPointingAngle;}
 inline float StKaonPion::decayLength() const { return mDecayLength;}
 inline float StKaonPion::kaonDca() const { return mKaonDca;}
 inline float StKaonPion::pionDca() const { return mPionDca;}
@@ -3,16 +3,21 @@
 
 #include "StPicoD0Event.h"
 #include "StKaonPion.h"
+#include "StPicoHFMaker/StHFDaughter.h"
 
 ClassImp(StPicoD0Event)
 
 TClonesArray *StPicoD0Event::fgKaonPionArray = 0;
+TClonesArray *StPicoD0Event::fgDaughterArray = 0;
 
 //-----------------------------------------------------------------------
-StPicoD0Event::StPicoD0Event() : mRunId(-1), mEventId(-1), mNKaonPion(0), mNKaons(0), mNPions(0), mKaonPionArray(NULL)
+StPicoD0Event::StPicoD0Event() : mRunId(-1), mEventId(-1), mNKaonPion(0), mNKaons(0), mNPions(0), mNDaughters(0), mKaonPionArray(NULL),
+   mDaughterArray(NULL), mNKaonPionMax(0)
 {
    if (!fgKaonPionArray) fgKaonPionArray = new TClonesArray("StKaonPion");
    mKaonPionArray = fgKaonPionArray;
+   if (!fgDaughterArray) fgDaughterArray = new TClonesArray("StHFDaughter");
+   mDaughterArray = fgDaughterArray;
 }
 
 //-----------------------------------------------------------------------
@@ -26,12 +31,18 @@ void StPicoD0Event::addPicoEvent(StPicoEvent const & picoEvent)
 //-----------------------------------------------------------------------
 void StPicoD0Event::clear(char const *option)
 {
+   // keep enough space for the largest event seen so far
+   if (mNKaonPion > mNKaonPionMax) mNKaonPionMax = mNKaonPion;
+
    mKaonPionArray->Clear(option);
+   if (mKaonPionArray->GetSize() < mNKaonPionMax) mKaonPionArray->Expand(mNKaonPionMax);
+   mDaughterArray->Clear(option);
    mRunId = -1;
    mEventId = -1;
    mNKaonPion = 0;
    mNKaons = 0;
    mNPions = 0;
+   mNDaughters = 0;
 }
 //---------------------------------------------------------------------
 void StPicoD0Event::addKaonPion(StKaonPion const* t)
@@ -39,3 +50,28 @@ void StPicoD0Event::addKaonPion(StKaonPion const* t)
    TClonesArray &kaonPionArray = *mKaonPionArray;
    new(kaonPionArray[mNKaonPion++]) StKaonPion(t);
 }
+//---------------------------------------------------------------------
+StKaonPion* StPicoD0Event::emplaceKaonPion(StHFTrackTable const & table, unsigned int const kRow, unsigned int const pRow,
+                                           bool const singlePrecision)
+{
+   TClonesArray &kaonPionArray = *mKaonPionArray;
+   return new(kaonPionArray[mNKaonPion++]) StKaonPion(table, kRow, pRow, singlePrecision);
+}
+//---------------------------------------------------------------------
+void StPicoD0Event::compactKaonPions()
+{
+   // remove slots behind the last stored pair, left by rollbackKaonPion()
+   for (int idx = mKaonPionArray->GetEntriesFast() - 1; idx >= mNKaonPion; --idx)
+      mKaonPionArray->RemoveAt(idx);
+}
+//---------------------------------------------------------------------
+void StPicoD0Event::addDaughter(StPicoTrack const & trk, unsigned short const idx, float const tofBeta)
+{
+   TClonesArray &daughterArray = *mDaughterArray;
+   new(daughterArray[mNDaughters++]) StHFDaughter(trk, idx, tofBeta);
+}
+//---------------------------------------------------------------------
+StHFDaughter const* StPicoD0Event::daughter(unsigned short const idx) const
+{
+   return StHFDaughter::find(mDaughterArray, mNDaughters, idx);
+}
@@ -5,6 +5,19 @@
  *  A specialized class for storing eventwise D0
  *  candidates. 
  *
+ *  emplaceKaonPion(table, kRow, pRow, singlePrecision) constructs the pair 
+ *  directly in the array, without a temporary copy (see StHFPairKernel for
+ *  the precision). If the pair does not pass the cuts, rollbackKaonPion() 
+ *  frees the slot again, it is reused by the next pair. compactKaonPions()
+ *  removes such slots from the array, it has to be called before the event
+ *  is written. The largest number of pairs in previous events is used as 
+ *  capacity hint of the array.
+ *
+ *  Optionally compact copies of the kaons and pions of the pairs
+ *  (StHFDaughter) are stored via addDaughter(...), in increasing order
+ *  of their StPicoDst index. daughter(idx) returns the one with the 
+ *  StPicoDst index idx, so that pairs can be analysed without picoDst.
+ *
  *  Authors:  Xin Dong        (xdong@lbl.gov)
  *            Michael Lomnitz (mrlomnitz@lbl.gov)
  *            Mustafa Mustafa (mmustafa@lbl.gov)
@@ -14,6 +27,9 @@
  */
 
 class StPicoEvent;
+class StPicoTrack;
+class StHFTrackTable;
+class StHFDaughter;
 
 #include "TObject.h"
 #include "TClonesArray.h"
@@ -28,6 +44,10 @@ public:
    void    clear(char const *option = "");
    void    addPicoEvent(StPicoEvent const & picoEvent);
    void    addKaonPion(StKaonPion const*);
+   StKaonPion* emplaceKaonPion(StHFTrackTable const & table, unsigned int kRow, unsigned int pRow, bool singlePrecision = false);
+   void    rollbackKaonPion();
+   void    compactKaonPions();
+   void    addDaughter(StPicoTrack const & trk, unsigned short idx, float tofBeta);
    void    nKaons(int);
    void    nPions(int);
 
@@ -37,6 +57,9 @@ public:
    int     nKaonPion()  const;
    int     nKaons() const;
    int     nPions() const;
+   TClonesArray const * daughterArray() const;
+   int     nDaughters() const;
+   StHFDaughter const * daughter(unsigned short idx) const;
 
 private:
    // some variables below are kept in ROOT types to match the same ones in StPicoEvent
@@ -45,13 +68,18 @@ private:
    int   mNKaonPion;       // number of stored pairs
    int   mNKaons;
    int   mNPions;
+   int   mNDaughters;      // number of stored daughters
 
    TClonesArray*        mKaonPionArray;
    static TClonesArray* fgKaonPionArray;
+   TClonesArray*        mDaughterArray;
+   static TClonesArray* fgDaughterArray;
+   int   mNKaonPionMax;    //! largest number of stored pairs in an event
 
-   ClassDef(StPicoD0Event, 1)
+   ClassDef(StPicoD0Event, 2)
 };
 
+inline void StPicoD0Event::rollbackKaonPion() { --mNKaonPion; }
 inline void StPicoD0Event::nKaons(int n) { mNKaons = n; }
 inline void StPicoD0Event::nPions(int n) { mNPions = n; }
 
@@ -59,6 +87,8 @@ inline TClonesArray const * StPicoD0Event::kaonPionArray()   const { return mKao
 inline int   StPicoD0Event::nKaonPion()  const { return mNKaonPion;}
 inline int   StPicoD0Event::nKaons()  const { return mNKaons;}
 inline int   StPicoD0Event::nPions()  const { return mNPions;}
+inline TClonesArray const * StPicoD0Event::daughterArray()   const { return mDaughterArray;}
+inline int   StPicoD0Event::nDaughters()  const { return mNDaughters;}
 inline Int_t StPicoD0Event::runId()   const { return mRunId; }
 inline Int_t StPicoD0Event::eventId() const { return mEventId; }
 #endif
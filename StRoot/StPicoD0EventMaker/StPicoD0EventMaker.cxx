@@ -1,11 +1,17 @@
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <iterator>
 
 #include "TTree.h"
+#include "TH1D.h"
 #include "TFile.h"
 #include "TString.h"
+#include "TThread.h"
+#include "TClonesArray.h"
 #include "StThreeVectorF.hh"
 #include "StLorentzVectorF.hh"
+#include "phys_constants.h"
 #include "../StPicoDstMaker/StPicoDst.h"
 #include "../StPicoDstMaker/StPicoDstMaker.h"
 #include "../StPicoDstMaker/StPicoEvent.h"
@@ -15,16 +21,103 @@
 #include "StPicoD0EventMaker.h"
 #include "StPicoD0Hists.h"
 #include "StCuts.h"
+#include "StPicoHFMaker/StHFTrackCache.h"
+#include "StPicoHFMaker/StHFTrackTable.h"
+#include "StPicoHFMaker/StHFPairKernel.h"
+#include "StPicoHFMaker/StHFMassWindowFilter.h"
+#include "StPicoHFMaker/StHFDirectionGrid.h"
+#include "StPicoHFMaker/StHFWorkQueue.h"
+#include "StPicoHFMaker/StHFEventArena.h"
+#include "StPicoHFMaker/StHFStageProfiler.h"
 
 ClassImp(StPicoD0EventMaker)
 
+// absolute margin (cm) on the dcaDaughters cut for the single precision batch kernel,
+// pairs beyond it are rejected before StKaonPion is built. Larger than the deviations
+// of a few 1e-3 cm of the batch kernel (see StHFPairKernel), check via setVerifyBatchPreCut
+static float const batchDcaDaughtersMargin = 1.e-2;
+
+// stages and counters of setProfiling(true), registered in this order
+namespace
+{
+   enum eStage {kStageOutside, kStageTrackSelection, kStagePairBuilding, kStageHistogramFilling, kStageStoreDaughters, kStageTreeFill, kStageMax};
+   enum eCounter {kCountEvents, kCountGoodEvents, kCountTracks, kCountKaons, kCountPions, kCountPairsTried, kCountPairs, kCountBytesWritten, kCountMax};
+
+   char const* const stageNames[kStageMax] = {"outside", "trackSelection", "pairBuilding", "histogramFilling", "storeDaughters", "treeFill"};
+   char const* const counterNames[kCountMax] = {"events", "goodEvents", "tracks", "kaons", "pions", "pairsTried", "pairs", "bytesWritten"};
+}
+
+//-----------------------------------------------------------------------------
+// Kπ pairs passing the cuts, found by one thread, and the work space of the thread.
+// With several threads the StKaonPion are built once in pairs by the thread and copied 
+// into the event, with one thread they are built directly in the event and pairs is unused.
+class StD0PairBuffer
+{
+  public:
+   StD0PairBuffer() : pairs("StKaonPion"), nMassMissed(0), nGridMissed(0), nBatchMissed(0), nPairsTried(0) {}
+
+   void clear()
+   {
+      pairKaon.clear();
+      pairs.Clear("C");
+      nMassMissed = 0;
+      nGridMissed = 0;
+      nBatchMissed = 0;
+      nPairsTried = 0;
+   }
+
+   std::vector<unsigned short> pairKaon; // position in mIdxPicoKaons, increasing
+   TClonesArray pairs; // StKaonPion of pairKaon, entries beyond pairKaon.size() are rejected pairs
+
+   unsigned int nMassMissed; // pairs lost by mass window pre-filter, verify mode only
+   unsigned int nGridMissed; // pairs lost by direction grid, verify mode only
+   unsigned int nBatchMissed; // pairs lost by batch dcaDaughters pre-cut, verify mode only
+   unsigned int nPairsTried; // pairs passed to the batch kernel, after pre-filters
+
+   std::vector<unsigned short> pionPositions;
+   std::vector<unsigned short> gridPositions;
+   std::vector<unsigned short> intersection;
+   std::vector<int> pionRows;
+   StHFPairBatch batch;
+};
+
+//-----------------------------------------------------------------------------
+// Threads building Kπ pairs, buffer 0 is used by the thread calling Make()
+class StD0PairThreads
+{
+  public:
+   StD0PairThreads(unsigned int n) : buffers(n) {}
+   ~StD0PairThreads()
+   {
+      for (unsigned int i = 0; i < buffers.size(); ++i) delete buffers[i];
+   }
+
+   StHFThreadPool pool;
+   StHFWorkQueue tasks; // buffers to be filled, NULL stops a thread
+   StHFWorkQueue done;  // filled buffers
+   StHFWorkCounter kaons;
+   std::vector<StD0PairBuffer*> buffers;
+};
+
 //-----------------------------------------------------------------------------
 StPicoD0EventMaker::StPicoD0EventMaker(char const* makerName, StPicoDstMaker* picoMaker, char const* fileBaseName)
-   : StMaker(makerName), mPicoDstMaker(picoMaker), mPicoEvent(NULL), mPicoD0Hists(NULL)
+   : StMaker(makerName), mPicoDstMaker(picoMaker), mPicoEvent(NULL), mPicoD0Hists(NULL), mTrackCache(NULL), mTrackTable(NULL), mMassFilter(NULL),
+     mMassFilterMode(StHFMassWindowFilter::kNoMassFilter), mGrid(NULL), mDirectionGridMode(StHFDirectionGrid::kNoGrid),
+     mKinematicsPrecision(StHFPairKernel::kDoublePrecision), mVerifyBatchPreCut(false),
+     mNThreads(0), mThreads(NULL), mStoreDaughters(false), mEventArena(NULL), mProfiling(false), mProfiler(NULL), 
+     mFileBaseName(fileBaseName)
 {
    mPicoD0Event = new StPicoD0Event();
+   mTrackCache = new StHFTrackCache();
+   mTrackTable = new StHFTrackTable();
+   mMassFilter = new StHFMassWindowFilter();
+   mGrid = new StHFDirectionGrid();
+   mEventArena = new StHFEventArena();
+
+   mProfiler = new StHFStageProfiler();
+   for (int i = 0; i < kStageMax; ++i) mProfiler->addStage(stageNames[i]);
+   for (int i = 0; i < kCountMax; ++i) mProfiler->addCounter(counterNames[i]);
 
-   TString baseName(fileBaseName);
    mOutputFile = new TFile(Form("%s.picoD0.root",fileBaseName), "RECREATE");
    mOutputFile->SetCompressionLevel(1);
    int BufSize = (int)pow(2., 16.);
@@ -41,24 +134,109 @@ StPicoD0EventMaker::~StPicoD0EventMaker()
 {
    /* mTree is owned by mOutputFile directory, it will be destructed once
     * the file is closed in ::Finish() */
+   stopThreads();
    delete mPicoD0Hists;
+   delete mTrackCache;
+   delete mTrackTable;
+   delete mMassFilter;
+   delete mGrid;
+   delete mEventArena;
+   delete mProfiler;
 }
 
 //-----------------------------------------------------------------------------
 Int_t StPicoD0EventMaker::Init()
 {
+   startThreads();
+
+   mProfiler->setEnabled(mProfiling);
+   mProfiler->start(kStageOutside);
+
    return kStOK;
 }
 
+//-----------------------------------------------------------------------------
+void StPicoD0EventMaker::startThreads()
+{
+   unsigned int const nBuffers = mNThreads > 1 ? mNThreads : 1;
+
+   // threads create StKaonPion : switch ROOT to thread-safe mode
+   if (nBuffers > 1) TThread::Initialize();
+
+   mThreads = new StD0PairThreads(nBuffers);
+   for (unsigned int i = 0; i < nBuffers; ++i) mThreads->buffers[i] = new StD0PairBuffer();
+
+   // the thread calling Make() uses buffer 0 itself
+   std::vector<void*> args(nBuffers - 1, this);
+   if (mThreads->pool.start(&StPicoD0EventMaker::runPairThread, args) != args.size())
+   {
+      LOG_WARN << " StPicoD0EventMaker - Could not start " << nBuffers - 1 << " threads, Kπ pairs are built by " 
+               << mThreads->pool.size() + 1 << " threads" << endm;
+   }
+}
+
+//-----------------------------------------------------------------------------
+void StPicoD0EventMaker::stopThreads()
+{
+   if (!mThreads) return;
+
+   for (unsigned int i = 0; i < mThreads->pool.size(); ++i) mThreads->tasks.push(NULL);
+   mThreads->pool.join();
+
+   delete mThreads;
+   mThreads = NULL;
+}
+
+//-----------------------------------------------------------------------------
+void* StPicoD0EventMaker::runPairThread(void* maker)
+{
+   StPicoD0EventMaker const* self = static_cast<StPicoD0EventMaker*>(maker);
+
+   while (void* task = self->mThreads->tasks.pop())
+   {
+      StD0PairBuffer* buffer = static_cast<StD0PairBuffer*>(task);
+      self->makeKaonPions(*buffer, NULL);
+      self->mThreads->done.push(buffer);
+   }
+
+   return NULL;
+}
+
 //-----------------------------------------------------------------------------
 Int_t StPicoD0EventMaker::Finish()
 {
+   stopThreads();
+
+   LOG_INFO << " StPicoD0EventMaker - Event arena : high-water mark " << mEventArena->highWaterMark() << " bytes, "
+            << mEventArena->nEventsGrown() << " events with heap allocations" << endm;
+
+   if (mProfiler->isEnabled()) writeProfile();
+
    mOutputFile->cd();
    mOutputFile->Write();
    mOutputFile->Close();
    mPicoD0Hists->closeFile();
    return kStOK;
 }
+
+//-----------------------------------------------------------------------------
+void StPicoD0EventMaker::writeProfile()
+{
+   mOutputFile->cd();
+
+   TH1D* hTime = mProfiler->createTimeHistogram("hProfileTime");
+   TH1D* hCounters = mProfiler->createCounterHistogram("hProfileCounters");
+   hTime->Write();
+   hCounters->Write();
+   delete hTime;
+   delete hCounters;
+
+   TString const fileName = Form("%s.picoD0.profile.json", mFileBaseName.Data());
+   if (!mProfiler->writeJson(fileName.Data(), GetName()))
+      LOG_WARN << " StPicoD0EventMaker - Could not write profile " << fileName << endm;
+   else
+      LOG_INFO << " StPicoD0EventMaker - Profile written to " << fileName << endm;
+}
 //-----------------------------------------------------------------------------
 void StPicoD0EventMaker::Clear(Option_t *opt)
 {
@@ -67,6 +245,19 @@ void StPicoD0EventMaker::Clear(Option_t *opt)
 
 //-----------------------------------------------------------------------------
 Int_t StPicoD0EventMaker::Make()
+{
+   mProfiler->stop(kStageOutside);
+   mProfiler->count(kCountEvents);
+
+   Int_t const iReturn = makeEvent();
+
+   mProfiler->start(kStageOutside);
+
+   return iReturn;
+}
+
+//-----------------------------------------------------------------------------
+Int_t StPicoD0EventMaker::makeEvent()
 {
    if (!mPicoDstMaker)
    {
@@ -86,13 +277,19 @@ Int_t StPicoD0EventMaker::Make()
 
    if (isGoodEvent())
    {
-      UInt_t nTracks = picoDst->numberOfTracks();
+      mProfiler->count(kCountGoodEvents);
+      mProfiler->start(kStageTrackSelection);
 
-      std::vector<unsigned short> idxPicoKaons;
-      std::vector<unsigned short> idxPicoPions;
+      UInt_t nTracks = picoDst->numberOfTracks();
 
       unsigned int nHftTracks = 0;
 
+      float const bField = mPicoEvent->bField();
+      StThreeVectorF const pVtx = mPicoEvent->primaryVertex();
+
+      mTrackCache->reset(nTracks, pVtx, bField);
+      mTrackTable->reset(nTracks, pVtx.x(), pVtx.y(), pVtx.z(), bField);
+
       for (unsigned short iTrack = 0; iTrack < nTracks; ++iTrack)
       {
          StPicoTrack* trk = picoDst->track(iTrack);
@@ -100,57 +297,190 @@ Int_t StPicoD0EventMaker::Make()
          if (!trk || !isGoodTrack(trk)) continue;
          ++nHftTracks;
 
-         if (isPion(trk)) idxPicoPions.push_back(iTrack);
-         if (isKaon(trk)) idxPicoKaons.push_back(iTrack);
+         bool const pion = isPion(trk);
+         bool const kaon = isKaon(trk);
+
+         if (pion) mIdxPicoPions.push_back(iTrack);
+         if (kaon) mIdxPicoKaons.push_back(iTrack);
+
+         // helix setup is done only once per track
+         if (pion || kaon) mTrackCache->add(trk, iTrack)->addToTable(*mTrackTable, 0.);
 
       } // .. end tracks loop
 
-      float const bField = mPicoEvent->bField();
-      StThreeVectorF const pVtx = mPicoEvent->primaryVertex();
+      mPicoD0Event->nKaons(mIdxPicoKaons.size());
+      mPicoD0Event->nPions(mIdxPicoPions.size());
+
+      mProfiler->count(kCountTracks, nTracks);
+      mProfiler->count(kCountKaons, mIdxPicoKaons.size());
+      mProfiler->count(kCountPions, mIdxPicoPions.size());
 
-      mPicoD0Event->nKaons(idxPicoKaons.size());
-      mPicoD0Event->nPions(idxPicoPions.size());
+      mProfiler->stop(kStageTrackSelection);
+      mProfiler->start(kStagePairBuilding);
 
-      for (unsigned short ik = 0; ik < idxPicoKaons.size(); ++ik)
+      // pions which can form a pair in the mass window with a given kaon
+      if (mMassFilterMode != StHFMassWindowFilter::kNoMassFilter) mMassFilter->setup(*mTrackTable, mIdxPicoPions, M_PION_PLUS);
+
+      // pions in directions which can pass the dcaDaughters and decayLength cuts with a given kaon
+      if (mDirectionGridMode != StHFDirectionGrid::kNoGrid) mGrid->setup(*mTrackTable, mIdxPicoPions);
+
+      // make Kπ pairs, kaons are distributed over all threads
+      std::vector<StD0PairBuffer*> const& buffers = mThreads->buffers;
+      unsigned int const nBuffers = mThreads->pool.size() + 1;
+
+      mThreads->kaons.reset(mIdxPicoKaons.size());
+
+      if (nBuffers == 1)
+      {
+         // one thread : pairs are constructed directly in the event, in order of kaons
+         makeKaonPions(*buffers[0], mPicoD0Event);
+      }
+      else
       {
-         StPicoTrack const * kaon = picoDst->track(idxPicoKaons[ik]);
+         for (unsigned int i = 1; i < nBuffers; ++i) mThreads->tasks.push(buffers[i]);
+         makeKaonPions(*buffers[0], NULL);
+         for (unsigned int i = 1; i < nBuffers; ++i) mThreads->done.pop();
 
-         // make Kπ pairs
-         for (unsigned short ip = 0; ip < idxPicoPions.size(); ++ip)
-         {
-            if (idxPicoKaons[ik] == idxPicoPions[ip]) continue;
+         mergeKaonPions();
+      }
 
-            StPicoTrack const * pion = picoDst->track(idxPicoPions[ip]);
+      unsigned int nMassMissed = 0;
+      unsigned int nGridMissed = 0;
+      unsigned int nBatchMissed = 0;
 
-            StKaonPion kaonPion(kaon, pion, idxPicoKaons[ik], idxPicoPions[ip], pVtx, bField);
+      for (unsigned int i = 0; i < nBuffers; ++i)
+      {
+         nMassMissed += buffers[i]->nMassMissed;
+         nGridMissed += buffers[i]->nGridMissed;
+         nBatchMissed += buffers[i]->nBatchMissed;
+         mProfiler->count(kCountPairsTried, buffers[i]->nPairsTried);
+      }
 
+      if (nMassMissed) LOG_ERROR << " StPicoD0EventMaker - mass window pre-filter missed " << nMassMissed << " pairs" << endm;
+      if (nGridMissed) LOG_ERROR << " StPicoD0EventMaker - direction grid missed " << nGridMissed << " pairs" << endm;
+      if (nBatchMissed) LOG_ERROR << " StPicoD0EventMaker - batch dcaDaughters pre-cut missed " << nBatchMissed << " pairs" << endm;
 
-            if (!isGoodPair(kaonPion)) continue;
+      mProfiler->stop(kStagePairBuilding);
+      mProfiler->start(kStageHistogramFilling);
 
-            mPicoD0Event->addKaonPion(&kaonPion);
+      TClonesArray const* aKaonPion = mPicoD0Event->kaonPionArray();
+      for (int i = 0; i < mPicoD0Event->nKaonPion(); ++i)
+      {
+         StKaonPion const* kaonPion = static_cast<StKaonPion const*>(aKaonPion->UncheckedAt(i));
 
-            if(kaon->charge() * pion->charge() <0) // fill histograms for unlike sign pairs only
-            {
-              bool fillMass = isGoodQaPair(&kaonPion,*kaon,*pion);
-              mPicoD0Hists->addKaonPion(&kaonPion,fillMass);
-            }
+         int const kRow = mTrackTable->row(kaonPion->kaonIdx());
+         int const pRow = mTrackTable->row(kaonPion->pionIdx());
 
-         } // .. end make Kπ pairs
-      } // .. end of kaons loop
+         if(mTrackTable->charge()[kRow] * mTrackTable->charge()[pRow] <0) // fill histograms for unlike sign pairs only
+         {
+           bool fillMass = isGoodQaPair(*kaonPion,*picoDst->track(kaonPion->kaonIdx()),*picoDst->track(kaonPion->pionIdx()));
+           mPicoD0Hists->addKaonPion(kaonPion,fillMass);
+         }
+      } // .. end of pairs loop
+
+      mProfiler->count(kCountPairs, mPicoD0Event->nKaonPion());
+      mProfiler->stop(kStageHistogramFilling);
 
+      if (mStoreDaughters)
+      {
+         StHFStageTimer timer(*mProfiler, kStageStoreDaughters);
+         storeDaughters(picoDst);
+      }
+
+      mProfiler->start(kStageHistogramFilling);
       mPicoD0Hists->addEvent(*mPicoEvent,*mPicoD0Event,nHftTracks);
-      idxPicoKaons.clear();
-      idxPicoPions.clear();
+      mProfiler->stop(kStageHistogramFilling);
+
+      mIdxPicoKaons.clear();
+      mIdxPicoPions.clear();
    } //.. end of good event fill
 
    // This should never be inside the good event block
    // because we want to save header information about all events, good or bad
-   mTree->Fill();
+   mProfiler->start(kStageTreeFill);
+   mPicoD0Event->compactKaonPions();
+   Int_t const nBytes = mTree->Fill();
+   if (nBytes > 0) mProfiler->count(kCountBytesWritten, nBytes);
+   mProfiler->stop(kStageTreeFill);
+
    mPicoD0Event->clear("C");
+   mEventArena->reset();
 
    return kStOK;
 }
 
+//-----------------------------------------------------------------------------
+void StPicoD0EventMaker::mergeKaonPions()
+{
+   // copy the pairs of all buffers into the event, in order of kaons, 
+   // independent of the number of threads
+   std::vector<StD0PairBuffer*> const& buffers = mThreads->buffers;
+   unsigned int const nBuffers = mThreads->pool.size() + 1;
+
+   // find pairs of each kaon in the buffers
+   int* kaonBuffer = mEventArena->allocate<int>(mIdxPicoKaons.size(), -1);
+   unsigned int* kaonBegin = mEventArena->allocate<unsigned int>(mIdxPicoKaons.size(), 0);
+   unsigned int* kaonEnd = mEventArena->allocate<unsigned int>(mIdxPicoKaons.size(), 0);
+
+   for (unsigned int i = 0; i < nBuffers; ++i)
+   {
+      StD0PairBuffer const& buffer = *buffers[i];
+      for (unsigned int j = 0; j < buffer.pairKaon.size(); ++j)
+      {
+         unsigned short const ik = buffer.pairKaon[j];
+         if (kaonBuffer[ik] < 0)
+         {
+            kaonBuffer[ik] = i;
+            kaonBegin[ik] = j;
+         }
+         kaonEnd[ik] = j + 1;
+      }
+   }
+
+   for (unsigned short ik = 0; ik < mIdxPicoKaons.size(); ++ik)
+   {
+      if (kaonBuffer[ik] < 0) continue;
+
+      StD0PairBuffer const& buffer = *buffers[kaonBuffer[ik]];
+      for (unsigned int j = kaonBegin[ik]; j < kaonEnd[ik]; ++j)
+         mPicoD0Event->addKaonPion(static_cast<StKaonPion const*>(buffer.pairs.UncheckedAt(j)));
+   }
+}
+
+//-----------------------------------------------------------------------------
+void StPicoD0EventMaker::storeDaughters(StPicoDst const* const picoDst)
+{
+   // kaons and pions of all stored pairs, once per track and sorted by index
+   unsigned short* idxDaughters = mEventArena->allocate<unsigned short>(2 * mPicoD0Event->nKaonPion());
+   unsigned int nDaughters = 0;
+
+   TClonesArray const* aKaonPion = mPicoD0Event->kaonPionArray();
+   for (int i = 0; i < mPicoD0Event->nKaonPion(); ++i)
+   {
+      StKaonPion const* kp = static_cast<StKaonPion const*>(aKaonPion->UncheckedAt(i));
+      idxDaughters[nDaughters++] = kp->kaonIdx();
+      idxDaughters[nDaughters++] = kp->pionIdx();
+   }
+
+   std::sort(idxDaughters, idxDaughters + nDaughters);
+   nDaughters = std::unique(idxDaughters, idxDaughters + nDaughters) - idxDaughters;
+
+   for (unsigned int i = 0; i < nDaughters; ++i)
+   {
+      StPicoTrack const* trk = picoDst->track(idxDaughters[i]);
+
+      float beta = 0.;
+      int const index2tof = trk->bTofPidTraitsIndex();
+      if (index2tof >= 0)
+      {
+         StPicoBTofPidTraits const* tofPid = picoDst->btofPidTraits(index2tof);
+         if (tofPid) beta = tofPid->btofBeta();
+      }
+
+      mPicoD0Event->addDaughter(*trk, idxDaughters[i], beta);
+   }
+}
+
 //-----------------------------------------------------------------------------
 bool StPicoD0EventMaker::isGoodEvent()
 {
@@ -181,7 +511,7 @@ bool StPicoD0EventMaker::isKaon(StPicoTrack const * const trk) const
 bool StPicoD0EventMaker::isGoodPair(StKaonPion const & kp) const
 {
    return kp.m() > cuts::minMass && kp.m() < cuts::maxMass &&
-          std::cos(kp.pointingAngle()) > cuts::cosTheta &&
+          kp.cosPointingAngle() > cuts::cosTheta &&
           kp.decayLength() > cuts::decayLength &&
           kp.dcaDaughters() < cuts::dcaDaughters;
 }
@@ -190,7 +520,97 @@ bool  StPicoD0EventMaker::isGoodQaPair(StKaonPion const& kp, StPicoTrack const&
 {
   return pion.nHitsFit() >= cuts::qaNHitsFit && kaon.nHitsFit() >= cuts::qaNHitsFit &&
          fabs(kaon.nSigmaKaon()) < cuts::qaNSigmaKaon && 
-         cos(kp.pointingAngle()) > cuts::qaCosTheta &&
+         kp.cosPointingAngle() > cuts::qaCosTheta &&
          kp.pionDca() > cuts::qaPDca && kp.kaonDca() > cuts::qaKDca &&
          kp.dcaDaughters() < cuts::qaDcaDaughters;
 }
+//-----------------------------------------------------------------------------
+void StPicoD0EventMaker::makeKaonPions(StD0PairBuffer& buffer, StPicoD0Event* const event) const
+{
+   // build Kπ pairs of the kaons handed out by mThreads->kaons, in event if given, 
+   // otherwise in buffer. Called by several threads at the same time (event is NULL) : 
+   // only buffer is modified
+
+   buffer.clear();
+
+   std::vector<unsigned short>& pionPositions = buffer.pionPositions;
+   std::vector<unsigned short>& gridPositions = buffer.gridPositions;
+   std::vector<int>& pionRows = buffer.pionRows;
+   StHFPairBatch& batch = buffer.batch;
+
+   bool const singlePrecision = (mKinematicsPrecision == StHFPairKernel::kSinglePrecision);
+
+   unsigned int ik;
+   while (mThreads->kaons.next(ik))
+   {
+      int const kRow = mTrackTable->row(mIdxPicoKaons[ik]);
+
+      if (mMassFilterMode != StHFMassWindowFilter::kNoMassFilter)
+      {
+         mMassFilter->partners(*mTrackTable, kRow, M_KAON_PLUS, cuts::minMass, cuts::maxMass, pionPositions);
+
+         if (mMassFilterMode == StHFMassWindowFilter::kMassFilterVerify)
+            buffer.nMassMissed += mMassFilter->verify(*mTrackTable, kRow, M_KAON_PLUS, cuts::minMass, cuts::maxMass, pionPositions);
+      }
+      else
+      {
+         pionPositions.resize(mIdxPicoPions.size());
+         for (unsigned short ip = 0; ip < mIdxPicoPions.size(); ++ip) pionPositions[ip] = ip;
+      }
+
+      if (mDirectionGridMode != StHFDirectionGrid::kNoGrid)
+      {
+         mGrid->partners(*mTrackTable, kRow, cuts::dcaDaughters, cuts::decayLength, gridPositions);
+
+         if (mDirectionGridMode == StHFDirectionGrid::kGridVerify)
+            buffer.nGridMissed += mGrid->verify(*mTrackTable, kRow, cuts::dcaDaughters, cuts::decayLength, gridPositions);
+
+         // output range of set_intersection must not overlap its inputs
+         buffer.intersection.clear();
+         std::set_intersection(pionPositions.begin(), pionPositions.end(), gridPositions.begin(), gridPositions.end(),
+                               std::back_inserter(buffer.intersection));
+         pionPositions.swap(buffer.intersection);
+      }
+
+      pionRows.clear();
+      for (unsigned short iPos = 0; iPos < pionPositions.size(); ++iPos) pionRows.push_back(mTrackTable->row(mIdxPicoPions[pionPositions[iPos]]));
+
+      for (unsigned short iPos = 0; iPos < pionPositions.size(); ++iPos)
+      {
+         unsigned short const ip = pionPositions[iPos];
+
+         // straight line DCA of the next block of pions, vectorized
+         unsigned short const ib = iPos % StHFPairBatch::kMaxSize;
+         if (ib == 0) StHFPairKernel::straightLineBatch(*mTrackTable, kRow, &pionRows[iPos], pionRows.size() - iPos, batch);
+
+         if (mIdxPicoKaons[ik] == mIdxPicoPions[ip]) continue;
+         ++buffer.nPairsTried;
+         if (batch.dcaDaughters[ib] > cuts::dcaDaughters + batchDcaDaughtersMargin)
+         {
+            // verify mode : build the rejected pair in the next free slot of the buffer
+            if (mVerifyBatchPreCut)
+            {
+               StKaonPion const* kaonPion = new(buffer.pairs[buffer.pairKaon.size()]) 
+                  StKaonPion(*mTrackTable, kRow, pionRows[iPos], singlePrecision);
+               if (isGoodPair(*kaonPion)) ++buffer.nBatchMissed;
+            }
+            continue;
+         }
+
+         // pair is constructed in the next free slot, which is reused if it fails the cuts
+         if (event)
+         {
+            StKaonPion const* kaonPion = event->emplaceKaonPion(*mTrackTable, kRow, pionRows[iPos], singlePrecision);
+            if (!isGoodPair(*kaonPion)) event->rollbackKaonPion();
+            continue;
+         }
+
+         StKaonPion const* kaonPion = new(buffer.pairs[buffer.pairKaon.size()]) 
+            StKaonPion(*mTrackTable, kRow, pionRows[iPos], singlePrecision);
+
+         if (!isGoodPair(*kaonPion)) continue;
+
+         buffer.pairKaon.push_back(ik);
+      } // .. end make Kπ pairs
+   } // .. end of kaons loop
+}
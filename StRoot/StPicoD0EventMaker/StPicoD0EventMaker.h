@@ -5,6 +5,26 @@
  *  A Maker that reads StPicoEvents' and creates 
  *  StPicoD0Events and stores them.
  *
+ *  The Kπ pairs of an event can be built by several threads, 
+ *  via setNThreads(...). The kaons are distributed dynamically
+ *  over the threads. The pairs passing the cuts are kept by the 
+ *  threads and copied to the StPicoD0Event in the same order as with 
+ *  one thread, their kinematics are not calculated again. With one
+ *  thread the pairs are constructed directly in the StPicoD0Event.
+ *
+ *  With setStoreDaughters(true) compact copies of the kaons and pions 
+ *  used in the stored pairs (StHFDaughter) are written with the event,
+ *  so that StPicoD0AnaMaker can run without the picoDst.
+ *
+ *  Per-event scratch arrays are taken from an StHFEventArena, 
+ *  in steady state Make() does no heap allocations for them.
+ *
+ *  With setProfiling(true) the time spent in the stages of Make() 
+ *  and counters (tracks, tried and accepted pairs, bytes written) are 
+ *  recorded by an StHFStageProfiler. At Finish() they are written as 
+ *  histograms hProfileTime/hProfileCounters to the picoD0 file and as 
+ *  <fileBaseName>.picoD0.profile.json. Compiled out with -DST_HF_NO_PROFILING.
+ *
  *  Authors:  Xin Dong        (xdong@lbl.gov)
  *            Michael Lomnitz (mrlomnitz@lbl.gov)
  *            Mustafa Mustafa (mmustafa@lbl.gov)
@@ -13,6 +33,8 @@
  * **************************************************
  */
 
+#include <vector>
+
 #include "StMaker.h"
 
 class TTree;
@@ -20,9 +42,18 @@ class TFile;
 class StPicoDstMaker;
 class StPicoEvent;
 class StPicoTrack;
+class StPicoDst;
 class StPicoD0Event;
 class StKaonPion;
 class StPicoD0Hists;
+class StHFTrackCache;
+class StHFTrackTable;
+class StHFMassWindowFilter;
+class StHFDirectionGrid;
+class StD0PairBuffer;
+class StD0PairThreads;
+class StHFEventArena;
+class StHFStageProfiler;
 
 class StPicoD0EventMaker : public StMaker 
 {
@@ -34,14 +65,38 @@ class StPicoD0EventMaker : public StMaker
     virtual Int_t Make();
     virtual void  Clear(Option_t *opt="");
     virtual Int_t Finish();
+
+    // use enum of StHFMassWindowFilter::eMassFilterMode
+    void  setMassFilterMode(unsigned int mode);
+    // use enum of StHFDirectionGrid::eGridMode
+    void  setDirectionGridMode(unsigned int mode);
+    // use enum of StHFPairKernel::ePrecision for the Kπ kinematics
+    void  setKinematicsPrecision(unsigned int precision);
+    // check every pair rejected by the batch dcaDaughters pre-cut with StKaonPion,
+    // pairs which would pass the cuts are reported (has to be 0)
+    void  setVerifyBatchPreCut(bool b);
+    // number of threads to build Kπ pairs, 0/1 : no extra threads
+    void  setNThreads(unsigned int n);
+    // store kaons and pions of the pairs in the StPicoD0Event
+    void  setStoreDaughters(bool b);
+    // per-stage timers and counters, written at Finish()
+    void  setProfiling(bool b);
     
   private:
+    Int_t makeEvent();
     bool  isGoodEvent();
     bool  isGoodTrack(StPicoTrack const*) const;
     bool  isPion(StPicoTrack const*) const;
     bool  isKaon(StPicoTrack const*) const;
     bool  isGoodPair(StKaonPion const &) const;
     bool  isGoodQaPair(StKaonPion const&, StPicoTrack const&,StPicoTrack const&);
+    void  makeKaonPions(StD0PairBuffer&, StPicoD0Event*) const;
+    void  mergeKaonPions();
+    void  storeDaughters(StPicoDst const*);
+    void  writeProfile();
+    void  startThreads();
+    void  stopThreads();
+    static void* runPairThread(void* maker);
 
     StPicoDstMaker* mPicoDstMaker;
     StPicoEvent*    mPicoEvent;
@@ -50,8 +105,34 @@ class StPicoD0EventMaker : public StMaker
     TFile* mOutputFile;
     TTree* mTree;
     StPicoD0Event* mPicoD0Event;
+    StHFTrackCache* mTrackCache; // helices of kaons and pions moved to the primary vertex, per event
+    StHFTrackTable* mTrackTable; // same kaons and pions as structure-of-arrays table
+    StHFMassWindowFilter* mMassFilter; // pions within mass reach of a kaon
+    unsigned int mMassFilterMode;
+    StHFDirectionGrid* mGrid; // pions in directions which can pass dcaDaughters and decayLength cuts with a kaon
+    unsigned int mDirectionGridMode;
+    unsigned int mKinematicsPrecision; // double or float only Kπ kinematics
+    bool mVerifyBatchPreCut; // verify pairs rejected by the batch dcaDaughters pre-cut
+    unsigned int mNThreads;
+    StD0PairThreads* mThreads; // threads and per-thread pair buffers
+    bool mStoreDaughters;
+    StHFEventArena* mEventArena; // per-event scratch arrays, reset at the end of Make()
+    bool mProfiling;
+    StHFStageProfiler* mProfiler; // timers and counters of the stages of Make()
+    TString mFileBaseName;
+
+    std::vector<unsigned short> mIdxPicoKaons;
+    std::vector<unsigned short> mIdxPicoPions;
 
     ClassDef(StPicoD0EventMaker, 1)
 };
 
+inline void StPicoD0EventMaker::setMassFilterMode(unsigned int mode) { mMassFilterMode = mode; }
+inline void StPicoD0EventMaker::setDirectionGridMode(unsigned int mode) { mDirectionGridMode = mode; }
+inline void StPicoD0EventMaker::setKinematicsPrecision(unsigned int precision) { mKinematicsPrecision = precision; }
+inline void StPicoD0EventMaker::setVerifyBatchPreCut(bool b) { mVerifyBatchPreCut = b; }
+inline void StPicoD0EventMaker::setNThreads(unsigned int n) { mNThreads = n; }
+inline void StPicoD0EventMaker::setStoreDaughters(bool b) { mStoreDaughters = b; }
+inline void StPicoD0EventMaker::setProfiling(bool b) { mProfiling = b; }
+
 #endif
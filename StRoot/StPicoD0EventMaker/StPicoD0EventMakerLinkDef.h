@@ -0,0 +1,10 @@
+// -- schema evolution of the stored candidates of StPicoD0EventMaker,
+//    all other classes of the package are added from their ClassDef
+#ifdef __CINT__
+
+#pragma link C++ class StKaonPion+;
+
+// -- version 1 stored the pointing angle, version 2 stores its cos
+#pragma read sourceClass="StKaonPion" targetClass="StKaonPion" version="[1]" source="float mPointingAngle" target="mCosPointingAngle" include="cmath" code="{ mCosPointingAngle = std::cos(onfile.mPointingAngle); }"
+
+#endif
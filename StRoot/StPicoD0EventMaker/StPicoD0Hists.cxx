@@ -61,7 +61,7 @@ void StPicoD0Hists::addKaonPion(StKaonPion const* const kp, bool const fillMass)
 {
   mh2KaonDcaVsPt->Fill(kp->pt(),kp->kaonDca());
   mh2PionDcaVsPt->Fill(kp->pt(),kp->pionDca());
-  mh2CosThetaVsPt->Fill(kp->pt(),cos(kp->pointingAngle()));
+  mh2CosThetaVsPt->Fill(kp->pt(),kp->cosPointingAngle());
   mh2DcaDaughtersVsPt->Fill(kp->pt(),kp->dcaDaughters());
   if(fillMass) mh2InvariantMassVsPt->Fill(kp->pt(),kp->m());
 }
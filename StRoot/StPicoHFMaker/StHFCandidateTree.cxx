@@ -0,0 +1,235 @@
+#include <string>
+#include <cmath>
+
+#include "TTree.h"
+#include "TClonesArray.h"
+
+#include "StHFCandidateTree.h"
+#include "StPicoHFEvent.h"
+#include "StHFPair.h"
+
+namespace {
+  char const * const aVertexTypeNames[StHFCandidateTree::kVertexTypeMax] = {"secondary", "tertiary"};
+  char const * const aCountNames[StHFCandidateTree::kVertexTypeMax]      = {"nHFSecondaryVertices", "nHFTertiaryVertices"};
+  char const * const aColumnNames[StHFCandidateTree::kColumnMax] = {"m", "pt", "eta", "phi", "cosPointingAngle", 
+								     "decayLength", "dcaDaughters", "particle1Dca", "particle2Dca", "cosThetaStar", "v0x", "v0y", "v0z"};
+
+  unsigned int const kInitialSize = 64;
+
+  // _________________________________________________________
+  std::string branchName(int const vertexType, char const * const column) {
+    return std::string(aVertexTypeNames[vertexType]) + "_" + column;
+  }
+}
+
+// _________________________________________________________
+StHFCandidateTree::StHFCandidateTree() : mTree(NULL), mRunId(-1), mEventId(-1) {
+  for (int iType = 0; iType < kVertexTypeMax; ++iType) {
+    mHasVertexType[iType] = false;
+    mNCandidates[iType]   = 0;
+    mIsIdxRead[iType]     = false;
+    for (int iCol = 0; iCol < kColumnMax; ++iCol)
+      mIsRead[iType][iCol] = false;
+  }
+}
+
+// _________________________________________________________
+char const * StHFCandidateTree::columnName(int const column) {
+  return (column >= 0 && column < kColumnMax) ? aColumnNames[column] : "";
+}
+
+// _________________________________________________________
+void StHFCandidateTree::createBranches(TTree* tree, bool const bTertiary) {
+  // -- create all branches for writing
+
+  mTree = tree;
+  mTree->Branch("runId",   &mRunId,   "runId/I");
+  mTree->Branch("eventId", &mEventId, "eventId/I");
+
+  for (int iType = 0; iType < kVertexTypeMax; ++iType) {
+    mHasVertexType[iType] = (iType == kSecondary || bTertiary);
+    if (!mHasVertexType[iType])
+      continue;
+
+    for (int iCol = 0; iCol < kColumnMax; ++iCol)
+      mIsRead[iType][iCol] = true;
+    mIsIdxRead[iType] = true;
+
+    resize(iType, kInitialSize);
+
+    std::string const count = aCountNames[iType];
+    mTree->Branch(count.c_str(), &mNCandidates[iType], (count + "/i").c_str());
+
+    for (int iCol = 0; iCol < kColumnMax; ++iCol) {
+      std::string const name = branchName(iType, aColumnNames[iCol]);
+      mTree->Branch(name.c_str(), &mColumns[iType][iCol][0], (name + "[" + count + "]/F").c_str());
+    }
+
+    std::string const name1 = branchName(iType, "particle1Idx");
+    std::string const name2 = branchName(iType, "particle2Idx");
+    mTree->Branch(name1.c_str(), &mParticle1Idx[iType][0], (name1 + "[" + count + "]/s").c_str());
+    mTree->Branch(name2.c_str(), &mParticle2Idx[iType][0], (name2 + "[" + count + "]/s").c_str());
+  }
+}
+
+// _________________________________________________________
+void StHFCandidateTree::fill(StPicoHFEvent const & event) {
+  // -- copy candidates of event into the columns, call before TTree::Fill()
+
+  mRunId   = event.runId();
+  mEventId = event.eventId();
+
+  fillVertices(kSecondary, event.aHFSecondaryVertices(), event.nHFSecondaryVertices());
+
+  if (mHasVertexType[kTertiary])
+    fillVertices(kTertiary, event.aHFTertiaryVertices(), event.nHFTertiaryVertices());
+}
+
+// _________________________________________________________
+void StHFCandidateTree::fillVertices(int const vertexType, TClonesArray const * array, unsigned int const n) {
+  // -- fill columns of one vertex type, grow buffers if needed
+
+  if (n > mColumns[vertexType][kM].size()) {
+    resize(vertexType, 2*n);
+    setAddresses(vertexType);
+  }
+
+  mNCandidates[vertexType] = n;
+
+  std::vector<float> * columns = mColumns[vertexType];
+
+  for (unsigned int idx = 0; idx < n; ++idx) {
+    StHFPair const* pair = static_cast<StHFPair const*>(array->At(idx));
+
+    columns[kM][idx]             = pair->m();
+    columns[kPt][idx]            = pair->pt();
+    columns[kEta][idx]           = pair->eta();
+    columns[kPhi][idx]           = pair->phi();
+    columns[kCosPointingAngle][idx] = pair->cosPointingAngle();
+    columns[kDecayLength][idx]   = pair->decayLength();
+    columns[kDcaDaughters][idx]  = pair->dcaDaughters();
+    columns[kParticle1Dca][idx]  = pair->particle1Dca();
+    columns[kParticle2Dca][idx]  = pair->particle2Dca();
+    columns[kCosThetaStar][idx]  = pair->cosThetaStar();
+    columns[kV0x][idx]           = pair->v0x();
+    columns[kV0y][idx]           = pair->v0y();
+    columns[kV0z][idx]           = pair->v0z();
+
+    mParticle1Idx[vertexType][idx] = pair->particle1Idx();
+    mParticle2Idx[vertexType][idx] = pair->particle2Idx();
+  }
+}
+
+// _________________________________________________________
+bool StHFCandidateTree::setupRead(TTree* tree, char const* columns) {
+  // -- enable only requested columns (separated by ':', empty for all)
+  //    and set their addresses
+
+  mTree = tree;
+
+  if (!mTree->GetBranch(aCountNames[kSecondary]))
+    return false;
+
+  // -- parse requested columns
+  std::string const list = columns ? columns : "";
+  bool bRequested[kColumnMax];
+  bool bIdxRequested = list.empty();
+
+  for (int iCol = 0; iCol < kColumnMax; ++iCol)
+    bRequested[iCol] = list.empty();
+
+  std::string::size_type start = 0;
+  while (start < list.size()) {
+    std::string::size_type end = list.find(':', start);
+    if (end == std::string::npos)
+      end = list.size();
+
+    std::string const name = list.substr(start, end - start);
+    for (int iCol = 0; iCol < kColumnMax; ++iCol)
+      if (name == aColumnNames[iCol])
+	bRequested[iCol] = true;
+    if (name == "pointingAngle")
+      bRequested[kCosPointingAngle] = true;
+    if (name == "particle1Idx" || name == "particle2Idx")
+      bIdxRequested = true;
+
+    start = end + 1;
+  }
+
+  // -- buffer size : largest number of candidates in an event, before branches are disabled
+  unsigned int aSize[kVertexTypeMax];
+  for (int iType = 0; iType < kVertexTypeMax; ++iType) {
+    mHasVertexType[iType] = (mTree->GetBranch(aCountNames[iType]) != NULL);
+    aSize[iType] = mHasVertexType[iType] ? static_cast<unsigned int>(mTree->GetMaximum(aCountNames[iType])) : 0;
+  }
+
+  mTree->SetBranchStatus("*", 0);
+
+  mTree->SetBranchStatus("runId", 1);
+  mTree->SetBranchStatus("eventId", 1);
+  mTree->SetBranchAddress("runId",   &mRunId);
+  mTree->SetBranchAddress("eventId", &mEventId);
+
+  for (int iType = 0; iType < kVertexTypeMax; ++iType) {
+    if (!mHasVertexType[iType])
+      continue;
+
+    mTree->SetBranchStatus(aCountNames[iType], 1);
+    mTree->SetBranchAddress(aCountNames[iType], &mNCandidates[iType]);
+
+    for (int iCol = 0; iCol < kColumnMax; ++iCol) {
+      mIsRead[iType][iCol] = bRequested[iCol] && mTree->GetBranch(branchName(iType, aColumnNames[iCol]).c_str());
+      if (mIsRead[iType][iCol])
+	mTree->SetBranchStatus(branchName(iType, aColumnNames[iCol]).c_str(), 1);
+    }
+
+    mIsIdxRead[iType] = bIdxRequested;
+    if (mIsIdxRead[iType]) {
+      mTree->SetBranchStatus(branchName(iType, "particle1Idx").c_str(), 1);
+      mTree->SetBranchStatus(branchName(iType, "particle2Idx").c_str(), 1);
+    }
+
+    resize(iType, aSize[iType] > 0 ? aSize[iType] : 1);
+    setAddresses(iType);
+  }
+
+  return true;
+}
+
+// _________________________________________________________
+float StHFCandidateTree::pointingAngle(int const vertexType, unsigned int const idx) const {
+  // -- pointing angle from the stored cosPointingAngle, -1 if it is not read
+
+  if (!mIsRead[vertexType][kCosPointingAngle])
+    return -1.;
+
+  return std::acos(mColumns[vertexType][kCosPointingAngle][idx]);
+}
+
+// _________________________________________________________
+void StHFCandidateTree::resize(int const vertexType, unsigned int const n) {
+  // -- resize buffers of used columns
+
+  for (int iCol = 0; iCol < kColumnMax; ++iCol)
+    if (mIsRead[vertexType][iCol])
+      mColumns[vertexType][iCol].resize(n);
+
+  if (mIsIdxRead[vertexType]) {
+    mParticle1Idx[vertexType].resize(n);
+    mParticle2Idx[vertexType].resize(n);
+  }
+}
+
+// _________________________________________________________
+void StHFCandidateTree::setAddresses(int const vertexType) {
+  // -- (re)set addresses of used columns, after buffers moved
+
+  for (int iCol = 0; iCol < kColumnMax; ++iCol)
+    if (mIsRead[vertexType][iCol])
+      mTree->SetBranchAddress(branchName(vertexType, aColumnNames[iCol]).c_str(), &mColumns[vertexType][iCol][0]);
+
+  if (mIsIdxRead[vertexType]) {
+    mTree->SetBranchAddress(branchName(vertexType, "particle1Idx").c_str(), &mParticle1Idx[vertexType][0]);
+    mTree->SetBranchAddress(branchName(vertexType, "particle2Idx").c_str(), &mParticle2Idx[vertexType][0]);
+  }
+}
@@ -0,0 +1,104 @@
+#ifndef StHFCandidateTree_hh
+#define StHFCandidateTree_hh
+
+/* **************************************************
+ *  Flat (columnar) candidate tree, alternative to the
+ *  StPicoHFEvent object branch of the HF tree
+ *
+ *  - one entry per event, with
+ *     runId, eventId
+ *     nHFSecondaryVertices, nHFTertiaryVertices   (number of pairs)
+ *     one array branch per pair quantity, e.g.
+ *       secondary_m[nHFSecondaryVertices]/F
+ *       tertiary_decayLength[nHFTertiaryVertices]/F
+ *    columns : m, pt, eta, phi, cosPointingAngle, decayLength, 
+ *              dcaDaughters, particle1Dca, particle2Dca, cosThetaStar, v0x, v0y, v0z,
+ *              particle1Idx, particle2Idx
+ *    the pointing angle itself is not stored, pointingAngle(vertexType, idx)
+ *    derives it from cosPointingAngle at read time ("pointingAngle" in the 
+ *    columns of setupRead(...) reads cosPointingAngle)
+ *
+ *  - Write : createBranches(...) once, fill(...) before every TTree::Fill()
+ *  - Read  : setupRead(tree, columns) once, with the columns to be read
+ *            (separated by ':', empty string for all columns). All other
+ *            branches are disabled and not read from the file.
+ *            After TTree::GetEntry(...) use column(...) for the arrays
+ *            of the requested columns
+ *
+ *  - only pairs (kTwoParticleDecay, kTwoAndTwoParticleDecay) are supported
+ *
+ * **************************************************
+ */
+
+#include <vector>
+
+#include "Rtypes.h"
+
+class TTree;
+class TClonesArray;
+class StPicoHFEvent;
+
+class StHFCandidateTree
+{
+ public:
+  enum eVertexType {kSecondary, kTertiary, kVertexTypeMax};
+  enum eColumn {kM, kPt, kEta, kPhi, kCosPointingAngle, kDecayLength, kDcaDaughters,
+		kParticle1Dca, kParticle2Dca, kCosThetaStar, kV0x, kV0y, kV0z, kColumnMax};
+
+  StHFCandidateTree();
+  ~StHFCandidateTree() {;}
+
+  // -- write
+  void createBranches(TTree* tree, bool bTertiary);
+  void fill(StPicoHFEvent const & event);
+
+  // -- read
+  bool setupRead(TTree* tree, char const* columns);
+
+  Int_t                  runId()   const;
+  Int_t                  eventId() const;
+  unsigned int           nCandidates(int vertexType) const;
+  float          const * column(int vertexType, int column) const;
+  unsigned short const * particle1Idx(int vertexType) const;
+  unsigned short const * particle2Idx(int vertexType) const;
+  float                  pointingAngle(int vertexType, unsigned int idx) const;
+
+  static char const * columnName(int column);
+
+ private:
+  StHFCandidateTree(StHFCandidateTree const &);
+  StHFCandidateTree& operator=(StHFCandidateTree const &);
+
+  void fillVertices(int vertexType, TClonesArray const * array, unsigned int n);
+  void resize(int vertexType, unsigned int n);
+  void setAddresses(int vertexType);
+
+  TTree*  mTree;
+  bool    mHasVertexType[kVertexTypeMax];
+
+  Int_t   mRunId;
+  Int_t   mEventId;
+  UInt_t  mNCandidates[kVertexTypeMax];
+
+  std::vector<float>          mColumns[kVertexTypeMax][kColumnMax];
+  std::vector<unsigned short> mParticle1Idx[kVertexTypeMax];
+  std::vector<unsigned short> mParticle2Idx[kVertexTypeMax];
+
+  bool    mIsRead[kVertexTypeMax][kColumnMax];  // column is read (all columns for writing)
+  bool    mIsIdxRead[kVertexTypeMax];           // particle indices are read
+};
+
+inline Int_t        StHFCandidateTree::runId()   const { return mRunId; }
+inline Int_t        StHFCandidateTree::eventId() const { return mEventId; }
+inline unsigned int StHFCandidateTree::nCandidates(int vertexType) const { return mNCandidates[vertexType]; }
+
+inline float const * StHFCandidateTree::column(int vertexType, int column) const {
+  return mIsRead[vertexType][column] ? &mColumns[vertexType][column][0] : NULL;
+}
+inline unsigned short const * StHFCandidateTree::particle1Idx(int vertexType) const {
+  return mIsIdxRead[vertexType] ? &mParticle1Idx[vertexType][0] : NULL;
+}
+inline unsigned short const * StHFCandidateTree::particle2Idx(int vertexType) const {
+  return mIsIdxRead[vertexType] ? &mParticle2Idx[vertexType][0] : NULL;
+}
+#endif
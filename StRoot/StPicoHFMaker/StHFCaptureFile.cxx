@@ -0,0 +1,168 @@
+#include <cstring>
+
+#include "StHFCaptureFile.h"
+#include "StHFTrackTable.h"
+
+namespace {
+  char const         kMagic[8] = {'S', 't', 'H', 'F', 'C', 'a', 'p', 't'};
+  unsigned int const kVersion  = 1;
+
+  struct StHFCaptureHeader {
+    char         magic[8];
+    unsigned int version;
+    unsigned int eventSize;  // sizeof(StHFCapturedEvent)
+    unsigned int trackSize;  // sizeof(StHFCapturedTrack)
+  };
+}
+
+// _________________________________________________________
+int StHFCapturedTrack::addToTable(StHFTrackTable & table) const {
+  // -- add track as row to the table, as StHFCachedTrack::addToTable(...)
+
+  return table.addTrack(idx, id, dcaX, dcaY, dcaZ, px, py, pz, charge,
+			nSigmaPion, nSigmaKaon, nSigmaProton, tofBeta);
+}
+
+// _________________________________________________________
+StHFCaptureWriter::StHFCaptureWriter() : mFile(NULL), mEvent(), mTracks(), mNEvents(0) {
+}
+
+// _________________________________________________________
+StHFCaptureWriter::~StHFCaptureWriter() {
+  close();
+}
+
+// _________________________________________________________
+bool StHFCaptureWriter::open(char const* fileName) {
+  // -- create file and write header
+
+  close();
+
+  mFile = fopen(fileName, "wb");
+  if (!mFile)
+    return false;
+
+  StHFCaptureHeader header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version   = kVersion;
+  header.eventSize = sizeof(StHFCapturedEvent);
+  header.trackSize = sizeof(StHFCapturedTrack);
+
+  if (fwrite(&header, sizeof(header), 1, mFile) != 1) {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+// _________________________________________________________
+void StHFCaptureWriter::close() {
+  if (mFile)
+    fclose(mFile);
+  mFile = NULL;
+}
+
+// _________________________________________________________
+void StHFCaptureWriter::beginEvent(StHFCapturedEvent const & event) {
+  mEvent = event;
+  mTracks.clear();
+}
+
+// _________________________________________________________
+void StHFCaptureWriter::addTableRow(StHFTrackTable const & table, int const row, unsigned short const particles) {
+  // -- add selected track from its row in the track table
+
+  StHFCapturedTrack track;
+  track.id           = table.id()[row];
+  track.idx          = table.idx()[row];
+  track.particles    = particles;
+  track.dcaX         = table.dcaX()[row];
+  track.dcaY         = table.dcaY()[row];
+  track.dcaZ         = table.dcaZ()[row];
+  track.px           = table.px()[row];
+  track.py           = table.py()[row];
+  track.pz           = table.pz()[row];
+  track.charge       = table.charge()[row];
+  track.nSigmaPion   = table.nSigmaPion()[row];
+  track.nSigmaKaon   = table.nSigmaKaon()[row];
+  track.nSigmaProton = table.nSigmaProton()[row];
+  track.tofBeta      = table.tofBeta()[row];
+
+  mTracks.push_back(track);
+}
+
+// _________________________________________________________
+bool StHFCaptureWriter::endEvent() {
+  // -- write event and its tracks
+
+  if (!mFile)
+    return false;
+
+  mEvent.nTracks = mTracks.size();
+
+  if (fwrite(&mEvent, sizeof(mEvent), 1, mFile) != 1)
+    return false;
+  if (!mTracks.empty() && fwrite(&mTracks[0], sizeof(StHFCapturedTrack), mTracks.size(), mFile) != mTracks.size())
+    return false;
+
+  ++mNEvents;
+  return true;
+}
+
+// _________________________________________________________
+StHFCaptureReader::StHFCaptureReader() : mFile(NULL), mFirstEvent(0) {
+}
+
+// _________________________________________________________
+StHFCaptureReader::~StHFCaptureReader() {
+  close();
+}
+
+// _________________________________________________________
+bool StHFCaptureReader::open(char const* fileName) {
+  // -- open file and check header
+
+  close();
+
+  mFile = fopen(fileName, "rb");
+  if (!mFile)
+    return false;
+
+  StHFCaptureHeader header;
+  if (fread(&header, sizeof(header), 1, mFile) != 1 || memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion || header.eventSize != sizeof(StHFCapturedEvent) || header.trackSize != sizeof(StHFCapturedTrack)) {
+    close();
+    return false;
+  }
+
+  mFirstEvent = ftell(mFile);
+  return true;
+}
+
+// _________________________________________________________
+void StHFCaptureReader::close() {
+  if (mFile)
+    fclose(mFile);
+  mFile = NULL;
+}
+
+// _________________________________________________________
+bool StHFCaptureReader::rewind() {
+  // -- go back to the first event
+  return mFile && fseek(mFile, mFirstEvent, SEEK_SET) == 0;
+}
+
+// _________________________________________________________
+bool StHFCaptureReader::read(StHFCapturedEvent & event, std::vector<StHFCapturedTrack> & tracks) {
+  // -- read next event, false at the end of the file
+
+  if (!mFile || fread(&event, sizeof(event), 1, mFile) != 1)
+    return false;
+
+  tracks.resize(event.nTracks);
+  if (event.nTracks > 0 && fread(&tracks[0], sizeof(StHFCapturedTrack), event.nTracks, mFile) != event.nTracks)
+    return false;
+
+  return true;
+}
@@ -0,0 +1,115 @@
+#ifndef StHFCaptureFile_hh
+#define StHFCaptureFile_hh
+
+/* **************************************************
+ *  Compact binary file of the per-event state used by
+ *  MakeHF(), to replay real events without StPicoDst
+ *  (see StPicoHFMaker::setCaptureFile(...) and
+ *   hfKinematicsBenchmark/hfReplayBenchmark)
+ *
+ *  - per event (StHFCapturedEvent) : run/event id, trigger word,
+ *    primary vertex, vzVpd, magnetic field, number of tracks
+ *  - per selected track (StHFCapturedTrack) : the row of the
+ *    track in StHFTrackTable and bits of the particle lists
+ *    (pion, kaon, proton) the track was selected for
+ *
+ *  - layout : header (magic, version, sizes of the records),
+ *    then per event StHFCapturedEvent followed by nTracks
+ *    StHFCapturedTrack, in the byte order of the writing machine
+ *
+ *  - StHFCaptureWriter : open(...), beginEvent(...), addTableRow(...)
+ *    per selected track, endEvent(), close()
+ *  - StHFCaptureReader : open(...), read(...) until false, rewind()
+ *
+ * **************************************************
+ */
+
+#include <cstdio>
+#include <vector>
+
+class StHFTrackTable;
+
+struct StHFCapturedEvent
+{
+  int          runId;
+  int          eventId;
+  unsigned int triggerWord;
+  unsigned int nTracks;
+  float        vtxX;
+  float        vtxY;
+  float        vtxZ;
+  float        vzVpd;
+  float        bField;
+};
+
+struct StHFCapturedTrack
+{
+  enum eParticleBit {kPion = 0x1, kKaon = 0x2, kProton = 0x4};
+
+  int            id;
+  unsigned short idx;          // index in StPicoDst
+  unsigned short particles;    // eParticleBit
+  float          dcaX;         // DCA point, relative to the primary vertex
+  float          dcaY;
+  float          dcaZ;
+  float          px;           // momentum at the DCA point
+  float          py;
+  float          pz;
+  float          charge;
+  float          nSigmaPion;
+  float          nSigmaKaon;
+  float          nSigmaProton;
+  float          tofBeta;
+
+  int addToTable(StHFTrackTable & table) const;
+};
+
+class StHFCaptureWriter
+{
+ public:
+  StHFCaptureWriter();
+  ~StHFCaptureWriter();
+
+  bool open(char const* fileName);
+  void close();
+
+  void beginEvent(StHFCapturedEvent const & event);
+  void addTableRow(StHFTrackTable const & table, int row, unsigned short particles);
+  bool endEvent();
+
+  bool         isOpen()  const;
+  unsigned int nEvents() const;
+
+ private:
+  StHFCaptureWriter(StHFCaptureWriter const &);
+  StHFCaptureWriter& operator=(StHFCaptureWriter const &);
+
+  FILE*                          mFile;
+  StHFCapturedEvent              mEvent;
+  std::vector<StHFCapturedTrack> mTracks;
+  unsigned int                   mNEvents;
+};
+
+class StHFCaptureReader
+{
+ public:
+  StHFCaptureReader();
+  ~StHFCaptureReader();
+
+  bool open(char const* fileName);
+  void close();
+  bool rewind();
+
+  bool read(StHFCapturedEvent & event, std::vector<StHFCapturedTrack> & tracks);
+
+ private:
+  StHFCaptureReader(StHFCaptureReader const &);
+  StHFCaptureReader& operator=(StHFCaptureReader const &);
+
+  FILE* mFile;
+  long  mFirstEvent;  // file position of the first event
+};
+
+inline bool         StHFCaptureWriter::isOpen()  const { return mFile != NULL; }
+inline unsigned int StHFCaptureWriter::nEvents() const { return mNEvents; }
+#endif
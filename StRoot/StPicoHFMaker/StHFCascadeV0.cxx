@@ -0,0 +1,130 @@
+#include <limits>
+#include <vector>
+
+#include "StHFCascadeV0.h"
+#include "StHFPair.h"
+#include "StHFTrackCache.h"
+
+#include "StThreeVectorF.hh"
+#include "StPhysicalHelixD.hh"
+#include "SystemOfUnits.h"
+
+// _________________________________________________________
+StHFCascadeV0::StHFCascadeV0() : mMomentum(), mDecayVertex(), mHelix(), mStraightLine(),
+  mDca(std::numeric_limits<float>::quiet_NaN()), mIdx(std::numeric_limits<unsigned short>::max()),
+  mParticle1Idx(std::numeric_limits<unsigned short>::max()), mParticle2Idx(std::numeric_limits<unsigned short>::max()),
+  mParticle1(NULL), mParticle2(NULL), mPrimVtx(), mBField(0.) {
+}
+
+// _________________________________________________________
+StHFCascadeV0::StHFCascadeV0(StHFPair const & v0, unsigned short const v0Idx, StThreeVectorF const & vtx, float const bField,
+			     StHFTrackCache const * const cache) : 
+  mMomentum(), mDecayVertex(), mHelix(), mStraightLine(),
+  mDca(std::numeric_limits<float>::quiet_NaN()), mIdx(std::numeric_limits<unsigned short>::max()),
+  mParticle1Idx(std::numeric_limits<unsigned short>::max()), mParticle2Idx(std::numeric_limits<unsigned short>::max()),
+  mParticle1(NULL), mParticle2(NULL), mPrimVtx(), mBField(0.) {
+  setup(v0, v0Idx, vtx, bField, cache);
+}
+
+// _________________________________________________________
+void StHFCascadeV0::setup(StHFPair const & v0, unsigned short const v0Idx, StThreeVectorF const & vtx, float const bField,
+			  StHFTrackCache const * const cache) {
+  // -- state of the V0, once per V0
+  //    the V0 is seen as having charge = 0
+
+  mMomentum    = StThreeVectorF(v0.px(), v0.py(), v0.pz());
+  mDecayVertex = StThreeVectorF(v0.v0x(), v0.v0y(), v0.v0z());
+
+  // -- move origin of V0 helix to the primary vertex origin
+  mHelix = StPhysicalHelixD(mMomentum, mDecayVertex, bField * kilogauss, 0.);
+  mHelix.moveOrigin(mHelix.pathLength(vtx));
+
+  mStraightLine = StPhysicalHelixD(mMomentum, mHelix.origin(), 0, 0.);
+
+  mDca = (mHelix.origin() - vtx).mag();
+
+  mIdx          = v0Idx;
+  mParticle1Idx = v0.particle1Idx();
+  mParticle2Idx = v0.particle2Idx();
+  mParticle1    = cache ? cache->get(mParticle1Idx) : NULL;
+  mParticle2    = cache ? cache->get(mParticle2Idx) : NULL;
+
+  mPrimVtx = vtx;
+  mBField  = bField;
+}
+
+// _________________________________________________________
+bool StHFCascadeV0::isDaughter(StHFCachedTrack const & trk) const {
+  return trk.idx() == mParticle1Idx || trk.idx() == mParticle2Idx;
+}
+
+// _________________________________________________________
+float StHFCascadeV0::pointingAngle(StThreeVectorF const & vtx2) const {
+  // -- pointing angle of V0 with respect to the secondary vertex
+  return (mDecayVertex - vtx2).angle(mMomentum);
+}
+
+// _________________________________________________________
+float StHFCascadeV0::decayLength(StThreeVectorF const & vtx2) const {
+  // -- decay length of V0 with respect to the secondary vertex
+  return (mDecayVertex - vtx2).mag();
+}
+
+// _________________________________________________________
+float StHFCascadeV0::particle1Dca(StThreeVectorF const & vtx2) const {
+  return daughterDca(mParticle1, vtx2);
+}
+
+// _________________________________________________________
+float StHFCascadeV0::particle2Dca(StThreeVectorF const & vtx2) const {
+  return daughterDca(mParticle2, vtx2);
+}
+
+// _________________________________________________________
+float StHFCascadeV0::daughterDca(StHFCachedTrack const * const daughter, StThreeVectorF const & vtx2) const {
+  // -- DCA of a V0 daughter to the secondary vertex
+  //    starts from the cached helix, origin already at the DCA to the primary vertex
+
+  if (!daughter)
+    return std::numeric_limits<float>::quiet_NaN();
+
+  StPhysicalHelixD helix = daughter->helix();
+  helix.moveOrigin(helix.pathLength(vtx2));
+
+  return (helix.origin() - vtx2).mag();
+}
+
+// _________________________________________________________
+void StHFCascadeV0::score(std::vector<StHFCachedTrack const *> const & bachelors, 
+			  float const bachelorMassHypo, float const v0MassHypo,
+			  std::vector<StHFCascadeScore> & scores) const {
+  // -- combine V0 with all bachelors, secondary pair and V0 with respect to its vertex
+
+  scores.resize(bachelors.size());
+
+  for (unsigned int ii = 0; ii < bachelors.size(); ++ii) {
+    StHFCascadeScore & score = scores[ii];
+
+    StHFCachedTrack const & bachelor = *bachelors[ii];
+    score.bachelorIdx = bachelor.idx();
+
+    StHFPair const pair(bachelor, *this, bachelorMassHypo, v0MassHypo);
+
+    score.isValid = (pair.particle1Idx() != std::numeric_limits<unsigned short>::max());
+    if (!score.isValid) 
+      continue;
+
+    score.m                = pair.m();
+    score.pt               = pair.pt();
+    score.dcaDaughters     = pair.dcaDaughters();
+    score.decayLength      = pair.decayLength();
+    score.cosPointingAngle = pair.cosPointingAngle();
+    score.bachelorDca      = pair.particle1Dca();
+
+    StThreeVectorF const secondaryVtx(pair.v0x(), pair.v0y(), pair.v0z());
+    score.v0DecayLength   = decayLength(secondaryVtx);
+    score.v0PointingAngle = pointingAngle(secondaryVtx);
+    score.v0Particle1Dca  = particle1Dca(secondaryVtx);
+    score.v0Particle2Dca  = particle2Dca(secondaryVtx);
+  }
+}
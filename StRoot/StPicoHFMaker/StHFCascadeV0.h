@@ -0,0 +1,117 @@
+#ifndef StHFCascadeV0_hh
+#define StHFCascadeV0_hh
+
+/* **************************************************
+ *  State of a tertiary pair (V0, e.g. K0S or Lambda) to be 
+ *  combined with many bachelor tracks into secondary pairs 
+ *  (kTwoAndTwoParticleDecay, e.g. D+ -> K0S pi, Lambda_c -> K0S p)
+ *
+ *  - setup(...) is done once per V0 : its neutral helix is moved
+ *    to the primary vertex and its straight line is created once,
+ *    the cached tracks of its daughters are taken from StHFTrackCache
+ *  - StHFPair(StHFCachedTrack const & bachelor, StHFCascadeV0 const & v0, ...)
+ *    builds the secondary pair from this state, without recreating
+ *    the V0 helix for every bachelor
+ *  - the tertiary quantities with respect to the secondary vertex vtx2
+ *    (pointingAngle, decayLength, DCA of the V0 daughters) are 
+ *    updated from the stored state, the daughter helices are taken 
+ *    from the track cache instead of StPicoTrack::dcaGeometry()
+ *  - score(...) combines the V0 with a list of bachelors at once and 
+ *    returns the secondary and the updated tertiary quantities 
+ *    per bachelor (StHFCascadeScore)
+ *
+ * **************************************************
+ */
+
+#include <vector>
+
+#include "StThreeVectorF.hh"
+#include "StPhysicalHelixD.hh"
+
+class StHFPair;
+class StHFCachedTrack;
+class StHFTrackCache;
+
+struct StHFCascadeScore
+{
+  unsigned short bachelorIdx;      // index of bachelor in StPicoDst
+  bool           isValid;          // false if the bachelor is a daughter of the V0
+
+  // -- secondary pair
+  float          m;
+  float          pt;
+  float          dcaDaughters;
+  float          decayLength;
+  float          cosPointingAngle;
+  float          bachelorDca;
+
+  // -- V0 with respect to the secondary vertex
+  float          v0DecayLength;
+  float          v0PointingAngle;
+  float          v0Particle1Dca;
+  float          v0Particle2Dca;
+};
+
+class StHFCascadeV0
+{
+ public:
+  StHFCascadeV0();
+  StHFCascadeV0(StHFPair const & v0, unsigned short v0Idx, StThreeVectorF const & vtx, float bField,
+		StHFTrackCache const * cache = NULL);
+  ~StHFCascadeV0() {;}
+
+  void setup(StHFPair const & v0, unsigned short v0Idx, StThreeVectorF const & vtx, float bField,
+	     StHFTrackCache const * cache = NULL);
+
+  StThreeVectorF   const & momentum()     const;
+  StThreeVectorF   const & decayVertex()  const;
+  StPhysicalHelixD const & helix()        const;
+  StPhysicalHelixD const & straightLine() const;
+  float                    dca()          const;
+  unsigned short           idx()          const;
+  unsigned short           particle1Idx() const;
+  unsigned short           particle2Idx() const;
+  StThreeVectorF   const & primVtx()      const;
+  float                    bField()       const;
+
+  bool  isDaughter(StHFCachedTrack const & trk) const;
+
+  // -- tertiary quantities with respect to the secondary vertex vtx2
+  float pointingAngle(StThreeVectorF const & vtx2) const;
+  float decayLength(StThreeVectorF const & vtx2)   const;
+  float particle1Dca(StThreeVectorF const & vtx2)  const;
+  float particle2Dca(StThreeVectorF const & vtx2)  const;
+
+  void  score(std::vector<StHFCachedTrack const *> const & bachelors, float bachelorMassHypo, float v0MassHypo,
+	      std::vector<StHFCascadeScore> & scores) const;
+
+ private:
+  float daughterDca(StHFCachedTrack const * daughter, StThreeVectorF const & vtx2) const;
+
+  StThreeVectorF   mMomentum;       // momentum of V0
+  StThreeVectorF   mDecayVertex;    // tertiary vertex
+  StPhysicalHelixD mHelix;          // neutral helix, origin moved to DCA to primary vertex
+  StPhysicalHelixD mStraightLine;   // straight line through the origin of mHelix
+  float            mDca;            // DCA of V0 to primary vertex
+
+  unsigned short   mIdx;            // index of V0 in the tertiary vertex array
+  unsigned short   mParticle1Idx;   // indices of V0 daughters in StPicoDst
+  unsigned short   mParticle2Idx;
+  StHFCachedTrack const * mParticle1; // cached V0 daughters, NULL if not cached
+  StHFCachedTrack const * mParticle2;
+
+  StThreeVectorF   mPrimVtx;
+  float            mBField;
+};
+
+inline StThreeVectorF   const & StHFCascadeV0::momentum()     const { return mMomentum; }
+inline StThreeVectorF   const & StHFCascadeV0::decayVertex()  const { return mDecayVertex; }
+inline StPhysicalHelixD const & StHFCascadeV0::helix()        const { return mHelix; }
+inline StPhysicalHelixD const & StHFCascadeV0::straightLine() const { return mStraightLine; }
+inline float                    StHFCascadeV0::dca()          const { return mDca; }
+inline unsigned short           StHFCascadeV0::idx()          const { return mIdx; }
+inline unsigned short           StHFCascadeV0::particle1Idx() const { return mParticle1Idx; }
+inline unsigned short           StHFCascadeV0::particle2Idx() const { return mParticle2Idx; }
+inline StThreeVectorF   const & StHFCascadeV0::primVtx()      const { return mPrimVtx; }
+inline float                    StHFCascadeV0::bField()       const { return mBField; }
+#endif
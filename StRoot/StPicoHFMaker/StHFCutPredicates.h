@@ -0,0 +1,458 @@
+#ifndef StHFCutPredicates_hh
+#define StHFCutPredicates_hh
+
+/* **************************************************
+ *  Specialised cut predicates built from StHFCuts
+ *
+ *  - StHFTrackPredicate, StHFTPCPredicate, StHFTOFPredicate,
+ *    StHFPairPredicate, StHFTripletPredicate hold the bounds of
+ *    one cut set and evaluate all of them in one branch-free
+ *    expression (operator() returns 0 or 1)
+ *
+ *  - upper bounds which are not set (std::numeric_limits<float>::max(),
+ *    the default of StHFCuts) are template parameters, their
+ *    comparisons are removed at compile time
+ *    (lower bounds are always applied, their default
+ *    std::numeric_limits<float>::min() is a cut at 0)
+ *
+ *  - StHFCutPredicates::dispatchXXX(cuts, ..., op) builds the predicate
+ *    for the bounds set in cuts and calls op(predicate), op has to
+ *    provide a template operator()(Pred const &). Use it outside of
+ *    loops, so that the loop is compiled for the specialised predicate:
+ *
+ *      struct MyLoop {
+ *        template <class Pred> void operator()(Pred const & pred) {
+ *          for (...) pass[ii] = pred(pt[ii], eta[ii], nSigma[ii]);
+ *        }
+ *      };
+ *      MyLoop loop;
+ *      StHFCutPredicates::dispatchTPC(cuts, StHFCutPredicates::kKaon, loop);
+ *
+ *  - StHFCutPredicateSet holds for one StHFCuts the specialised predicates
+ *    with their bounds, built once via the dispatchXXX(...) methods in 
+ *    StHFCuts::finalize(). The isGoodXXX/isTPCXXX/isTOFXXX methods of 
+ *    StHFCuts call them, results are identical to all bounds active
+ *
+ * **************************************************
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "phys_constants.h"
+
+#include "StHFCuts.h"
+
+// _________________________________________________________
+// -- upper bound, compiled out if not active
+template <bool bActive> struct StHFMaxBound {
+  static unsigned int pass(float const x, float const max) { return x < max; }
+};
+
+template <> struct StHFMaxBound<false> {
+  static unsigned int pass(float const, float const) { return 1u; }
+};
+
+// _________________________________________________________
+template <bool bRequireHFT> class StHFTrackPredicate
+{
+ public:
+  StHFTrackPredicate() : mNHitsFitMin(0) {;}
+  explicit StHFTrackPredicate(int nHitsFitMin) : mNHitsFitMin(nHitsFitMin) {;}
+
+  unsigned int operator()(bool const isHFTTrack, int const nHitsFit) const {
+    return (!bRequireHFT | isHFTTrack) & (nHitsFit >= mNHitsFitMin);
+  }
+
+ private:
+  int mNHitsFitMin;
+};
+
+// _________________________________________________________
+template <bool bPtMax, bool bEtaMax> class StHFTPCPredicate
+{
+ public:
+  StHFTPCPredicate() : mPtMin(0.), mPtMax(0.), mEtaMin(0.), mEtaMax(0.), mNSigmaMax(0.) {;}
+  StHFTPCPredicate(float ptMin, float ptMax, float etaMin, float etaMax, float nSigmaMax) :
+    mPtMin(ptMin), mPtMax(ptMax), mEtaMin(etaMin), mEtaMax(etaMax), mNSigmaMax(nSigmaMax) {;}
+
+  unsigned int operator()(float const pt, float const eta, float const nSigma) const {
+    return ((pt >= mPtMin) & StHFMaxBound<bPtMax>::pass(pt, mPtMax) &
+	    (eta >= mEtaMin) & StHFMaxBound<bEtaMax>::pass(eta, mEtaMax) &
+	    (fabs(nSigma) < mNSigmaMax));
+  }
+
+ private:
+  float mPtMin;
+  float mPtMax;
+  float mEtaMin;
+  float mEtaMax;
+  float mNSigmaMax;
+};
+
+// _________________________________________________________
+template <bool bPtMax> class StHFTOFPredicate
+{
+ public:
+  StHFTOFPredicate() : mMass2(0.), mPtMin(0.), mPtMax(0.), mNSigmaMax(0.) {;}
+  StHFTOFPredicate(float mass, float ptMin, float ptMax, float nSigmaMax) :
+    mMass2(mass*mass), mPtMin(ptMin), mPtMax(ptMax), mNSigmaMax(nSigmaMax) {;}
+
+  unsigned int operator()(float const pt, float const ptot, float const bTofBeta) const {
+    // -- TOF calculations
+    float const beta = ptot/sqrt(ptot*ptot+mMass2);
+    float const tof  = 1/bTofBeta - 1/beta;
+    return (pt >= mPtMin) & StHFMaxBound<bPtMax>::pass(pt, mPtMax) & (fabs(tof) < mNSigmaMax);
+  }
+
+ private:
+  float mMass2;
+  float mPtMin;
+  float mPtMax;
+  float mNSigmaMax;
+};
+
+// _________________________________________________________
+template <bool bDcaDaughtersMax, bool bDecayLengthMax, bool bMassMax> class StHFPairPredicate
+{
+ public:
+  StHFPairPredicate() : 
+    mDcaDaughtersMax(0.), mDecayLengthMin(0.), mDecayLengthMax(0.), 
+    mCosThetaMin(0.), mMassMin(0.), mMassMax(0.) {;}
+  StHFPairPredicate(float dcaDaughtersMax, float decayLengthMin, float decayLengthMax,
+		    float cosThetaMin, float massMin, float massMax) :
+    mDcaDaughtersMax(dcaDaughtersMax), mDecayLengthMin(decayLengthMin), mDecayLengthMax(decayLengthMax),
+    mCosThetaMin(cosThetaMin), mMassMin(massMin), mMassMax(massMax) {;}
+
+  unsigned int operator()(float const m, float const cosPointingAngle,
+			  float const decayLength, float const dcaDaughters) const {
+    return ((m > mMassMin) & StHFMaxBound<bMassMax>::pass(m, mMassMax) &
+	    (cosPointingAngle > mCosThetaMin) &
+	    (decayLength > mDecayLengthMin) & StHFMaxBound<bDecayLengthMax>::pass(decayLength, mDecayLengthMax) &
+	    StHFMaxBound<bDcaDaughtersMax>::pass(dcaDaughters, mDcaDaughtersMax));
+  }
+
+ private:
+  float mDcaDaughtersMax;
+  float mDecayLengthMin;
+  float mDecayLengthMax;
+  float mCosThetaMin;
+  float mMassMin;
+  float mMassMax;
+};
+
+// _________________________________________________________
+template <bool bDcaDaughtersMax, bool bDecayLengthMax, bool bMassMax> class StHFTripletPredicate
+{
+ public:
+  StHFTripletPredicate() : 
+    mDcaDaughters12Max(0.), mDcaDaughters23Max(0.), mDcaDaughters31Max(0.),
+    mDecayLengthMin(0.), mDecayLengthMax(0.), mCosThetaMin(0.), mMassMin(0.), mMassMax(0.) {;}
+  StHFTripletPredicate(float dcaDaughters12Max, float dcaDaughters23Max, float dcaDaughters31Max,
+		       float decayLengthMin, float decayLengthMax,
+		       float cosThetaMin, float massMin, float massMax) :
+    mDcaDaughters12Max(dcaDaughters12Max), mDcaDaughters23Max(dcaDaughters23Max), mDcaDaughters31Max(dcaDaughters31Max),
+    mDecayLengthMin(decayLengthMin), mDecayLengthMax(decayLengthMax),
+    mCosThetaMin(cosThetaMin), mMassMin(massMin), mMassMax(massMax) {;}
+
+  unsigned int operator()(float const m, float const cosPointingAngle, float const decayLength,
+			  float const dcaDaughters12, float const dcaDaughters23, float const dcaDaughters31) const {
+    return ((m > mMassMin) & StHFMaxBound<bMassMax>::pass(m, mMassMax) &
+	    (cosPointingAngle > mCosThetaMin) &
+	    (decayLength > mDecayLengthMin) & StHFMaxBound<bDecayLengthMax>::pass(decayLength, mDecayLengthMax) &
+	    StHFMaxBound<bDcaDaughtersMax>::pass(dcaDaughters12, mDcaDaughters12Max) &
+	    StHFMaxBound<bDcaDaughtersMax>::pass(dcaDaughters23, mDcaDaughters23Max) &
+	    StHFMaxBound<bDcaDaughtersMax>::pass(dcaDaughters31, mDcaDaughters31Max));
+  }
+
+ private:
+  float mDcaDaughters12Max;
+  float mDcaDaughters23Max;
+  float mDcaDaughters31Max;
+  float mDecayLengthMin;
+  float mDecayLengthMax;
+  float mCosThetaMin;
+  float mMassMin;
+  float mMassMax;
+};
+
+// _________________________________________________________
+// -- build specialised predicates from StHFCuts
+struct StHFCutPredicates
+{
+  enum eParticle {kPion, kKaon, kProton};  // same order as StHFTrackSelection::eParticle
+
+  static bool isSet(float const max) { return max < std::numeric_limits<float>::max(); }
+
+  // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+
+  template <class Op> static void dispatchTrack(StHFCuts const & cuts, Op & op) {
+    if (cuts.cutRequireHFT()) op(StHFTrackPredicate<true>(cuts.cutNHitsFitMax()));
+    else                      op(StHFTrackPredicate<false>(cuts.cutNHitsFitMax()));
+  }
+
+  // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+
+  template <class Op> static void dispatchTPC(StHFCuts const & cuts, int const particle, Op & op) {
+    float ptMin, ptMax, etaMin, etaMax, nSigmaMax;
+    tpcBounds(cuts, particle, ptMin, ptMax, etaMin, etaMax, nSigmaMax);
+
+    if (isSet(ptMax)) {
+      if (isSet(etaMax)) op(StHFTPCPredicate<true, true> (ptMin, ptMax, etaMin, etaMax, nSigmaMax));
+      else               op(StHFTPCPredicate<true, false>(ptMin, ptMax, etaMin, etaMax, nSigmaMax));
+    }
+    else {
+      if (isSet(etaMax)) op(StHFTPCPredicate<false, true> (ptMin, ptMax, etaMin, etaMax, nSigmaMax));
+      else               op(StHFTPCPredicate<false, false>(ptMin, ptMax, etaMin, etaMax, nSigmaMax));
+    }
+  }
+
+  static void tpcBounds(StHFCuts const & cuts, int const particle, float & ptMin, float & ptMax, 
+			float & etaMin, float & etaMax, float & nSigmaMax) {
+    if (particle == kPion) {
+      ptMin  = cuts.cutPionPtMin();  ptMax  = cuts.cutPionPtMax();
+      etaMin = cuts.cutPionEtaMin(); etaMax = cuts.cutPionEtaMax(); nSigmaMax = cuts.cutTPCNSigmaPion();
+    }
+    else if (particle == kKaon) {
+      ptMin  = cuts.cutKaonPtMin();  ptMax  = cuts.cutKaonPtMax();
+      etaMin = cuts.cutKaonEtaMin(); etaMax = cuts.cutKaonEtaMax(); nSigmaMax = cuts.cutTPCNSigmaKaon();
+    }
+    else {
+      ptMin  = cuts.cutProtonPtMin();  ptMax  = cuts.cutProtonPtMax();
+      etaMin = cuts.cutProtonEtaMin(); etaMax = cuts.cutProtonEtaMax(); nSigmaMax = cuts.cutTPCNSigmaProton();
+    }
+  }
+
+  // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+
+  template <class Op> static void dispatchTOF(StHFCuts const & cuts, int const particle, float const mass, Op & op) {
+    float ptMin, ptMax, nSigmaMax;
+    if (particle == kPion) {
+      ptMin = cuts.cutPionPtTOFMin(); ptMax = cuts.cutPionPtTOFMax(); nSigmaMax = cuts.cutTOFNSigmaPion();
+    }
+    else if (particle == kKaon) {
+      ptMin = cuts.cutKaonPtTOFMin(); ptMax = cuts.cutKaonPtTOFMax(); nSigmaMax = cuts.cutTOFNSigmaKaon();
+    }
+    else {
+      ptMin = cuts.cutProtonPtTOFMin(); ptMax = cuts.cutProtonPtTOFMax(); nSigmaMax = cuts.cutTOFNSigmaProton();
+    }
+
+    if (isSet(ptMax)) op(StHFTOFPredicate<true> (mass, ptMin, ptMax, nSigmaMax));
+    else              op(StHFTOFPredicate<false>(mass, ptMin, ptMax, nSigmaMax));
+  }
+
+  // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+
+  template <class Op> static void dispatchPair(StHFCuts const & cuts, int const pairType, Op & op) {
+    if (pairType == StHFCuts::kSecondaryPair)
+      dispatchPairDca(cuts.cutSecondaryPairDcaDaughtersMax(), cuts.cutSecondaryPairDecayLengthMin(),
+		      cuts.cutSecondaryPairDecayLengthMax(), cuts.cutSecondaryPairCosThetaMin(),
+		      cuts.cutSecondaryPairMassMin(), cuts.cutSecondaryPairMassMax(), op);
+    else
+      dispatchPairDca(cuts.cutTertiaryPairDcaDaughtersMax(), cuts.cutTertiaryPairDecayLengthMin(),
+		      cuts.cutTertiaryPairDecayLengthMax(), cuts.cutTertiaryPairCosThetaMin(),
+		      cuts.cutTertiaryPairMassMin(), cuts.cutTertiaryPairMassMax(), op);
+  }
+
+  template <class Op> static void dispatchPairDca(float dcaMax, float dlMin, float dlMax, float cosMin,
+						  float mMin, float mMax, Op & op) {
+    if (isSet(dcaMax)) dispatchPairDecayLength<true> (dcaMax, dlMin, dlMax, cosMin, mMin, mMax, op);
+    else               dispatchPairDecayLength<false>(dcaMax, dlMin, dlMax, cosMin, mMin, mMax, op);
+  }
+
+  template <bool bDca, class Op> static void dispatchPairDecayLength(float dcaMax, float dlMin, float dlMax, float cosMin,
+								     float mMin, float mMax, Op & op) {
+    if (isSet(dlMax)) dispatchPairMass<bDca, true> (dcaMax, dlMin, dlMax, cosMin, mMin, mMax, op);
+    else              dispatchPairMass<bDca, false>(dcaMax, dlMin, dlMax, cosMin, mMin, mMax, op);
+  }
+
+  template <bool bDca, bool bDl, class Op> static void dispatchPairMass(float dcaMax, float dlMin, float dlMax, float cosMin,
+									float mMin, float mMax, Op & op) {
+    if (isSet(mMax)) op(StHFPairPredicate<bDca, bDl, true> (dcaMax, dlMin, dlMax, cosMin, mMin, mMax));
+    else             op(StHFPairPredicate<bDca, bDl, false>(dcaMax, dlMin, dlMax, cosMin, mMin, mMax));
+  }
+
+  // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+
+  template <class Op> static void dispatchTriplet(StHFCuts const & cuts, Op & op) {
+    // -- the three dcaDaughters cuts are compiled out only together
+    bool const bDca = (isSet(cuts.cutSecondaryTripletDcaDaughters12Max()) ||
+		       isSet(cuts.cutSecondaryTripletDcaDaughters23Max()) ||
+		       isSet(cuts.cutSecondaryTripletDcaDaughters31Max()));
+    if (bDca) dispatchTripletDecayLength<true> (cuts, op);
+    else      dispatchTripletDecayLength<false>(cuts, op);
+  }
+
+  template <bool bDca, class Op> static void dispatchTripletDecayLength(StHFCuts const & cuts, Op & op) {
+    if (isSet(cuts.cutSecondaryTripletDecayLengthMax())) dispatchTripletMass<bDca, true> (cuts, op);
+    else                                                 dispatchTripletMass<bDca, false>(cuts, op);
+  }
+
+  template <bool bDca, bool bDl, class Op> static void dispatchTripletMass(StHFCuts const & cuts, Op & op) {
+    if (isSet(cuts.cutSecondaryTripletMassMax())) op(triplet<bDca, bDl, true>(cuts));
+    else                                          op(triplet<bDca, bDl, false>(cuts));
+  }
+
+  template <bool bDca, bool bDl, bool bMass> static StHFTripletPredicate<bDca, bDl, bMass> triplet(StHFCuts const & cuts) {
+    return StHFTripletPredicate<bDca, bDl, bMass>(cuts.cutSecondaryTripletDcaDaughters12Max(), cuts.cutSecondaryTripletDcaDaughters23Max(),
+						  cuts.cutSecondaryTripletDcaDaughters31Max(),
+						  cuts.cutSecondaryTripletDecayLengthMin(), cuts.cutSecondaryTripletDecayLengthMax(),
+						  cuts.cutSecondaryTripletCosThetaMin(),
+						  cuts.cutSecondaryTripletMassMin(), cuts.cutSecondaryTripletMassMax());
+  }
+};
+
+// _________________________________________________________
+// -- specialised predicates of one StHFCuts, with the bounds captured once
+//    in StHFCuts::finalize(). Every slot keeps the predicate selected via 
+//    StHFCutPredicates::dispatchXXX(...) and the index of its variant, 
+//    pass(...) switches on the index and calls the predicate inlined.
+//    Loops over many tracks or candidates should use dispatchXXX(...) directly
+class StHFCutPredicateSet
+{
+ public:
+  explicit StHFCutPredicateSet(StHFCuts const & cuts) {
+    StHFCutPredicates::dispatchTrack(cuts, track);
+
+    double const aMass[3] = {M_PION_PLUS, M_KAON_PLUS, M_PROTON};  // StHFCutPredicates::eParticle
+    for (int ii = 0; ii < 3; ++ii) {
+      StHFCutPredicates::dispatchTPC(cuts, ii, tpc[ii]);
+      StHFCutPredicates::dispatchTOF(cuts, ii, aMass[ii], tof[ii]);
+    }
+
+    for (int ii = 0; ii < 2; ++ii)
+      StHFCutPredicates::dispatchPair(cuts, ii, pair[ii]);
+
+    StHFCutPredicates::dispatchTriplet(cuts, triplet);
+  }
+
+  // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+  struct TrackSlot {
+    void operator()(StHFTrackPredicate<false> const & pred) { p0 = pred; variant = 0; }
+    void operator()(StHFTrackPredicate<true>  const & pred) { p1 = pred; variant = 1; }
+
+    unsigned int pass(bool const isHFTTrack, int const nHitsFit) const {
+      return variant ? p1(isHFTTrack, nHitsFit) : p0(isHFTTrack, nHitsFit);
+    }
+
+    unsigned int variant;
+    StHFTrackPredicate<false> p0;
+    StHFTrackPredicate<true>  p1;
+  };
+
+  // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+  struct TPCSlot {
+    void operator()(StHFTPCPredicate<false, false> const & pred) { p00 = pred; variant = 0; }
+    void operator()(StHFTPCPredicate<false, true>  const & pred) { p01 = pred; variant = 1; }
+    void operator()(StHFTPCPredicate<true, false>  const & pred) { p10 = pred; variant = 2; }
+    void operator()(StHFTPCPredicate<true, true>   const & pred) { p11 = pred; variant = 3; }
+
+    unsigned int pass(float const pt, float const eta, float const nSigma) const {
+      switch (variant) {
+      case 0  : return p00(pt, eta, nSigma);
+      case 1  : return p01(pt, eta, nSigma);
+      case 2  : return p10(pt, eta, nSigma);
+      default : return p11(pt, eta, nSigma);
+      }
+    }
+
+    unsigned int variant;
+    StHFTPCPredicate<false, false> p00;
+    StHFTPCPredicate<false, true>  p01;
+    StHFTPCPredicate<true, false>  p10;
+    StHFTPCPredicate<true, true>   p11;
+  };
+
+  // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+  struct TOFSlot {
+    void operator()(StHFTOFPredicate<false> const & pred) { p0 = pred; variant = 0; }
+    void operator()(StHFTOFPredicate<true>  const & pred) { p1 = pred; variant = 1; }
+
+    unsigned int pass(float const pt, float const ptot, float const bTofBeta) const {
+      return variant ? p1(pt, ptot, bTofBeta) : p0(pt, ptot, bTofBeta);
+    }
+
+    unsigned int variant;
+    StHFTOFPredicate<false> p0;
+    StHFTOFPredicate<true>  p1;
+  };
+
+  // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+  struct PairSlot {
+    void operator()(StHFPairPredicate<false, false, false> const & pred) { p000 = pred; variant = 0; }
+    void operator()(StHFPairPredicate<false, false, true>  const & pred) { p001 = pred; variant = 1; }
+    void operator()(StHFPairPredicate<false, true, false>  const & pred) { p010 = pred; variant = 2; }
+    void operator()(StHFPairPredicate<false, true, true>   const & pred) { p011 = pred; variant = 3; }
+    void operator()(StHFPairPredicate<true, false, false>  const & pred) { p100 = pred; variant = 4; }
+    void operator()(StHFPairPredicate<true, false, true>   const & pred) { p101 = pred; variant = 5; }
+    void operator()(StHFPairPredicate<true, true, false>   const & pred) { p110 = pred; variant = 6; }
+    void operator()(StHFPairPredicate<true, true, true>    const & pred) { p111 = pred; variant = 7; }
+
+    unsigned int pass(float const m, float const cosPointingAngle, float const decayLength, float const dcaDaughters) const {
+      switch (variant) {
+      case 0  : return p000(m, cosPointingAngle, decayLength, dcaDaughters);
+      case 1  : return p001(m, cosPointingAngle, decayLength, dcaDaughters);
+      case 2  : return p010(m, cosPointingAngle, decayLength, dcaDaughters);
+      case 3  : return p011(m, cosPointingAngle, decayLength, dcaDaughters);
+      case 4  : return p100(m, cosPointingAngle, decayLength, dcaDaughters);
+      case 5  : return p101(m, cosPointingAngle, decayLength, dcaDaughters);
+      case 6  : return p110(m, cosPointingAngle, decayLength, dcaDaughters);
+      default : return p111(m, cosPointingAngle, decayLength, dcaDaughters);
+      }
+    }
+
+    unsigned int variant;
+    StHFPairPredicate<false, false, false> p000;
+    StHFPairPredicate<false, false, true>  p001;
+    StHFPairPredicate<false, true, false>  p010;
+    StHFPairPredicate<false, true, true>   p011;
+    StHFPairPredicate<true, false, false>  p100;
+    StHFPairPredicate<true, false, true>   p101;
+    StHFPairPredicate<true, true, false>   p110;
+    StHFPairPredicate<true, true, true>    p111;
+  };
+
+  // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+  struct TripletSlot {
+    void operator()(StHFTripletPredicate<false, false, false> const & pred) { p000 = pred; variant = 0; }
+    void operator()(StHFTripletPredicate<false, false, true>  const & pred) { p001 = pred; variant = 1; }
+    void operator()(StHFTripletPredicate<false, true, false>  const & pred) { p010 = pred; variant = 2; }
+    void operator()(StHFTripletPredicate<false, true, true>   const & pred) { p011 = pred; variant = 3; }
+    void operator()(StHFTripletPredicate<true, false, false>  const & pred) { p100 = pred; variant = 4; }
+    void operator()(StHFTripletPredicate<true, false, true>   const & pred) { p101 = pred; variant = 5; }
+    void operator()(StHFTripletPredicate<true, true, false>   const & pred) { p110 = pred; variant = 6; }
+    void operator()(StHFTripletPredicate<true, true, true>    const & pred) { p111 = pred; variant = 7; }
+
+    unsigned int pass(float const m, float const cosPointingAngle, float const decayLength,
+		      float const dcaDaughters12, float const dcaDaughters23, float const dcaDaughters31) const {
+      switch (variant) {
+      case 0  : return p000(m, cosPointingAngle, decayLength, dcaDaughters12, dcaDaughters23, dcaDaughters31);
+      case 1  : return p001(m, cosPointingAngle, decayLength, dcaDaughters12, dcaDaughters23, dcaDaughters31);
+      case 2  : return p010(m, cosPointingAngle, decayLength, dcaDaughters12, dcaDaughters23, dcaDaughters31);
+      case 3  : return p011(m, cosPointingAngle, decayLength, dcaDaughters12, dcaDaughters23, dcaDaughters31);
+      case 4  : return p100(m, cosPointingAngle, decayLength, dcaDaughters12, dcaDaughters23, dcaDaughters31);
+      case 5  : return p101(m, cosPointingAngle, decayLength, dcaDaughters12, dcaDaughters23, dcaDaughters31);
+      case 6  : return p110(m, cosPointingAngle, decayLength, dcaDaughters12, dcaDaughters23, dcaDaughters31);
+      default : return p111(m, cosPointingAngle, decayLength, dcaDaughters12, dcaDaughters23, dcaDaughters31);
+      }
+    }
+
+    unsigned int variant;
+    StHFTripletPredicate<false, false, false> p000;
+    StHFTripletPredicate<false, false, true>  p001;
+    StHFTripletPredicate<false, true, false>  p010;
+    StHFTripletPredicate<false, true, true>   p011;
+    StHFTripletPredicate<true, false, false>  p100;
+    StHFTripletPredicate<true, false, true>   p101;
+    StHFTripletPredicate<true, true, false>   p110;
+    StHFTripletPredicate<true, true, true>    p111;
+  };
+
+  // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+  TrackSlot   track;
+  TPCSlot     tpc[3];   // use StHFCutPredicates::eParticle
+  TOFSlot     tof[3];   // use StHFCutPredicates::eParticle
+  PairSlot    pair[2];  // use StHFCuts::ePairType
+  TripletSlot triplet;
+};
+#endif
@@ -1,5 +1,7 @@
 #include <limits>
 #include <cmath>
+#include <algorithm>
+#include <cassert>
 
 #ifdef __ROOT__
 #include "StHFCuts.h"
@@ -15,6 +17,10 @@
 
 #include "StHFPair.h"
 #include "StHFTriplet.h"
+#include "StHFTrackTable.h"
+#include "StHFDaughter.h"
+#include "StHFCutPredicates.h"
+#include "StHFPairKernel.h"
 
 ClassImp(StHFCuts)
 
@@ -56,8 +62,12 @@ StHFCuts::StHFCuts()
   mSecondaryTripletDcaDaughters31Max(std::numeric_limits<float>::max()), 
   mSecondaryTripletDecayLengthMin(std::numeric_limits<float>::min()), mSecondaryTripletDecayLengthMax(std::numeric_limits<float>::max()), 
   mSecondaryTripletCosThetaMin(std::numeric_limits<float>::min()), 
-  mSecondaryTripletMassMin(std::numeric_limits<float>::min()), mSecondaryTripletMassMax(std::numeric_limits<float>::max()) {
+  mSecondaryTripletMassMin(std::numeric_limits<float>::min()), mSecondaryTripletMassMax(std::numeric_limits<float>::max()),
+  mVertexingMode(kStraightLine), mVertexingIterations(2), mKinematicsPrecision(StHFPairKernel::kDoublePrecision),
+  mCutPredicates(NULL) {
   // -- default constructor
+
+  setCutPairOrder(kPairDcaDaughters, kPairMass, kPairDecayLength, kPairPointingAngle);
 }
 
 // _________________________________________________________
@@ -98,8 +108,41 @@ StHFCuts::StHFCuts(const Char_t *name)
   mSecondaryTripletDcaDaughters31Max(std::numeric_limits<float>::max()), 
   mSecondaryTripletDecayLengthMin(std::numeric_limits<float>::min()), mSecondaryTripletDecayLengthMax(std::numeric_limits<float>::max()), 
   mSecondaryTripletCosThetaMin(std::numeric_limits<float>::min()), 
-  mSecondaryTripletMassMin(std::numeric_limits<float>::min()), mSecondaryTripletMassMax(std::numeric_limits<float>::max()) {
+  mSecondaryTripletMassMin(std::numeric_limits<float>::min()), mSecondaryTripletMassMax(std::numeric_limits<float>::max()),
+  mVertexingMode(kStraightLine), mVertexingIterations(2), mKinematicsPrecision(StHFPairKernel::kDoublePrecision),
+  mCutPredicates(NULL) {
   // -- constructor
+
+  setCutPairOrder(kPairDcaDaughters, kPairMass, kPairDecayLength, kPairPointingAngle);
+}
+
+// _________________________________________________________
+StHFCuts::~StHFCuts() {
+  // -- destructor
+
+  delete mCutPredicates;
+}
+
+// _________________________________________________________
+void StHFCuts::setCutPairOrder(int first, int second, int third, int fourth) {
+  // -- set order of staged pair cuts, use ePairCut
+  //    every cut has to appear once, otherwise the default order is kept
+
+  int const aOrder[kPairCutMax] = {first, second, third, fourth};
+
+  int nCuts[kPairCutMax] = {0, 0, 0, 0};
+  for (unsigned int ii = 0; ii < kPairCutMax; ++ii) {
+    if (aOrder[ii] < 0 || aOrder[ii] >= kPairCutMax) 
+      return;
+    ++nCuts[aOrder[ii]];
+  }
+
+  for (unsigned int ii = 0; ii < kPairCutMax; ++ii)
+    if (nCuts[ii] != 1)
+      return;
+
+  for (unsigned int ii = 0; ii < kPairCutMax; ++ii)
+    mPairCutOrder[ii] = aOrder[ii];
 }
 
 // _________________________________________________________
@@ -149,82 +192,196 @@ bool StHFCuts::isGoodEvent(StPicoEvent const * const picoEvent, int *aEventCuts
   return isGoodEvent;
 }
 
+// _________________________________________________________
+void StHFCuts::extendEnvelope(StHFCuts const & cuts) {
+  // -- open up cuts to include also everything which passes cuts
+  //    minimum cuts take the lower, maximum cuts the higher value
+
+  mVzMax       = std::max(mVzMax, cuts.mVzMax);
+  mVzVpdVzMax  = std::max(mVzVpdVzMax, cuts.mVzVpdVzMax);
+  mTriggerWord = mTriggerWord | cuts.mTriggerWord;
+
+  mNHitsFitMax = std::min(mNHitsFitMax, cuts.mNHitsFitMax);
+  mRequireHFT  = mRequireHFT && cuts.mRequireHFT;
+
+  mTPCNSigmaPionMax   = std::max(mTPCNSigmaPionMax,   cuts.mTPCNSigmaPionMax);
+  mTOFNSigmaPionMax   = std::max(mTOFNSigmaPionMax,   cuts.mTOFNSigmaPionMax);
+  mPionPtMin          = std::min(mPionPtMin,          cuts.mPionPtMin);
+  mPionPtMax          = std::max(mPionPtMax,          cuts.mPionPtMax);
+  mPionEtaMin         = std::min(mPionEtaMin,         cuts.mPionEtaMin);
+  mPionEtaMax         = std::max(mPionEtaMax,         cuts.mPionEtaMax);
+  mPionPtTOFMin       = std::min(mPionPtTOFMin,       cuts.mPionPtTOFMin);
+  mPionPtTOFMax       = std::max(mPionPtTOFMax,       cuts.mPionPtTOFMax);
+
+  mTPCNSigmaKaonMax   = std::max(mTPCNSigmaKaonMax,   cuts.mTPCNSigmaKaonMax);
+  mTOFNSigmaKaonMax   = std::max(mTOFNSigmaKaonMax,   cuts.mTOFNSigmaKaonMax);
+  mKaonPtMin          = std::min(mKaonPtMin,          cuts.mKaonPtMin);
+  mKaonPtMax          = std::max(mKaonPtMax,          cuts.mKaonPtMax);
+  mKaonEtaMin         = std::min(mKaonEtaMin,         cuts.mKaonEtaMin);
+  mKaonEtaMax         = std::max(mKaonEtaMax,         cuts.mKaonEtaMax);
+  mKaonPtTOFMin       = std::min(mKaonPtTOFMin,       cuts.mKaonPtTOFMin);
+  mKaonPtTOFMax       = std::max(mKaonPtTOFMax,       cuts.mKaonPtTOFMax);
+
+  mTPCNSigmaProtonMax = std::max(mTPCNSigmaProtonMax, cuts.mTPCNSigmaProtonMax);
+  mTOFNSigmaProtonMax = std::max(mTOFNSigmaProtonMax, cuts.mTOFNSigmaProtonMax);
+  mProtonPtMin        = std::min(mProtonPtMin,        cuts.mProtonPtMin);
+  mProtonPtMax        = std::max(mProtonPtMax,        cuts.mProtonPtMax);
+  mProtonEtaMin       = std::min(mProtonEtaMin,       cuts.mProtonEtaMin);
+  mProtonEtaMax       = std::max(mProtonEtaMax,       cuts.mProtonEtaMax);
+  mProtonPtTOFMin     = std::min(mProtonPtTOFMin,     cuts.mProtonPtTOFMin);
+  mProtonPtTOFMax     = std::max(mProtonPtTOFMax,     cuts.mProtonPtTOFMax);
+
+  mSecondaryPairDcaDaughtersMax = std::max(mSecondaryPairDcaDaughtersMax, cuts.mSecondaryPairDcaDaughtersMax);
+  mSecondaryPairDecayLengthMin  = std::min(mSecondaryPairDecayLengthMin,  cuts.mSecondaryPairDecayLengthMin);
+  mSecondaryPairDecayLengthMax  = std::max(mSecondaryPairDecayLengthMax,  cuts.mSecondaryPairDecayLengthMax);
+  mSecondaryPairCosThetaMin     = std::min(mSecondaryPairCosThetaMin,     cuts.mSecondaryPairCosThetaMin);
+  mSecondaryPairMassMin         = std::min(mSecondaryPairMassMin,         cuts.mSecondaryPairMassMin);
+  mSecondaryPairMassMax         = std::max(mSecondaryPairMassMax,         cuts.mSecondaryPairMassMax);
+
+  mTertiaryPairDcaDaughtersMax  = std::max(mTertiaryPairDcaDaughtersMax,  cuts.mTertiaryPairDcaDaughtersMax);
+  mTertiaryPairDecayLengthMin   = std::min(mTertiaryPairDecayLengthMin,   cuts.mTertiaryPairDecayLengthMin);
+  mTertiaryPairDecayLengthMax   = std::max(mTertiaryPairDecayLengthMax,   cuts.mTertiaryPairDecayLengthMax);
+  mTertiaryPairCosThetaMin      = std::min(mTertiaryPairCosThetaMin,      cuts.mTertiaryPairCosThetaMin);
+  mTertiaryPairMassMin          = std::min(mTertiaryPairMassMin,          cuts.mTertiaryPairMassMin);
+  mTertiaryPairMassMax          = std::max(mTertiaryPairMassMax,          cuts.mTertiaryPairMassMax);
+
+  mSecondaryTripletDcaDaughters12Max = std::max(mSecondaryTripletDcaDaughters12Max, cuts.mSecondaryTripletDcaDaughters12Max);
+  mSecondaryTripletDcaDaughters23Max = std::max(mSecondaryTripletDcaDaughters23Max, cuts.mSecondaryTripletDcaDaughters23Max);
+  mSecondaryTripletDcaDaughters31Max = std::max(mSecondaryTripletDcaDaughters31Max, cuts.mSecondaryTripletDcaDaughters31Max);
+  mSecondaryTripletDecayLengthMin    = std::min(mSecondaryTripletDecayLengthMin,    cuts.mSecondaryTripletDecayLengthMin);
+  mSecondaryTripletDecayLengthMax    = std::max(mSecondaryTripletDecayLengthMax,    cuts.mSecondaryTripletDecayLengthMax);
+  mSecondaryTripletCosThetaMin       = std::min(mSecondaryTripletCosThetaMin,       cuts.mSecondaryTripletCosThetaMin);
+  mSecondaryTripletMassMin           = std::min(mSecondaryTripletMassMin,           cuts.mSecondaryTripletMassMin);
+  mSecondaryTripletMassMax           = std::max(mSecondaryTripletMassMax,           cuts.mSecondaryTripletMassMax);
+
+  // -- vertexing mode and precision are not cuts, the ones of this cut set are used to build the candidates
+
+  resetCutPredicates();
+}
+
+// _________________________________________________________
+void StHFCuts::finalize() {
+  // -- build the predicates specialised on the bounds which are set, 
+  //    with the bounds captured. Call after the last setter, 
+  //    before the cuts are used or shared between threads
+
+  delete mCutPredicates;
+  mCutPredicates = new StHFCutPredicateSet(*this);
+}
+
+// _________________________________________________________
+StHFCutPredicateSet const & StHFCuts::cutPredicates() const {
+  assert(mCutPredicates && "StHFCuts::finalize() has to be called after setting the cuts");
+  return *mCutPredicates;
+}
+
+// _________________________________________________________
+void StHFCuts::resetCutPredicates() {
+  // -- bounds have changed, predicates are built again in finalize()
+  delete mCutPredicates;
+  mCutPredicates = NULL;
+}
+
 // _________________________________________________________
 bool StHFCuts::isGoodTrack(StPicoTrack const * const trk) const {
   // -- require at least one hit on every layer of PXL and IST.
-  return ((!mRequireHFT || trk->isHFTTrack()) && 
-	  trk->nHitsFit() >= mNHitsFitMax);
+  return passTrackCuts(trk->isHFTTrack(), trk->nHitsFit());
 }
 
 // _________________________________________________________
 bool StHFCuts::isTPCPion(StPicoTrack const * const trk) const {
   // -- check for good pion in TPC
-
-  return ( trk->pMom().perp() >= mPionPtMin && trk->pMom().perp() < mPionPtMax &&
-	   trk->pMom().pseudoRapidity() >= mPionEtaMin && trk->pMom().pseudoRapidity() < mPionEtaMax &&
-	   fabs(trk->nSigmaPion()) < mTPCNSigmaPionMax );
+  return passTPCCuts(StHFCutPredicates::kPion, trk->pMom().perp(), trk->pMom().pseudoRapidity(), trk->nSigmaPion());
 }
 
 // _________________________________________________________
 bool StHFCuts::isTPCKaon(StPicoTrack const * const trk) const {
   // -- check for good kaon in TPC
-
-  return ( trk->pMom().perp() >= mKaonPtMin && trk->pMom().perp() < mKaonPtMax &&
-	   trk->pMom().pseudoRapidity() >= mKaonEtaMin && trk->pMom().pseudoRapidity() < mKaonEtaMax &&
-	   fabs(trk->nSigmaKaon()) < mTPCNSigmaKaonMax );
+  return passTPCCuts(StHFCutPredicates::kKaon, trk->pMom().perp(), trk->pMom().pseudoRapidity(), trk->nSigmaKaon());
 }
 
 // _________________________________________________________
 bool StHFCuts::isTPCProton(StPicoTrack const * const trk) const {
   // -- check for good proton in TPC
-
-  return ( trk->pMom().perp() >= mProtonPtMin && trk->pMom().perp() < mProtonPtMax &&
-	   trk->pMom().pseudoRapidity() >= mProtonEtaMin && trk->pMom().pseudoRapidity() < mProtonEtaMax &&
-	   fabs(trk->nSigmaProton()) < mTPCNSigmaProtonMax );
+  return passTPCCuts(StHFCutPredicates::kProton, trk->pMom().perp(), trk->pMom().pseudoRapidity(), trk->nSigmaProton());
 }
 
 // _________________________________________________________
 bool StHFCuts::isTOFPion(StPicoTrack const *trk, float const & bTofBeta) const {
   // -- check for good pion in TOF - in a different pT range than for TPC
-
-  // TOF calculations
-  float const ptot = trk->pMom().mag();
-  float const beta_pi = ptot/sqrt(ptot*ptot+M_PION_PLUS*M_PION_PLUS);
-  float const TofPi=1/bTofBeta - 1/beta_pi;
-  return ( trk->pMom().perp() >= mPionPtTOFMin && trk->pMom().perp() < mPionPtTOFMax &&
-	   fabs(TofPi) < mTOFNSigmaPionMax );
+  return passTOFCuts(StHFCutPredicates::kPion, trk->pMom().perp(), trk->pMom().mag(), bTofBeta);
 }
 
 // _________________________________________________________
 bool StHFCuts::isTOFKaon(StPicoTrack const *trk, float const & bTofBeta) const {
   // -- check for good kaon in TOF - in a different pT range than for TPC
-
-  // -- TOF calculations
-  float const ptot = trk->pMom().mag();
-  float const beta_k = ptot/sqrt(ptot*ptot+M_KAON_PLUS*M_KAON_PLUS);
-  float const Tofk=1/bTofBeta - 1/beta_k;
-  return ( trk->pMom().perp() >= mKaonPtTOFMin && trk->pMom().perp() < mKaonPtTOFMax &&
-	   fabs(Tofk) < mTOFNSigmaKaonMax );
-
+  return passTOFCuts(StHFCutPredicates::kKaon, trk->pMom().perp(), trk->pMom().mag(), bTofBeta);
 }
 
 // _________________________________________________________
 bool StHFCuts::isTOFProton(StPicoTrack const *trk, float const & bTofBeta) const {
   // -- check for good proton in TOF - in a different pT range than for TPC
+  return passTOFCuts(StHFCutPredicates::kProton, trk->pMom().perp(), trk->pMom().mag(), bTofBeta);
+}
+
+// _________________________________________________________
+bool StHFCuts::isGoodTrack(StHFDaughter const * const trk) const {
+  // -- same as for StPicoTrack
+  return passTrackCuts(trk->isHFTTrack(), trk->nHitsFit());
+}
+
+// _________________________________________________________
+bool StHFCuts::isTPCPion(StHFDaughter const * const trk) const {
+  return passTPCCuts(StHFCutPredicates::kPion, trk->pt(), trk->eta(), trk->nSigmaPion());
+}
+
+// _________________________________________________________
+bool StHFCuts::isTPCKaon(StHFDaughter const * const trk) const {
+  return passTPCCuts(StHFCutPredicates::kKaon, trk->pt(), trk->eta(), trk->nSigmaKaon());
+}
 
-  // -- TOF Calculations
-  float const ptot = trk->pMom().mag() ;
-  float const beta_p = ptot/sqrt(ptot*ptot+M_PROTON*M_PROTON);
-  float const Tofp=1/bTofBeta - 1/beta_p;
-  return ( trk->pMom().perp() >= mProtonPtTOFMin && trk->pMom().perp() < mProtonPtTOFMax &&
-	   fabs(Tofp) < mTOFNSigmaProtonMax );
+// _________________________________________________________
+bool StHFCuts::isTPCProton(StHFDaughter const * const trk) const {
+  return passTPCCuts(StHFCutPredicates::kProton, trk->pt(), trk->eta(), trk->nSigmaProton());
+}
+
+// _________________________________________________________
+bool StHFCuts::isTOFPion(StHFDaughter const * const trk) const {
+  // -- uses the stored TOF beta of the daughter
+  return passTOFCuts(StHFCutPredicates::kPion, trk->pt(), trk->p(), trk->tofBeta());
+}
+
+// _________________________________________________________
+bool StHFCuts::isTOFKaon(StHFDaughter const * const trk) const {
+  return passTOFCuts(StHFCutPredicates::kKaon, trk->pt(), trk->p(), trk->tofBeta());
+}
+
+// _________________________________________________________
+bool StHFCuts::isTOFProton(StHFDaughter const * const trk) const {
+  return passTOFCuts(StHFCutPredicates::kProton, trk->pt(), trk->p(), trk->tofBeta());
+}
+
+// _________________________________________________________
+bool StHFCuts::passTrackCuts(bool const isHFTTrack, int const nHitsFit) const {
+  return cutPredicates().track.pass(isHFTTrack, nHitsFit);
+}
+
+// _________________________________________________________
+bool StHFCuts::passTPCCuts(int const particle, float const pt, float const eta, float const nSigma) const {
+  // -- predicate specialised on the bounds set for this particle
+  return cutPredicates().tpc[particle].pass(pt, eta, nSigma);
+}
+
+// _________________________________________________________
+bool StHFCuts::passTOFCuts(int const particle, float const pt, float const ptot, float const bTofBeta) const {
+  return cutPredicates().tof[particle].pass(pt, ptot, bTofBeta);
 }
 
 // _________________________________________________________
 bool StHFCuts::isClosePair(StHFPair const & pair) const {
   // -- check for a pair which is close in dca w/o mass constraint,
   //    using secondary vertex cuts
-  return ( std::cos(pair.pointingAngle()) > mSecondaryPairCosThetaMin &&
+  return ( pair.cosPointingAngle() > mSecondaryPairCosThetaMin &&
 	   pair.decayLength() > mSecondaryPairDecayLengthMin && pair.decayLength() < mSecondaryPairDecayLengthMax &&
 	   pair.dcaDaughters() < mSecondaryPairDcaDaughtersMax);
 
@@ -234,32 +391,74 @@ bool StHFCuts::isClosePair(StHFPair const & pair) const {
 bool StHFCuts::isGoodSecondaryVertexPair(StHFPair const & pair) const {
   // -- check for good secondary vertex pair
 
-  return ( pair.m() > mSecondaryPairMassMin && pair.m() < mSecondaryPairMassMax &&
-	   std::cos(pair.pointingAngle()) > mSecondaryPairCosThetaMin &&
-	   pair.decayLength() > mSecondaryPairDecayLengthMin && pair.decayLength() < mSecondaryPairDecayLengthMax &&
-	   pair.dcaDaughters() < mSecondaryPairDcaDaughtersMax);
+  return isGoodSecondaryVertexPair(pair.m(), pair.cosPointingAngle(), pair.decayLength(), pair.dcaDaughters());
+}
+
+// _________________________________________________________
+bool StHFCuts::isGoodSecondaryVertexPair(float const m, float const cosPointingAngle, 
+					 float const decayLength, float const dcaDaughters) const {
+  // -- check for good secondary vertex pair, from the pair quantities
+
+  return cutPredicates().pair[kSecondaryPair].pass(m, cosPointingAngle, decayLength, dcaDaughters);
 }
 
 // _________________________________________________________
 bool StHFCuts::isGoodTertiaryVertexPair(StHFPair const & pair) const {
   // -- check for good tertiary vertex pair
 
-  return ( pair.m() > mTertiaryPairMassMin && pair.m() < mTertiaryPairMassMax &&
-	   std::cos(pair.pointingAngle()) > mTertiaryPairCosThetaMin &&
-	   pair.decayLength() > mTertiaryPairDecayLengthMin && pair.decayLength() < mTertiaryPairDecayLengthMax &&
-	   pair.dcaDaughters() < mTertiaryPairDcaDaughtersMax);
+  return cutPredicates().pair[kTertiaryPair].pass(pair.m(), pair.cosPointingAngle(), pair.decayLength(), pair.dcaDaughters());
+}
+
+// _________________________________________________________
+bool StHFCuts::isGoodSecondaryVertexPair(StHFTrackTable const & table, unsigned int row1, unsigned int row2,
+					 float p1MassHypo, float p2MassHypo, StHFPair & pair, 
+					 unsigned int * const nCutsPassed) const {
+  // -- build pair from track table, applying secondary vertex cuts in stages
+
+  return pair.createGoodPair(table, row1, row2, p1MassHypo, p2MassHypo, *this, kSecondaryPair, nCutsPassed);
+}
+
+// _________________________________________________________
+bool StHFCuts::isGoodTertiaryVertexPair(StHFTrackTable const & table, unsigned int row1, unsigned int row2,
+					float p1MassHypo, float p2MassHypo, StHFPair & pair, 
+					unsigned int * const nCutsPassed) const {
+  // -- build pair from track table, applying tertiary vertex cuts in stages
+
+  return pair.createGoodPair(table, row1, row2, p1MassHypo, p2MassHypo, *this, kTertiaryPair, nCutsPassed);
+}
+
+// _________________________________________________________
+bool StHFCuts::isGoodPairCut(int pairCut, int pairType, StHFPair const & pair) const {
+  // -- check single pair cut (ePairCut) for secondary or tertiary pair (ePairType)
+  //    same conditions as in isGoodSecondaryVertexPair / isGoodTertiaryVertexPair
+
+  bool const bSecondary = (pairType == kSecondaryPair);
+
+  switch (pairCut) {
+  case kPairDcaDaughters : 
+    return pair.dcaDaughters() < (bSecondary ? mSecondaryPairDcaDaughtersMax : mTertiaryPairDcaDaughtersMax);
+
+  case kPairMass : 
+    return ( pair.m() > (bSecondary ? mSecondaryPairMassMin : mTertiaryPairMassMin) && 
+	     pair.m() < (bSecondary ? mSecondaryPairMassMax : mTertiaryPairMassMax) );
+
+  case kPairDecayLength : 
+    return ( pair.decayLength() > (bSecondary ? mSecondaryPairDecayLengthMin : mTertiaryPairDecayLengthMin) && 
+	     pair.decayLength() < (bSecondary ? mSecondaryPairDecayLengthMax : mTertiaryPairDecayLengthMax) );
+
+  case kPairPointingAngle : 
+    return pair.cosPointingAngle() > (bSecondary ? mSecondaryPairCosThetaMin : mTertiaryPairCosThetaMin);
+  }
+
+  return true;
 }
 
 // _________________________________________________________
 bool StHFCuts::isGoodSecondaryVertexTriplet(StHFTriplet const & triplet) const {
   // -- check for good secondary vertex triplet
 
-  return ( triplet.m() > mSecondaryTripletMassMin && triplet.m() < mSecondaryTripletMassMax &&
-	   std::cos(triplet.pointingAngle()) > mSecondaryTripletCosThetaMin &&
-	   triplet.decayLength() > mSecondaryTripletDecayLengthMin && triplet.decayLength() < mSecondaryTripletDecayLengthMax &&
-	   triplet.dcaDaughters12() < mSecondaryTripletDcaDaughters12Max &&
-	   triplet.dcaDaughters23() < mSecondaryTripletDcaDaughters23Max &&
-	   triplet.dcaDaughters31() < mSecondaryTripletDcaDaughters31Max);
+  return cutPredicates().triplet.pass(triplet.m(), triplet.cosPointingAngle(), triplet.decayLength(),
+				      triplet.dcaDaughters12(), triplet.dcaDaughters23(), triplet.dcaDaughters31());
 }
 
 #endif // __ROOT__
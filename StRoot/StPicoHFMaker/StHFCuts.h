@@ -6,6 +6,46 @@
  *  Cut class for HF analysis
  *  - Base class for cuts 
  *
+ *  - Pair cuts can be applied in stages, while the pair is built
+ *    from the track table (see StHFPair::createGoodPair):
+ *      isGoodSecondaryVertexPair(table, row1, row2, ..., pair)
+ *      isGoodTertiaryVertexPair(table, row1, row2, ..., pair)
+ *    the order of the cuts is set via setCutPairOrder(...), 
+ *    default : dcaDaughters, mass, decayLength, pointingAngle
+ *    The result is the same as building the full pair and
+ *    applying isGoodSecondaryVertexPair / isGoodTertiaryVertexPair.
+ *    nCutsPassed (optional) returns the number of cuts passed in this order
+ *
+ *  - The vertexing of pairs built in stages from the track table is set
+ *    via setVertexingMode(mode, nIterations), use eVertexingMode
+ *      kStraightLine - DCA of the straight lines at the DCA to the primary vertex (default)
+ *      kHelixRefine  - straight line DCA as seed, then nIterations Newton steps 
+ *                      on the helices of the daughters
+ *      kHelixFull    - Newton steps on the helices until the DCA is converged
+ *    the helix modes place the decay vertex of low pT daughters correctly,
+ *    at a higher cost per pair (see hfKinematicsBenchmark)
+ *
+ *  - The straight line kinematics of these pairs are calculated in double
+ *    precision (default) or float only, set via setKinematicsPrecision(precision),
+ *    use StHFPairKernel::ePrecision (kDoublePrecision, kSinglePrecision).
+ *    The helix refinement is always done in double precision
+ *
+ *  - extendEnvelope(cuts) opens all cuts up, so that everything passing
+ *    cuts passes also this cut set (used for several cut variants
+ *    in one pass, see StPicoHFMaker::addHFCutsVariant)
+ *
+ *  - Track, PID and candidate cuts are evaluated via the predicates of
+ *    StHFCutPredicates, in one branch-free expression. The predicates 
+ *    specialised on the bounds which are set are built with their bounds
+ *    in finalize() (see StHFCutPredicateSet). Call finalize() after the 
+ *    last setter and before the cuts are used, the setters discard the 
+ *    predicates. StPicoHFMaker does this in Init()
+ *
+ *  - Track and PID cuts can be applied to StPicoTrack or to the compact
+ *    daughter copy StHFDaughter (replay from candidate files), 
+ *    with the same result. The secondary pair cuts can be applied to the
+ *    pair quantities directly, for pairs which are no StHFPair (e.g. StKaonPion)
+ *
  *  Authors:  Xin Dong        (xdong@lbl.gov)
  *            Michael Lomnitz (mrlomnitz@lbl.gov)
  *            Mustafa Mustafa (mmustafa@lbl.gov)
@@ -19,21 +59,34 @@
 class StPicoTrack;
 class StPicoEvent;
 
+class StHFDaughter;
+
 class StHFPair;
 class StHFTriplet;
+class StHFTrackTable;
+
+class StHFCutPredicateSet;
 
 class StHFCuts : public TNamed
 {
  public:
   
+  enum ePairCut {kPairDcaDaughters, kPairMass, kPairDecayLength, kPairPointingAngle, kPairCutMax};
+  enum ePairType {kSecondaryPair, kTertiaryPair};
+  enum eVertexingMode {kStraightLine, kHelixRefine, kHelixFull};
+
   StHFCuts();
   StHFCuts(const Char_t *name);
-  ~StHFCuts() {;}
+  ~StHFCuts();
   
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --   
 
   bool isGoodEvent(StPicoEvent const * const event, int *aEventCuts);
 
+  void extendEnvelope(StHFCuts const & cuts);
+
+  void finalize();
+
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --   
 
   bool isGoodTrack(StPicoTrack const *trk) const;
@@ -46,14 +99,34 @@ class StHFCuts : public TNamed
   bool isTOFKaon(StPicoTrack const *trk,   float const & bTofBeta) const;
   bool isTOFProton(StPicoTrack const *trk, float const & bTofBeta) const;
 
+  bool isGoodTrack(StHFDaughter const *trk) const;
+
+  bool isTPCPion(StHFDaughter const *trk) const;
+  bool isTPCKaon(StHFDaughter const *trk) const;
+  bool isTPCProton(StHFDaughter const *trk) const;
+
+  bool isTOFPion(StHFDaughter const *trk) const;
+  bool isTOFKaon(StHFDaughter const *trk) const;
+  bool isTOFProton(StHFDaughter const *trk) const;
+
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --   
 
   bool isClosePair(StHFPair const & pair) const;
 
   bool isGoodSecondaryVertexPair(StHFPair const & pair) const;
+  bool isGoodSecondaryVertexPair(float m, float cosPointingAngle, float decayLength, float dcaDaughters) const;
   bool isGoodTertiaryVertexPair(StHFPair const & pair) const;
   bool isGoodSecondaryVertexTriplet(StHFTriplet const & triplet) const;
 
+  bool isGoodSecondaryVertexPair(StHFTrackTable const & table, unsigned int row1, unsigned int row2,
+				 float p1MassHypo, float p2MassHypo, StHFPair & pair, 
+				 unsigned int * nCutsPassed = NULL) const;
+  bool isGoodTertiaryVertexPair(StHFTrackTable const & table, unsigned int row1, unsigned int row2,
+				float p1MassHypo, float p2MassHypo, StHFPair & pair, 
+				unsigned int * nCutsPassed = NULL) const;
+
+  bool isGoodPairCut(int pairCut, int pairType, StHFPair const & pair) const;
+
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --   
   
   const unsigned int&  eventStatMax()  const { return mEventStatMax; }
@@ -107,6 +180,11 @@ class StHFCuts : public TNamed
 			      float decayLengthMin, float decayLengthMax, 
 			      float cosThetaMin, float massMin, float massMax);
 
+  void setCutPairOrder(int first, int second, int third, int fourth);
+
+  void setVertexingMode(int mode, unsigned int nIterations = 2);
+  void setKinematicsPrecision(int precision);
+
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --   
   // -- GETTER for single CUTS
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- 
@@ -175,11 +253,26 @@ class StHFCuts : public TNamed
   const float&    cutSecondaryTripletMassMin()            const;
   const float&    cutSecondaryTripletMassMax()            const;
 
+  const int&      cutPairOrder(unsigned int idx)          const;
+
+  const int&          vertexingMode()                     const;
+  const unsigned int& vertexingIterations()               const;
+  const int&          kinematicsPrecision()               const;
+
  private:
   
   StHFCuts(StHFCuts const &);       
   StHFCuts& operator=(StHFCuts const &); 
 
+  // -- specialised predicates, built in finalize()
+  StHFCutPredicateSet const & cutPredicates() const;
+  void resetCutPredicates();
+
+  // -- track and PID cuts, shared by StPicoTrack and StHFDaughter
+  bool passTrackCuts(bool isHFTTrack, int nHitsFit) const;
+  bool passTPCCuts(int particle, float pt, float eta, float nSigma) const;
+  bool passTOFCuts(int particle, float pt, float ptot, float bTofBeta) const;
+
   unsigned int mEventStatMax;
 
   // -- event cuts
@@ -259,46 +352,62 @@ class StHFCuts : public TNamed
   float mSecondaryTripletMassMin;
   float mSecondaryTripletMassMax;
 
-  ClassDef(StHFCuts,1)
+  // ------------------------------------------
+  // -- Order of staged pair cuts (ePairCut)
+  // ------------------------------------------
+  int mPairCutOrder[kPairCutMax];
+
+  // ------------------------------------------
+  // -- Vertexing of staged pairs (eVertexingMode)
+  // ------------------------------------------
+  int          mVertexingMode;
+  unsigned int mVertexingIterations; // Newton steps for kHelixRefine
+  int          mKinematicsPrecision; // StHFPairKernel::ePrecision
+
+  StHFCutPredicateSet* mCutPredicates; //! specialised predicates, built in finalize()
+
+  ClassDef(StHFCuts,4)
 };
 
 inline void StHFCuts::setCutVzMax(float f)            { mVzMax            = f; }
 inline void StHFCuts::setCutVzVpdVzMax(float f)       { mVzVpdVzMax       = f; }
 inline void StHFCuts::setCutTriggerWord(UShort_t us)  { mTriggerWord      = us; }
 
-inline void StHFCuts::setCutNHitsFitMax(int i)        { mNHitsFitMax      = i; }
-inline void StHFCuts::setCutRequireHFT(bool b)        { mRequireHFT       = b; }
+inline void StHFCuts::setCutNHitsFitMax(int i)        { mNHitsFitMax      = i; resetCutPredicates(); }
+inline void StHFCuts::setCutRequireHFT(bool b)        { mRequireHFT       = b; resetCutPredicates(); }
 inline void StHFCuts::setCutNHitsFitnHitsMax(float f) { mNHitsFitnHitsMax = f; }
 
-inline void StHFCuts::setCutTPCNSigmaPion(float f)            { mTPCNSigmaPionMax = f; }
-inline void StHFCuts::setCutTOFNSigmaPion(float f)            { mTOFNSigmaPionMax = f; }
-inline void StHFCuts::setCutPionPt(float min, float max)      { mPionPtMin  = min; mPionPtMax  = max; }
-inline void StHFCuts::setCutPionEta(float min, float max)     { mPionEtaMin = min; mPionEtaMax = max; }
-inline void StHFCuts::setCutPionPtTOF(float min, float max)   { mPionPtTOFMin = min; mPionPtTOFMax = max; }
-inline void StHFCuts::setCutTPCNSigmaKaon(float f)            { mTPCNSigmaKaonMax = f; }
-inline void StHFCuts::setCutTOFNSigmaKaon(float f)            { mTOFNSigmaKaonMax = f; }
-inline void StHFCuts::setCutKaonPt(float min, float max)      { mKaonPtMin  = min; mKaonPtMax  = max; }
-inline void StHFCuts::setCutKaonEta(float min, float max)     { mKaonEtaMin = min; mKaonEtaMax = max; }
-inline void StHFCuts::setCutKaonPtTOF(float min, float max)   { mKaonPtTOFMin = min; mKaonPtTOFMax = max; }
-inline void StHFCuts::setCutTPCNSigmaProton(float f)          { mTPCNSigmaProtonMax = f; }
-inline void StHFCuts::setCutTOFNSigmaProton(float f)          { mTOFNSigmaProtonMax = f; }
-inline void StHFCuts::setCutProtonPt(float min, float max)    { mProtonPtMin  = min; mProtonPtMax  = max; }
-inline void StHFCuts::setCutProtonEta(float min, float max)   { mProtonEtaMin = min; mProtonEtaMax = max; }
-inline void StHFCuts::setCutProtonPtTOF(float min, float max) { mProtonPtTOFMin = min; mProtonPtTOFMax = max; }
+inline void StHFCuts::setCutTPCNSigmaPion(float f)            { mTPCNSigmaPionMax = f; resetCutPredicates(); }
+inline void StHFCuts::setCutTOFNSigmaPion(float f)            { mTOFNSigmaPionMax = f; resetCutPredicates(); }
+inline void StHFCuts::setCutPionPt(float min, float max)      { mPionPtMin  = min; mPionPtMax  = max; resetCutPredicates(); }
+inline void StHFCuts::setCutPionEta(float min, float max)     { mPionEtaMin = min; mPionEtaMax = max; resetCutPredicates(); }
+inline void StHFCuts::setCutPionPtTOF(float min, float max)   { mPionPtTOFMin = min; mPionPtTOFMax = max; resetCutPredicates(); }
+inline void StHFCuts::setCutTPCNSigmaKaon(float f)            { mTPCNSigmaKaonMax = f; resetCutPredicates(); }
+inline void StHFCuts::setCutTOFNSigmaKaon(float f)            { mTOFNSigmaKaonMax = f; resetCutPredicates(); }
+inline void StHFCuts::setCutKaonPt(float min, float max)      { mKaonPtMin  = min; mKaonPtMax  = max; resetCutPredicates(); }
+inline void StHFCuts::setCutKaonEta(float min, float max)     { mKaonEtaMin = min; mKaonEtaMax = max; resetCutPredicates(); }
+inline void StHFCuts::setCutKaonPtTOF(float min, float max)   { mKaonPtTOFMin = min; mKaonPtTOFMax = max; resetCutPredicates(); }
+inline void StHFCuts::setCutTPCNSigmaProton(float f)          { mTPCNSigmaProtonMax = f; resetCutPredicates(); }
+inline void StHFCuts::setCutTOFNSigmaProton(float f)          { mTOFNSigmaProtonMax = f; resetCutPredicates(); }
+inline void StHFCuts::setCutProtonPt(float min, float max)    { mProtonPtMin  = min; mProtonPtMax  = max; resetCutPredicates(); }
+inline void StHFCuts::setCutProtonEta(float min, float max)   { mProtonEtaMin = min; mProtonEtaMax = max; resetCutPredicates(); }
+inline void StHFCuts::setCutProtonPtTOF(float min, float max) { mProtonPtTOFMin = min; mProtonPtTOFMax = max; resetCutPredicates(); }
 
 inline void StHFCuts::setCutSecondaryPair(float dcaDaughtersMax, float decayLengthMin, float decayLengthMax, 
 					  float cosThetaMin, float massMin, float massMax)  {
   mSecondaryPairDcaDaughtersMax = dcaDaughtersMax;
   mSecondaryPairDecayLengthMin = decayLengthMin; mSecondaryPairDecayLengthMax = decayLengthMax;
   mSecondaryPairCosThetaMin = cosThetaMin;
-  mSecondaryPairMassMin = massMin; mSecondaryPairMassMax = massMax; }
+  mSecondaryPairMassMin = massMin; mSecondaryPairMassMax = massMax; 
+  resetCutPredicates(); }
 
 inline void StHFCuts::setCutTertiaryPair(float dcaDaughtersMax, float decayLengthMin, float decayLengthMax, 
 					 float cosThetaMin, float massMin, float massMax)  {
   mTertiaryPairDcaDaughtersMax = dcaDaughtersMax;
   mTertiaryPairDecayLengthMin = decayLengthMin; mTertiaryPairDecayLengthMax = decayLengthMax;
   mTertiaryPairCosThetaMin = cosThetaMin;
-  mTertiaryPairMassMin = massMin; mTertiaryPairMassMax = massMax; }
+  mTertiaryPairMassMin = massMin; mTertiaryPairMassMax = massMax; 
+  resetCutPredicates(); }
   
 inline void StHFCuts::setCutSecondaryTriplet(float dcaDaughters12Max, float dcaDaughters23Max, float dcaDaughters31Max, 
 					     float decayLengthMin, float decayLengthMax, 
@@ -307,7 +416,8 @@ inline void StHFCuts::setCutSecondaryTriplet(float dcaDaughters12Max, float dcaD
   mSecondaryTripletDcaDaughters31Max = dcaDaughters31Max; 
   mSecondaryTripletDecayLengthMin = decayLengthMin; mSecondaryTripletDecayLengthMax = decayLengthMax; 
   mSecondaryTripletCosThetaMin = cosThetaMin;
-  mSecondaryTripletMassMin = massMin; mSecondaryTripletMassMax = massMax; }
+  mSecondaryTripletMassMin = massMin; mSecondaryTripletMassMax = massMax; 
+  resetCutPredicates(); }
 
 
 inline const float&    StHFCuts::cutVzMax()                    const { return mVzMax; }
@@ -364,5 +474,16 @@ inline const float&    StHFCuts::cutSecondaryTripletCosThetaMin()        const {
 inline const float&    StHFCuts::cutSecondaryTripletMassMin()            const { return mSecondaryTripletMassMin; }
 inline const float&    StHFCuts::cutSecondaryTripletMassMax()            const { return mSecondaryTripletMassMax; }
 
+inline const int&      StHFCuts::cutPairOrder(unsigned int idx)          const { return mPairCutOrder[idx]; }
+
+inline void StHFCuts::setVertexingMode(int mode, unsigned int nIterations) { 
+  mVertexingMode = mode; mVertexingIterations = nIterations; }
+
+inline const int&          StHFCuts::vertexingMode()       const { return mVertexingMode; }
+inline const unsigned int& StHFCuts::vertexingIterations() const { return mVertexingIterations; }
+
+inline void       StHFCuts::setKinematicsPrecision(int precision) { mKinematicsPrecision = precision; }
+inline const int& StHFCuts::kinematicsPrecision() const           { return mKinematicsPrecision; }
+
 #endif
 #endif
@@ -0,0 +1,45 @@
+#include <cmath>
+
+#include "TClonesArray.h"
+
+#include "StThreeVectorF.hh"
+#include "StPicoDstMaker/StPicoTrack.h"
+
+#include "StHFDaughter.h"
+
+ClassImp(StHFDaughter)
+
+// _________________________________________________________
+StHFDaughter::StHFDaughter() : mIdx(0), mPt(0.), mEta(0.), mPhi(0.), mCharge(0), mNHitsFit(0),
+  mNSigmaPion(0.), mNSigmaKaon(0.), mNSigmaProton(0.), mTofBeta(0.), mIsHFTTrack(false) {
+}
+
+// _________________________________________________________
+StHFDaughter::StHFDaughter(StPicoTrack const & trk, unsigned short const idx, float const tofBeta) : 
+  mIdx(idx), mPt(trk.pMom().perp()), mEta(trk.pMom().pseudoRapidity()), mPhi(trk.pMom().phi()), 
+  mCharge(trk.charge()), mNHitsFit(std::abs(trk.nHitsFit())),
+  mNSigmaPion(trk.nSigmaPion()), mNSigmaKaon(trk.nSigmaKaon()), mNSigmaProton(trk.nSigmaProton()), 
+  mTofBeta(tofBeta), mIsHFTTrack(trk.isHFTTrack()) {
+}
+
+// _________________________________________________________
+StHFDaughter const * StHFDaughter::find(TClonesArray const * array, unsigned int const n, unsigned short const idx) {
+  // -- binary search of daughter with StPicoDst index idx in the first n entries
+
+  unsigned int lower = 0;
+  unsigned int upper = n;
+
+  while (lower < upper) {
+    unsigned int const middle = (lower + upper) / 2;
+    StHFDaughter const* daughter = static_cast<StHFDaughter const*>(array->UncheckedAt(middle));
+
+    if (daughter->idx() < idx)
+      lower = middle + 1;
+    else if (daughter->idx() > idx)
+      upper = middle;
+    else 
+      return daughter;
+  }
+  
+  return NULL;
+}
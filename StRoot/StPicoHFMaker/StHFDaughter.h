@@ -0,0 +1,78 @@
+#ifndef StHFDaughter_hh
+#define StHFDaughter_hh
+
+/* **************************************************
+ *  Compact copy of a daughter track of stored candidates
+ *
+ *  - holds what the track and PID cuts of StHFCuts need :
+ *      pt, eta, phi, charge, nHitsFit, nSigma (pion, kaon, proton),
+ *      TOF beta and the HFT flag
+ *  - idx() is the index of the track in the StPicoDst, the same 
+ *    as particle1Idx() ... of the candidates
+ *  - find(array, n, idx) looks up the daughter with index idx in an
+ *    array sorted by idx(), NULL if it is not there
+ *  - stored next to the candidates in kWrite (StPicoHFMaker::setStoreDaughters),
+ *    so that analyses can run on the candidate files only, without
+ *    the picoDst (StPicoHFMaker::kReplay)
+ *
+ * **************************************************
+ */
+
+#include <cmath>
+
+#include "TObject.h"
+
+class TClonesArray;
+class StPicoTrack;
+
+class StHFDaughter : public TObject
+{
+ public:
+  StHFDaughter();
+  StHFDaughter(StPicoTrack const & trk, unsigned short idx, float tofBeta);
+  ~StHFDaughter() {;}
+
+  unsigned short idx()          const;
+  float          pt()           const;
+  float          eta()          const;
+  float          phi()          const;
+  float          p()            const;
+  short          charge()       const;
+  int            nHitsFit()     const;
+  float          nSigmaPion()   const;
+  float          nSigmaKaon()   const;
+  float          nSigmaProton() const;
+  float          tofBeta()      const;
+  bool           isHFTTrack()   const;
+
+  static StHFDaughter const * find(TClonesArray const * array, unsigned int n, unsigned short idx);
+
+ private:
+  UShort_t mIdx;            // index of track in StPicoDst
+  Float_t  mPt;             // primary momentum
+  Float_t  mEta;
+  Float_t  mPhi;
+  Char_t   mCharge;
+  UChar_t  mNHitsFit;
+  Float_t  mNSigmaPion;
+  Float_t  mNSigmaKaon;
+  Float_t  mNSigmaProton;
+  Float_t  mTofBeta;        // 0 if no TOF match
+  Bool_t   mIsHFTTrack;
+
+  ClassDef(StHFDaughter, 1)
+};
+
+inline unsigned short StHFDaughter::idx()          const { return mIdx; }
+inline float          StHFDaughter::pt()           const { return mPt; }
+inline float          StHFDaughter::eta()          const { return mEta; }
+inline float          StHFDaughter::phi()          const { return mPhi; }
+inline float          StHFDaughter::p()            const { return mPt * std::cosh(mEta); }
+inline short          StHFDaughter::charge()       const { return mCharge; }
+inline int            StHFDaughter::nHitsFit()     const { return mNHitsFit; }
+inline float          StHFDaughter::nSigmaPion()   const { return mNSigmaPion; }
+inline float          StHFDaughter::nSigmaKaon()   const { return mNSigmaKaon; }
+inline float          StHFDaughter::nSigmaProton() const { return mNSigmaProton; }
+inline float          StHFDaughter::tofBeta()      const { return mTofBeta; }
+inline bool           StHFDaughter::isHFTTrack()   const { return mIsHFTTrack; }
+#endif
@@ -0,0 +1,251 @@
+#include <cmath>
+#include <algorithm>
+
+#include "StHFDirectionGrid.h"
+#include "StHFTrackTable.h"
+#include "StHFPairKernel.h"
+
+namespace {
+  double const kPi = 3.14159265358979323846;
+
+  // _________________________________________________________
+  void direction(StHFTrackTable const & table, unsigned int const row, double & theta, double & phi) {
+    // -- polar and azimuthal angle of momentum at DCA to primary vertex
+    double const px = table.px()[row];
+    double const py = table.py()[row];
+    double const pz = table.pz()[row];
+
+    theta = std::atan2(std::sqrt(px*px + py*py), pz);
+    phi   = std::atan2(py, px);
+    if (phi < 0.)
+      phi += 2.*kPi;
+  }
+}
+
+// _________________________________________________________
+StHFDirectionGrid::StHFDirectionGrid() : mNThetaBins(32), mNPhiBins(32), mTolerance(1.e-3), mDcaMax(0.),
+  mCellDcaMax(), mCellStart(), mCellPos(), mRow() {
+}
+
+// _________________________________________________________
+void StHFDirectionGrid::setBins(unsigned int const nThetaBins, unsigned int const nPhiBins) {
+  mNThetaBins = (nThetaBins > 0) ? nThetaBins : 1;
+  mNPhiBins   = (nPhiBins > 0)   ? nPhiBins   : 1;
+}
+
+// _________________________________________________________
+void StHFDirectionGrid::setup(StHFTrackTable const & table, std::vector<unsigned short> const & idxList2) {
+  // -- sort list of particles 2 into direction cells, once per event
+
+  unsigned int const nCells = mNThetaBins * mNPhiBins;
+  unsigned int const nPos   = idxList2.size();
+
+  mRow.resize(nPos);
+  mCellPos.resize(nPos);
+  mCellStart.assign(nCells + 1, 0);
+  mCellDcaMax.assign(nCells, 0.);
+  mDcaMax = 0.;
+
+  std::vector<unsigned int> cell(nPos);
+
+  for (unsigned int ii = 0; ii < nPos; ++ii) {
+    mRow[ii] = table.row(idxList2[ii]);
+
+    double theta, phi;
+    direction(table, mRow[ii], theta, phi);
+
+    unsigned int const iTheta = std::min(static_cast<unsigned int>(theta / kPi * mNThetaBins), mNThetaBins - 1);
+    unsigned int const iPhi   = std::min(static_cast<unsigned int>(phi / (2.*kPi) * mNPhiBins), mNPhiBins - 1);
+
+    cell[ii] = iTheta * mNPhiBins + iPhi;
+    ++mCellStart[cell[ii] + 1];
+
+    if (table.dca()[mRow[ii]] > mCellDcaMax[cell[ii]])
+      mCellDcaMax[cell[ii]] = table.dca()[mRow[ii]];
+
+    if (table.dca()[mRow[ii]] > mDcaMax)
+      mDcaMax = table.dca()[mRow[ii]];
+  }
+
+  for (unsigned int ii = 0; ii < nCells; ++ii)
+    mCellStart[ii + 1] += mCellStart[ii];
+
+  // -- fill cells, positions stay in increasing order within a cell
+  std::vector<unsigned int> fill(mCellStart.begin(), mCellStart.end() - 1);
+  for (unsigned int ii = 0; ii < nPos; ++ii)
+    mCellPos[fill[cell[ii]]++] = ii;
+}
+
+// _________________________________________________________
+void StHFDirectionGrid::partners(StHFTrackTable const & table, unsigned int const row1,
+				 float const dcaDaughtersMax, float const decayLengthMin, std::vector<unsigned short> & positions) const {
+  // -- fill sorted positions (in list of particles 2) of possible partners of particle 1
+
+  positions.clear();
+
+  unsigned int const nPos = mRow.size();
+  if (!nPos)
+    return;
+
+  // -- maximum angle between daughter lines, for the largest DCA of all particles 2
+  double const dcaMax = dcaDaughtersMax * (1. + mTolerance);
+  double const dca1   = table.dca()[row1];
+  double const lever  = decayLengthMin - 0.5*dcaMax - dca1;
+
+  if (lever <= 0.) {
+    positions.resize(nPos);
+    for (unsigned int ii = 0; ii < nPos; ++ii)
+      positions[ii] = ii;
+    return;
+  }
+
+  double const sinPsi = (dcaMax + dca1 + mDcaMax) / lever;
+
+  double theta, phi;
+  direction(table, row1, theta, phi);
+
+  // -- cells around both orientations of line 1, each cell only once
+  std::vector<unsigned int> cells;
+  if (sinPsi < 1.) {
+    double const psiMax = std::asin(sinPsi) * (1. + mTolerance);
+
+    addCells(theta, phi, psiMax, cells);
+    addCells(kPi - theta, phi + kPi, psiMax, cells);
+
+    std::sort(cells.begin(), cells.end());
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+  }
+  else {
+    cells.resize(mNThetaBins * mNPhiBins);
+    for (unsigned int ii = 0; ii < cells.size(); ++ii)
+      cells[ii] = ii;
+  }
+
+  // -- maximum angle with the largest DCA of the particles 2 in the cell
+  for (unsigned int ii = 0; ii < cells.size(); ++ii) {
+    unsigned int const cell = cells[ii];
+    if (mCellStart[cell] == mCellStart[cell + 1])
+      continue;
+
+    double const sinPsiCell = (dcaMax + dca1 + mCellDcaMax[cell]) / lever;
+    if (sinPsiCell < 1.) {
+      double const psiCell = std::asin(sinPsiCell) * (1. + mTolerance);
+      if (minAngle(theta, phi, cell) > psiCell && minAngle(kPi - theta, phi + kPi, cell) > psiCell)
+	continue;
+    }
+
+    for (unsigned int jj = mCellStart[cell]; jj < mCellStart[cell + 1]; ++jj)
+      positions.push_back(mCellPos[jj]);
+  }
+
+  std::sort(positions.begin(), positions.end());
+}
+
+// _________________________________________________________
+double StHFDirectionGrid::minAngle(double const theta, double phi, unsigned int const cell) const {
+  // -- lower bound of the angle between (theta, phi) and the directions in the cell
+  //      sin^2(psi/2) = sin^2(dTheta/2) + sin(theta1) sin(theta2) sin^2(dPhi/2)
+  //    with the smallest dTheta, sin(theta2) and dPhi in the cell
+
+  double const thetaBinWidth = kPi / mNThetaBins;
+  double const phiBinWidth   = 2.*kPi / mNPhiBins;
+
+  unsigned int const iTheta = cell / mNPhiBins;
+  unsigned int const iPhi   = cell % mNPhiBins;
+
+  double const thetaLo = iTheta * thetaBinWidth;
+  double const thetaHi = thetaLo + thetaBinWidth;
+
+  double const dTheta    = std::max(0., std::max(thetaLo - theta, theta - thetaHi));
+  double const sinTheta2 = std::max(0., std::min(std::sin(thetaLo), std::sin(thetaHi)));
+
+  // -- distance in phi to the center of the cell, in [0, pi]
+  double dPhi = std::fabs(std::fmod(phi - (iPhi + 0.5) * phiBinWidth, 2.*kPi));
+  if (dPhi > kPi)
+    dPhi = 2.*kPi - dPhi;
+  dPhi = std::max(0., dPhi - 0.5*phiBinWidth);
+
+  double const sinHalfTheta = std::sin(0.5*dTheta);
+  double const sinHalfPhi   = std::sin(0.5*dPhi);
+  double const sin2HalfPsi  = sinHalfTheta*sinHalfTheta + std::max(0., std::sin(theta)) * sinTheta2 * sinHalfPhi*sinHalfPhi;
+
+  return 2.*std::asin(std::sqrt(std::min(1., sin2HalfPsi)));
+}
+
+// _________________________________________________________
+void StHFDirectionGrid::addCells(double const theta, double phi, double const psiMax,
+				 std::vector<unsigned int> & cells) const {
+  // -- add all cells with directions within psiMax of (theta, phi)
+  //     - polar angle     : |theta1 - theta2| <= psi
+  //     - azimuthal angle : sqrt(sin(theta1) sin(theta2)) |sin(dPhi/2)| <= sin(psi/2)
+
+  double const thetaBinWidth = kPi / mNThetaBins;
+  double const phiBinWidth   = 2.*kPi / mNPhiBins;
+
+  double const thetaLo = std::max(0., theta - psiMax);
+  double const thetaHi = std::min(kPi, theta + psiMax);
+
+  unsigned int const iThetaLo = std::min(static_cast<unsigned int>(thetaLo / thetaBinWidth), mNThetaBins - 1);
+  unsigned int const iThetaHi = std::min(static_cast<unsigned int>(thetaHi / thetaBinWidth), mNThetaBins - 1);
+
+  double const sinTheta1 = std::sin(theta);
+  double const sinHalfPsi = std::sin(0.5*psiMax);
+
+  if (phi >= 2.*kPi)
+    phi -= 2.*kPi;
+
+  for (unsigned int iTheta = iThetaLo; iTheta <= iThetaHi; ++iTheta) {
+    // -- smallest sin(theta2) in the part of the bin within the theta range
+    double const theta0 = std::max(thetaLo, iTheta * thetaBinWidth);
+    double const theta1 = std::min(thetaHi, (iTheta + 1) * thetaBinWidth);
+    double const sinTheta2 = std::min(std::sin(theta0), std::sin(theta1));
+    double const sinProd   = sinTheta1 * sinTheta2;
+
+    int iPhiLo = 0;
+    int iPhiHi = mNPhiBins - 1;
+
+    if (sinProd > 0. && sinHalfPsi < std::sqrt(sinProd)) {
+      double const dPhi = 2.*std::asin(sinHalfPsi / std::sqrt(sinProd));
+      if (2.*dPhi < 2.*kPi) {
+	iPhiLo = static_cast<int>(std::floor((phi - dPhi) / phiBinWidth));
+	iPhiHi = static_cast<int>(std::floor((phi + dPhi) / phiBinWidth));
+	if (iPhiHi - iPhiLo >= static_cast<int>(mNPhiBins))
+	  iPhiHi = iPhiLo + mNPhiBins - 1;
+      }
+    }
+
+    for (int iPhi = iPhiLo; iPhi <= iPhiHi; ++iPhi) {
+      unsigned int const iPhiWrapped = (iPhi + static_cast<int>(mNPhiBins)) % mNPhiBins;
+      cells.push_back(iTheta * mNPhiBins + iPhiWrapped);
+    }
+  }
+}
+
+// _________________________________________________________
+unsigned int StHFDirectionGrid::verify(StHFTrackTable const & table, unsigned int const row1,
+				       float const dcaDaughtersMax, float const decayLengthMin, 
+				       std::vector<unsigned short> const & positions) const {
+  // -- calculate dcaDaughters and decayLength of all pairs which are not in positions
+  //    return the number of those passing both cuts
+
+  unsigned int nMissed = 0;
+
+  for (unsigned short ii = 0; ii < mRow.size(); ++ii) {
+    if (std::binary_search(positions.begin(), positions.end(), ii))
+      continue;
+
+    unsigned int const row2 = mRow[ii];
+    if (table.id()[row1] == table.id()[row2])
+      continue;
+
+    StHFPairKinematics kin;
+    StHFPairKernel::straightLineDca(table, row1, row2, kin);
+
+    double const decayLength = std::sqrt(double(kin.v0[0])*kin.v0[0] + double(kin.v0[1])*kin.v0[1] + double(kin.v0[2])*kin.v0[2]);
+
+    if (kin.dcaDaughters < dcaDaughtersMax && decayLength > decayLengthMin)
+      ++nMissed;
+  }
+
+  return nMissed;
+}
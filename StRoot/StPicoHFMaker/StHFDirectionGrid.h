@@ -0,0 +1,93 @@
+#ifndef StHFDirectionGrid_hh
+#define StHFDirectionGrid_hh
+
+/* **************************************************
+ *  Per-event grid of particles in direction space (theta, phi)
+ *  to prune pairs which cannot pass the dcaDaughters cut
+ *
+ *  - The list of particles 2 (e.g. mIdxPicoPions) is sorted into
+ *    (theta, phi) cells of their momentum at the DCA to the primary
+ *    vertex once per event via setup(...)
+ *  - For one particle 1, partners(...) returns the sorted positions in
+ *    the list of particles 2 in all cells which can hold a partner
+ *
+ *  A pair passing the cuts has dcaDaughters < dcaMax and a decay vertex
+ *  with decayLength > decayLengthMin. The point of closest approach on
+ *  line 1 is then at least R = decayLengthMin - dcaMax/2 away from
+ *  the primary vertex, and for the angle psi between the two lines
+ *      dcaDaughters >= (R - |o1|) * sin(psi) - |o1| - |o2|
+ *  with o1, o2 the DCA points of the tracks to the primary vertex.
+ *  This gives a maximum angle psi between the daughter lines (in both
+ *  orientations). |o2| is bounded by the largest DCA of the particles
+ *  in the cell of particle 2, so each cell has its own maximum angle.
+ *  A cell is returned if its smallest angle to line 1 is below it.
+ *
+ *  The pruning is exact, but it only starts to work for
+ *  decayLengthMin > dcaMax/2 + |o1|, e.g. for tertiary K0S or Lambda
+ *  cuts. Otherwise all particles are returned.
+ *
+ *  - verify(...) calculates dcaDaughters and decayLength of all pairs
+ *    not returned and returns how many of those pass both cuts
+ *    (has to be 0)
+ *
+ *  - Modes to be used by the makers :
+ *      kNoGrid     - brute-force loop
+ *      kGrid       - use grid
+ *      kGridVerify - use grid and verify every result
+ *
+ *  - partners(...) and verify(...) can be called from several threads
+ *    after setup(...)
+ *
+ *  - the class does not depend on STAR libraries
+ *
+ * **************************************************
+ */
+
+#include <vector>
+
+class StHFTrackTable;
+
+class StHFDirectionGrid
+{
+ public:
+  enum eGridMode {kNoGrid, kGrid, kGridVerify};
+
+  StHFDirectionGrid();
+  ~StHFDirectionGrid() {;}
+
+  void setBins(unsigned int nThetaBins, unsigned int nPhiBins);
+
+  void setup(StHFTrackTable const & table, std::vector<unsigned short> const & idxList2);
+
+  void partners(StHFTrackTable const & table, unsigned int row1,
+		float dcaDaughtersMax, float decayLengthMin, std::vector<unsigned short> & positions) const;
+
+  unsigned int verify(StHFTrackTable const & table, unsigned int row1,
+		      float dcaDaughtersMax, float decayLengthMin, std::vector<unsigned short> const & positions) const;
+
+  void  setTolerance(float f);
+  float tolerance() const;
+
+ private:
+  StHFDirectionGrid(StHFDirectionGrid const &);
+  StHFDirectionGrid& operator=(StHFDirectionGrid const &);
+
+  void   addCells(double theta, double phi, double psiMax, std::vector<unsigned int> & cells) const;
+  double minAngle(double theta, double phi, unsigned int cell) const;
+
+  unsigned int mNThetaBins;
+  unsigned int mNPhiBins;
+  float        mTolerance;     // relative widening of dcaDaughtersMax
+
+  float        mDcaMax;        // largest DCA to primary vertex of particles 2
+
+  std::vector<float>          mCellDcaMax; // largest DCA to primary vertex of particles 2, per cell
+
+  std::vector<unsigned int>   mCellStart;  // first entry of cell, size nCells + 1
+  std::vector<unsigned short> mCellPos;    // positions in list of particles 2, ordered by cell
+  std::vector<int>            mRow;        // row in track table, per position in list of particles 2
+};
+
+inline void  StHFDirectionGrid::setTolerance(float f) { mTolerance = f; }
+inline float StHFDirectionGrid::tolerance() const     { return mTolerance; }
+#endif
@@ -0,0 +1,79 @@
+#include "StHFEventArena.h"
+
+// _________________________________________________________
+StHFEventArena::StHFEventArena(size_t const initialSize) : 
+  mBlock(NULL), mSize(initialSize), mCurrent(NULL), mCurrentSize(0), mOffset(0), mOverflowBlocks(),
+  mBytesUsed(0), mNAllocations(0), mLastBytesUsed(0), mLastNAllocations(0), mLastNHeapAllocations(0),
+  mHighWaterMark(0), mNResets(0), mNEventsGrown(0) {
+  // -- constructor
+
+  if (mSize < kAlignment)
+    mSize = kAlignment;
+
+  mBlock       = new char[mSize];
+  mCurrent     = mBlock;
+  mCurrentSize = mSize;
+}
+
+// _________________________________________________________
+StHFEventArena::~StHFEventArena() {
+  // -- destructor
+
+  for (unsigned int ii = 0; ii < mOverflowBlocks.size(); ++ii)
+    delete [] mOverflowBlocks[ii];
+  delete [] mBlock;
+}
+
+// _________________________________________________________
+void* StHFEventArena::allocate(size_t const bytes) {
+  // -- take aligned memory from current block, start a new block if it is full
+
+  size_t const aligned = (bytes + kAlignment - 1) & ~static_cast<size_t>(kAlignment - 1);
+
+  if (mOffset + aligned > mCurrentSize) {
+    // -- new block, at least the size of the main block
+    mCurrentSize = aligned > mSize ? aligned : mSize;
+    mCurrent     = new char[mCurrentSize];
+    mOffset      = 0;
+    mOverflowBlocks.push_back(mCurrent);
+  }
+
+  void* memory = mCurrent + mOffset;
+  mOffset    += aligned;
+  mBytesUsed += aligned;
+  ++mNAllocations;
+
+  return memory;
+}
+
+// _________________________________________________________
+void StHFEventArena::reset() {
+  // -- release all memory of the event
+  //    replace additional blocks by one block of the high-water mark
+
+  if (mBytesUsed > mHighWaterMark)
+    mHighWaterMark = mBytesUsed;
+
+  mLastBytesUsed        = mBytesUsed;
+  mLastNAllocations     = mNAllocations;
+  mLastNHeapAllocations = mOverflowBlocks.size();
+  ++mNResets;
+
+  if (!mOverflowBlocks.empty()) {
+    ++mNEventsGrown;
+
+    for (unsigned int ii = 0; ii < mOverflowBlocks.size(); ++ii)
+      delete [] mOverflowBlocks[ii];
+    mOverflowBlocks.clear();
+
+    delete [] mBlock;
+    mSize  = mHighWaterMark;
+    mBlock = new char[mSize];
+  }
+
+  mCurrent      = mBlock;
+  mCurrentSize  = mSize;
+  mOffset       = 0;
+  mBytesUsed    = 0;
+  mNAllocations = 0;
+}
@@ -0,0 +1,96 @@
+#ifndef StHFEventArena_hh
+#define StHFEventArena_hh
+
+/* **************************************************
+ *  Arena for per-event scratch memory
+ *
+ *  - allocate<T>(n) returns uninitialized memory for n objects of 
+ *    a plain type T (indices, flags, floats), valid until reset()
+ *  - reset() releases everything at once, O(1). Called at the end of every event
+ *  - the memory block grows to the largest amount used in one event 
+ *    (high-water mark). If an event needs more, additional blocks are
+ *    allocated, at the next reset() they are replaced by one block of the 
+ *    new high-water mark. In steady state no heap allocation takes place
+ *  - statistics of the current and of the last event via 
+ *    bytesUsed(), nAllocations(), nHeapAllocations(), lastXXX()
+ *
+ * **************************************************
+ */
+
+#include <cstddef>
+#include <vector>
+
+class StHFEventArena
+{
+ public:
+  explicit StHFEventArena(size_t initialSize = 65536);
+  ~StHFEventArena();
+
+  void* allocate(size_t bytes);
+  template <class T> T* allocate(size_t n);
+  template <class T> T* allocate(size_t n, T const & value);
+
+  void reset();
+
+  // -- current event
+  size_t       bytesUsed()        const;
+  unsigned int nAllocations()     const;
+  unsigned int nHeapAllocations() const;
+
+  // -- last event before reset()
+  size_t       lastBytesUsed()        const;
+  unsigned int lastNAllocations()     const;
+  unsigned int lastNHeapAllocations() const;
+
+  // -- all events
+  size_t        capacity()      const;
+  size_t        highWaterMark() const;
+  unsigned long nResets()       const;
+  unsigned long nEventsGrown()  const;  // events (resets) which needed heap allocations
+
+ private:
+  StHFEventArena(StHFEventArena const &);
+  StHFEventArena& operator=(StHFEventArena const &);
+
+  enum {kAlignment = 16};
+
+  char*  mBlock;         // main block, size mSize
+  size_t mSize;
+  char*  mCurrent;       // block allocations are taken from
+  size_t mCurrentSize;
+  size_t mOffset;        // used bytes in mCurrent
+
+  std::vector<char*> mOverflowBlocks; // blocks allocated in this event
+
+  size_t        mBytesUsed;
+  unsigned int  mNAllocations;
+  size_t        mLastBytesUsed;
+  unsigned int  mLastNAllocations;
+  unsigned int  mLastNHeapAllocations;
+  size_t        mHighWaterMark;
+  unsigned long mNResets;
+  unsigned long mNEventsGrown;
+};
+
+template <class T> inline T* StHFEventArena::allocate(size_t n) { 
+  return static_cast<T*>(allocate(n * sizeof(T)));
+}
+
+template <class T> inline T* StHFEventArena::allocate(size_t n, T const & value) {
+  T* array = allocate<T>(n);
+  for (size_t ii = 0; ii < n; ++ii)
+    array[ii] = value;
+  return array;
+}
+
+inline size_t       StHFEventArena::bytesUsed()            const { return mBytesUsed; }
+inline unsigned int StHFEventArena::nAllocations()         const { return mNAllocations; }
+inline unsigned int StHFEventArena::nHeapAllocations()     const { return mOverflowBlocks.size(); }
+inline size_t       StHFEventArena::lastBytesUsed()        const { return mLastBytesUsed; }
+inline unsigned int StHFEventArena::lastNAllocations()     const { return mLastNAllocations; }
+inline unsigned int StHFEventArena::lastNHeapAllocations() const { return mLastNHeapAllocations; }
+inline size_t        StHFEventArena::capacity()            const { return mSize; }
+inline size_t        StHFEventArena::highWaterMark()       const { return mHighWaterMark; }
+inline unsigned long StHFEventArena::nResets()             const { return mNResets; }
+inline unsigned long StHFEventArena::nEventsGrown()        const { return mNEventsGrown; }
+#endif
@@ -0,0 +1,171 @@
+#include "TTree.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "TFile.h"
+#include "TDirectory.h"
+
+#include "StHFEventIndex.h"
+
+// _________________________________________________________
+StHFEventIndex::StHFEventIndex() : mRunIds(), mEventIds(), mSlotKeys(), mSlotEntries(), mSlotMask(0), mNDuplicates(0) {
+}
+
+// _________________________________________________________
+Long64_t StHFEventIndex::build(TTree* tree, char const* runIdName, char const* eventIdName) {
+  // -- read runId and eventId of all entries, return number of entries
+  //    only the two branches are read, one entry at a time
+
+  Long64_t const nEntries = tree->GetEntries();
+
+  mRunIds.resize(nEntries);
+  mEventIds.resize(nEntries);
+
+  TBranch* runIdBranch   = NULL;
+  TBranch* eventIdBranch = NULL;
+  TLeaf*   runIdLeaf     = NULL;
+  TLeaf*   eventIdLeaf   = NULL;
+  Int_t    treeNumber    = -1;
+
+  for (Long64_t idx = 0; idx < nEntries; ++idx) {
+    Long64_t const localEntry = tree->LoadTree(idx);
+    if (localEntry < 0) {
+      mRunIds.resize(idx);
+      mEventIds.resize(idx);
+      break;
+    }
+
+    // -- branches change with every file of a chain
+    if (tree->GetTreeNumber() != treeNumber) {
+      treeNumber = tree->GetTreeNumber();
+
+      runIdBranch   = tree->GetTree()->GetBranch(runIdName);
+      eventIdBranch = tree->GetTree()->GetBranch(eventIdName);
+      runIdLeaf     = runIdBranch   ? runIdBranch->GetLeaf(runIdName)     : NULL;
+      eventIdLeaf   = eventIdBranch ? eventIdBranch->GetLeaf(eventIdName) : NULL;
+
+      if (!runIdLeaf || !eventIdLeaf) {
+	mRunIds.resize(idx);
+	mEventIds.resize(idx);
+	break;
+      }
+    }
+
+    runIdBranch->GetEntry(localEntry);
+    eventIdBranch->GetEntry(localEntry);
+
+    mRunIds[idx]   = static_cast<Int_t>(runIdLeaf->GetValue());
+    mEventIds[idx] = static_cast<Int_t>(eventIdLeaf->GetValue());
+  }
+
+  fillTable();
+
+  return mRunIds.size();
+}
+
+// _________________________________________________________
+bool StHFEventIndex::read(char const* fileName, Long64_t const nEntries) {
+  // -- load index written by write(...), false if not available
+  //    or not made for a tree with nEntries
+
+  TDirectory* oldDir = gDirectory;
+
+  TFile* file = TFile::Open(fileName);
+  if (!file || file->IsZombie()) {
+    delete file;
+    if (oldDir) oldDir->cd();
+    return false;
+  }
+
+  bool bRead = false;
+
+  TTree* tree = static_cast<TTree*>(file->Get("hfEventIndex"));
+  if (tree && tree->GetEntries() == nEntries) {
+    Int_t runId;
+    Int_t eventId;
+    tree->SetBranchAddress("runId",   &runId);
+    tree->SetBranchAddress("eventId", &eventId);
+
+    mRunIds.resize(nEntries);
+    mEventIds.resize(nEntries);
+
+    for (Long64_t idx = 0; idx < nEntries; ++idx) {
+      tree->GetEntry(idx);
+      mRunIds[idx]   = runId;
+      mEventIds[idx] = eventId;
+    }
+
+    fillTable();
+    bRead = true;
+  }
+
+  file->Close();
+  delete file;
+  if (oldDir) oldDir->cd();
+
+  return bRead;
+}
+
+// _________________________________________________________
+bool StHFEventIndex::write(char const* fileName) const {
+  // -- save runId and eventId of all entries
+
+  TDirectory* oldDir = gDirectory;
+
+  TFile* file = new TFile(fileName, "RECREATE");
+  if (file->IsZombie()) {
+    delete file;
+    if (oldDir) oldDir->cd();
+    return false;
+  }
+
+  Int_t runId;
+  Int_t eventId;
+
+  TTree* tree = new TTree("hfEventIndex", "runId and eventId of HF tree entries");
+  tree->Branch("runId",   &runId,   "runId/I");
+  tree->Branch("eventId", &eventId, "eventId/I");
+
+  for (unsigned int idx = 0; idx < mRunIds.size(); ++idx) {
+    runId   = mRunIds[idx];
+    eventId = mEventIds[idx];
+    tree->Fill();
+  }
+
+  file->Write();
+  file->Close();
+  delete file;
+  if (oldDir) oldDir->cd();
+
+  return true;
+}
+
+// _________________________________________________________
+void StHFEventIndex::fillTable() {
+  // -- fill hash table (runId, eventId) -> entry, keep first of duplicated entries
+  //    at least twice as many slots as entries
+
+  ULong64_t nSlots = 16;
+  while (nSlots < 2 * mRunIds.size())
+    nSlots *= 2;
+
+  mSlotMask = nSlots - 1;
+  mSlotKeys.assign(nSlots, 0);
+  mSlotEntries.assign(nSlots, -1);
+  mNDuplicates = 0;
+
+  for (unsigned int idx = 0; idx < mRunIds.size(); ++idx) {
+    ULong64_t const k = key(mRunIds[idx], mEventIds[idx]);
+
+    ULong64_t ii = slot(k);
+    while (mSlotEntries[ii] >= 0 && mSlotKeys[ii] != k)
+      ii = (ii + 1) & mSlotMask;
+
+    if (mSlotEntries[ii] >= 0) {
+      ++mNDuplicates;
+      continue;
+    }
+
+    mSlotKeys[ii]    = k;
+    mSlotEntries[ii] = idx;
+  }
+}
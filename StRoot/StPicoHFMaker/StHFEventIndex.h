@@ -0,0 +1,85 @@
+#ifndef StHFEventIndex_hh
+#define StHFEventIndex_hh
+
+/* **************************************************
+ *  Index of the HF tree entries by (runId, eventId)
+ *
+ *  - used in kRead to find the HF tree entry of a picoDst event
+ *    independent of the order of the events, missing or 
+ *    filtered picoDst events are simply not looked up
+ *  - build(...) reads runId and eventId of all entries of the tree/chain
+ *    entry by entry, only these two branches are read
+ *  - write(...) saves runId and eventId of all entries in a small file,
+ *    read(...) loads it again instead of build(...) - if the number
+ *    of entries matches the chain
+ *  - entry(...) returns the tree entry, -1 if there is none
+ *    for duplicated (runId, eventId) the first entry is used.
+ *    The lookup is a hash table with open addressing (linear probing,
+ *    at most half full), i.e. O(1) per event
+ *
+ * **************************************************
+ */
+
+#include <vector>
+
+#include "Rtypes.h"
+
+class TTree;
+
+class StHFEventIndex
+{
+ public:
+  StHFEventIndex();
+  ~StHFEventIndex() {;}
+
+  Long64_t build(TTree* tree, char const* runIdName, char const* eventIdName);
+  bool     read(char const* fileName, Long64_t nEntries);
+  bool     write(char const* fileName) const;
+
+  Long64_t     entry(Int_t runId, Int_t eventId) const;
+  Long64_t     nEntries()     const;
+  unsigned int nDuplicates()  const;
+
+ private:
+  StHFEventIndex(StHFEventIndex const &);
+  StHFEventIndex& operator=(StHFEventIndex const &);
+
+  void fillTable();
+
+  static ULong64_t key(Int_t runId, Int_t eventId);
+  ULong64_t        slot(ULong64_t key) const;
+
+  std::vector<Int_t>  mRunIds;     // runId per tree entry
+  std::vector<Int_t>  mEventIds;   // eventId per tree entry
+
+  std::vector<ULong64_t> mSlotKeys;    // hash table : (runId, eventId) of slot
+  std::vector<Long64_t>  mSlotEntries; // hash table : tree entry of slot, -1 if empty
+  ULong64_t    mSlotMask;              // number of slots - 1, number of slots is a power of 2
+  unsigned int mNDuplicates;
+};
+
+inline Long64_t     StHFEventIndex::nEntries()    const { return mRunIds.size(); }
+inline unsigned int StHFEventIndex::nDuplicates() const { return mNDuplicates; }
+
+inline ULong64_t StHFEventIndex::key(Int_t runId, Int_t eventId) {
+  return (static_cast<ULong64_t>(static_cast<UInt_t>(runId)) << 32) | static_cast<UInt_t>(eventId);
+}
+
+inline ULong64_t StHFEventIndex::slot(ULong64_t key) const {
+  // -- multiplicative hash, high bits are mixed into the low ones
+  key *= 0x9E3779B97F4A7C15ULL;
+  return (key ^ (key >> 29)) & mSlotMask;
+}
+
+inline Long64_t StHFEventIndex::entry(Int_t runId, Int_t eventId) const {
+  if (mSlotEntries.empty())
+    return -1;
+
+  ULong64_t const k = key(runId, eventId);
+  for (ULong64_t ii = slot(k); mSlotEntries[ii] >= 0; ii = (ii + 1) & mSlotMask) {
+    if (mSlotKeys[ii] == k)
+      return mSlotEntries[ii];
+  }
+  return -1;
+}
+#endif
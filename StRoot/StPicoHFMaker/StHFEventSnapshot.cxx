@@ -0,0 +1,29 @@
+#include "StHFEventSnapshot.h"
+
+// _________________________________________________________
+StHFEventSnapshot::StHFEventSnapshot() : mEvent(), mTracks(), mTofBeta(), mIsValid() {
+}
+
+// _________________________________________________________
+void StHFEventSnapshot::reset(StPicoEvent const & event, unsigned int const nTracks) {
+  // -- start copy of a new event, memory of previous events is reused
+
+  mEvent = event;
+
+  mTracks.clear();
+  mTofBeta.clear();
+  mIsValid.clear();
+
+  mTracks.reserve(nTracks);
+  mTofBeta.reserve(nTracks);
+  mIsValid.reserve(nTracks);
+}
+
+// _________________________________________________________
+void StHFEventSnapshot::addTrack(StPicoTrack const * const trk, float const tofBeta) {
+  // -- add copy of next track, keep StPicoDst index also for missing tracks
+
+  mTracks.push_back(trk ? *trk : StPicoTrack());
+  mTofBeta.push_back(tofBeta);
+  mIsValid.push_back(trk != NULL);
+}
@@ -0,0 +1,52 @@
+#ifndef StHFEventSnapshot_hh
+#define StHFEventSnapshot_hh
+
+/* **************************************************
+ *  Copy of the StPicoDst content needed to process one
+ *  event in a worker thread of StPicoHFMaker
+ *
+ *  - the StPicoEvent and all tracks are copied, together
+ *    with the TOF beta of the tracks
+ *  - the copy stays valid while StPicoDstMaker reads the
+ *    next events
+ *
+ * **************************************************
+ */
+
+#include <vector>
+
+#include "StPicoDstMaker/StPicoEvent.h"
+#include "StPicoDstMaker/StPicoTrack.h"
+
+class StHFEventSnapshot
+{
+ public:
+  StHFEventSnapshot();
+  ~StHFEventSnapshot() {;}
+
+  void reset(StPicoEvent const & event, unsigned int nTracks);
+  void addTrack(StPicoTrack const * trk, float tofBeta);
+
+  StPicoEvent       * event();
+  StPicoTrack const * track(unsigned int idx) const;
+  float               tofBeta(unsigned int idx) const;
+  unsigned int        numberOfTracks() const;
+
+ private:
+  StHFEventSnapshot(StHFEventSnapshot const &);
+  StHFEventSnapshot& operator=(StHFEventSnapshot const &);
+
+  StPicoEvent              mEvent;
+  std::vector<StPicoTrack> mTracks;
+  std::vector<float>       mTofBeta;
+  std::vector<bool>        mIsValid;  // false for tracks missing in StPicoDst
+};
+
+inline StPicoEvent * StHFEventSnapshot::event()               { return &mEvent; }
+inline float         StHFEventSnapshot::tofBeta(unsigned int idx) const { return mTofBeta[idx]; }
+inline unsigned int  StHFEventSnapshot::numberOfTracks() const { return mTracks.size(); }
+
+inline StPicoTrack const * StHFEventSnapshot::track(unsigned int idx) const {
+  return (idx < mTracks.size() && mIsValid[idx]) ? &mTracks[idx] : NULL;
+}
+#endif
@@ -0,0 +1,86 @@
+#include <cmath>
+
+#include "StHFHelixF.h"
+#include "StHFTrackTable.h"
+#include "StHFPairKernel.h"
+
+// _________________________________________________________
+StHFHelixF::StHFHelixF() : mPMag(0.f), mOmega(0.f) {
+  for (int ii = 0; ii < 3; ++ii) {
+    mOrigin[ii]    = 0.f;
+    mDirection[ii] = 0.f;
+    mMomentum[ii]  = 0.f;
+  }
+}
+
+// _________________________________________________________
+StHFHelixF::StHFHelixF(StHFTrackTable const & table, unsigned int const row) {
+  set(table, row);
+}
+
+// _________________________________________________________
+void StHFHelixF::set(StHFTrackTable const & table, unsigned int const row) {
+  // -- load row of the track table
+
+  mMomentum[0] = table.px()[row];
+  mMomentum[1] = table.py()[row];
+  mMomentum[2] = table.pz()[row];
+  mPMag = std::sqrt(mMomentum[0]*mMomentum[0] + mMomentum[1]*mMomentum[1] + mMomentum[2]*mMomentum[2]);
+
+  float const pMagI = 1.f / mPMag;
+  mDirection[0] = mMomentum[0] * pMagI;
+  mDirection[1] = mMomentum[1] * pMagI;
+  mDirection[2] = mMomentum[2] * pMagI;
+
+  mOrigin[0] = table.dcaX()[row];
+  mOrigin[1] = table.dcaY()[row];
+  mOrigin[2] = table.dcaZ()[row];
+
+  mOmega = -StHFPairKernel::cLight * table.charge()[row] * table.bField() * pMagI;
+}
+
+// _________________________________________________________
+void StHFHelixF::pathLengths(StHFHelixF const & helix2, float & s1, float & s2) const {
+  // -- path lengths at DCA of the two straight lines
+
+  float const * const a1 = mDirection;
+  float const * const a2 = helix2.mDirection;
+
+  float const dvx = helix2.mOrigin[0] - mOrigin[0];
+  float const dvy = helix2.mOrigin[1] - mOrigin[1];
+  float const dvz = helix2.mOrigin[2] - mOrigin[2];
+
+  float const ab = a1[0]*a2[0] + a1[1]*a2[1] + a1[2]*a2[2];
+  float const g  = dvx*a1[0] + dvy*a1[1] + dvz*a1[2];
+  float const k  = dvx*a2[0] + dvy*a2[1] + dvz*a2[2];
+
+  float const cx  = a1[1]*a2[2] - a1[2]*a2[1];
+  float const cy  = a1[2]*a2[0] - a1[0]*a2[2];
+  float const cz  = a1[0]*a2[1] - a1[1]*a2[0];
+  float const den = cx*cx + cy*cy + cz*cz;
+
+  s2 = (ab*g - k) / den;
+  s1 = g + s2*ab;
+}
+
+// _________________________________________________________
+void StHFHelixF::pointAt(float const s, float * const x) const {
+  // -- point on the straight line
+
+  x[0] = mOrigin[0] + s*mDirection[0];
+  x[1] = mOrigin[1] + s*mDirection[1];
+  x[2] = mOrigin[2] + s*mDirection[2];
+}
+
+// _________________________________________________________
+void StHFHelixF::momentumAt(float const s, float * const p) const {
+  // -- rotate transverse momentum along the helix, pz is unchanged
+
+  float const phi = mOmega * s;
+  float const c   = std::cos(phi);
+  float const sn  = std::sin(phi);
+
+  p[0] = mMomentum[0]*c - mMomentum[1]*sn;
+  p[1] = mMomentum[0]*sn + mMomentum[1]*c;
+  p[2] = mMomentum[2];
+}
@@ -0,0 +1,62 @@
+#ifndef StHFHelixF_hh
+#define StHFHelixF_hh
+
+/* **************************************************
+ *  Lightweight single precision helix of a track, for the
+ *  float kinematics path of StHFPairKernel
+ *
+ *  - loaded from one row of StHFTrackTable via set(table, row) :
+ *     - origin    : point of DCA to the primary vertex,
+ *                   relative to the primary vertex
+ *     - direction : unit vector of the momentum at the origin
+ *     - momentum  : momentum at the origin and its magnitude
+ *     - omega     : turning angle of the transverse momentum per
+ *                   unit path length, -c_light * q * B / |p|
+ *
+ *  - pathLengths(helix2, s1, s2) : path lengths at the DCA of the
+ *    straight lines of both tracks (see StHelix::pathLengths)
+ *  - pointAt(s, x)    : point on the straight line at path length s
+ *  - momentumAt(s, p) : momentum rotated along the helix by s
+ *
+ *  - all calculations in float, 1 - (a1.a2)^2 of the path lengths
+ *    is calculated as |a1 x a2|^2, which is stable in single precision
+ *  - the class does not depend on STAR libraries
+ *
+ * **************************************************
+ */
+
+class StHFTrackTable;
+
+class StHFHelixF
+{
+ public:
+  StHFHelixF();
+  StHFHelixF(StHFTrackTable const & table, unsigned int row);
+  ~StHFHelixF() {;}
+
+  void set(StHFTrackTable const & table, unsigned int row);
+
+  void pathLengths(StHFHelixF const & helix2, float & s1, float & s2) const;
+  void pointAt(float s, float * x) const;
+  void momentumAt(float s, float * p) const;
+
+  float const * origin()    const;
+  float const * direction() const;
+  float const * momentum()  const;
+  float         pMag()      const;
+  float         omega()     const;
+
+ private:
+  float mOrigin[3];
+  float mDirection[3];
+  float mMomentum[3];
+  float mPMag;
+  float mOmega;
+};
+
+inline float const * StHFHelixF::origin()    const { return mOrigin; }
+inline float const * StHFHelixF::direction() const { return mDirection; }
+inline float const * StHFHelixF::momentum()  const { return mMomentum; }
+inline float         StHFHelixF::pMag()      const { return mPMag; }
+inline float         StHFHelixF::omega()     const { return mOmega; }
+#endif
@@ -0,0 +1,192 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <utility>
+
+#include "StHFMassWindowFilter.h"
+#include "StHFTrackTable.h"
+#include "StHFPairKernel.h"
+
+namespace {
+  // _________________________________________________________
+  double momentum(StHFTrackTable const & table, unsigned int const row) {
+    double const px = table.px()[row];
+    double const py = table.py()[row];
+    double const pz = table.pz()[row];
+    return std::sqrt(px*px + py*py + pz*pz);
+  }
+
+  // _________________________________________________________
+  // -- pair mass squared for |p1|, |p2| and angle 0 (sign = -1) or pi (sign = +1)
+  struct MassBound
+  {
+    double m1Sq, m2Sq, p1, e1, sign;
+
+    double operator()(double const p2) const {
+      return m1Sq + m2Sq + 2.*(e1*std::sqrt(p2*p2 + m2Sq) + sign*p1*p2);
+    }
+  };
+
+  // _________________________________________________________
+  // -- first index in [first, last) for which pred is true,
+  //    pred has to be false for all indices before and true for all after
+  template <class Pred>
+  unsigned int firstTrue(std::vector<double> const & p, unsigned int first, unsigned int last, Pred const & pred) {
+    while (first < last) {
+      unsigned int const mid = first + (last - first) / 2;
+      if (pred(p[mid]))
+	last = mid;
+      else
+	first = mid + 1;
+    }
+    return first;
+  }
+
+  // _________________________________________________________
+  struct IsAbove
+  {
+    MassBound bound;
+    double    limit;
+    bool operator()(double const p2) const { return bound(p2) > limit; }
+  };
+
+  struct IsAtOrAbove
+  {
+    MassBound bound;
+    double    limit;
+    bool operator()(double const p2) const { return bound(p2) >= limit; }
+  };
+
+  struct IsAtOrBelow
+  {
+    MassBound bound;
+    double    limit;
+    bool operator()(double const p2) const { return bound(p2) <= limit; }
+  };
+}
+
+// _________________________________________________________
+StHFMassWindowFilter::StHFMassWindowFilter() : mMass2(0.), mTolerance(1.e-4), mP(), mRow(), mPos() {
+}
+
+// _________________________________________________________
+void StHFMassWindowFilter::setup(StHFTrackTable const & table, std::vector<unsigned short> const & idxList2,
+				 float const mass2) {
+  // -- sort list of particles 2 by |p|, once per event
+
+  mMass2 = mass2;
+
+  std::vector<std::pair<double, unsigned short> > sorted;
+  sorted.reserve(idxList2.size());
+
+  for (unsigned short ii = 0; ii < idxList2.size(); ++ii)
+    sorted.push_back(std::make_pair(momentum(table, table.row(idxList2[ii])), ii));
+
+  std::sort(sorted.begin(), sorted.end());
+
+  mP.resize(sorted.size());
+  mRow.resize(sorted.size());
+  mPos.resize(sorted.size());
+
+  for (unsigned int ii = 0; ii < sorted.size(); ++ii) {
+    mP[ii]   = sorted[ii].first;
+    mPos[ii] = sorted[ii].second;
+    mRow[ii] = table.row(idxList2[sorted[ii].second]);
+  }
+}
+
+// _________________________________________________________
+void StHFMassWindowFilter::partners(StHFTrackTable const & table, unsigned int const row1, float const mass1,
+				    float const massMin, float const massMax, std::vector<unsigned short> & positions) const {
+  // -- fill sorted positions (in list of particles 2) of possible partners of particle 1
+
+  positions.clear();
+
+  unsigned int const nP = mP.size();
+  if (!nP)
+    return;
+
+  // -- widened mass window, squared
+  double const lo   = massMin * (1. - mTolerance);
+  double const hi   = massMax * (1. + mTolerance);
+  double const loSq = (lo > 0.) ? lo*lo : 0.;
+  double const hiSq = hi*hi;
+
+  double const p1 = momentum(table, row1);
+
+  MassBound bound;
+  bound.m1Sq = double(mass1)*mass1;
+  bound.m2Sq = double(mMass2)*mMass2;
+  bound.p1   = p1;
+  bound.e1   = std::sqrt(p1*p1 + bound.m1Sq);
+
+  // -- m_max >= lo : m_max is increasing with |p2|
+  IsAtOrAbove maxAboveLo;
+  maxAboveLo.bound      = bound;
+  maxAboveLo.bound.sign = 1.;
+  maxAboveLo.limit      = loSq;
+  unsigned int const iMaxLo = firstTrue(mP, 0, nP, maxAboveLo);
+
+  // -- m_min <= hi : m_min is decreasing below |p2| = |p1| * m2 / m1 and increasing above
+  double const pTurn = (mass1 > 0.) ? p1 * mMass2 / mass1 : std::numeric_limits<double>::max();
+  unsigned int const iTurn = std::lower_bound(mP.begin(), mP.end(), pTurn) - mP.begin();
+
+  IsAtOrBelow minBelowHi;
+  minBelowHi.bound      = bound;
+  minBelowHi.bound.sign = -1.;
+  minBelowHi.limit      = hiSq;
+  unsigned int const iMinFirst = firstTrue(mP, 0, iTurn, minBelowHi);
+
+  IsAbove minAboveHi;
+  minAboveHi.bound      = bound;
+  minAboveHi.bound.sign = -1.;
+  minAboveHi.limit      = hiSq;
+  unsigned int const iMinLast = firstTrue(mP, iTurn, nP, minAboveHi);
+
+  unsigned int const first = std::max(iMaxLo, iMinFirst);
+  unsigned int const last  = iMinLast;
+
+  for (unsigned int ii = first; ii < last; ++ii)
+    positions.push_back(mPos[ii]);
+
+  std::sort(positions.begin(), positions.end());
+}
+
+// _________________________________________________________
+unsigned int StHFMassWindowFilter::verify(StHFTrackTable const & table, unsigned int const row1, float const mass1,
+					  float const massMin, float const massMax,
+					  std::vector<unsigned short> const & positions) const {
+  // -- calculate mass of all pairs which are not in positions
+  //    return the number of those inside the mass window
+
+  unsigned int nMissed = 0;
+
+  double const m1Sq = double(mass1)*mass1;
+  double const m2Sq = double(mMass2)*mMass2;
+
+  for (unsigned int ii = 0; ii < mP.size(); ++ii) {
+    if (std::binary_search(positions.begin(), positions.end(), mPos[ii]))
+      continue;
+
+    unsigned int const row2 = mRow[ii];
+    if (table.id()[row1] == table.id()[row2])
+      continue;
+
+    StHFPairKinematics kin;
+    StHFPairKernel::straightLinePair(table, row1, row2, kin);
+
+    double const p1Sq = double(kin.p1Mom[0])*kin.p1Mom[0] + double(kin.p1Mom[1])*kin.p1Mom[1] + double(kin.p1Mom[2])*kin.p1Mom[2];
+    double const p2Sq = double(kin.p2Mom[0])*kin.p2Mom[0] + double(kin.p2Mom[1])*kin.p2Mom[1] + double(kin.p2Mom[2])*kin.p2Mom[2];
+    double const px   = double(kin.p1Mom[0]) + kin.p2Mom[0];
+    double const py   = double(kin.p1Mom[1]) + kin.p2Mom[1];
+    double const pz   = double(kin.p1Mom[2]) + kin.p2Mom[2];
+    double const e    = std::sqrt(p1Sq + m1Sq) + std::sqrt(p2Sq + m2Sq);
+    double const mSq  = e*e - px*px - py*py - pz*pz;
+    double const m    = (mSq > 0.) ? std::sqrt(mSq) : 0.;
+
+    if (m > massMin && m < massMax)
+      ++nMissed;
+  }
+
+  return nMissed;
+}
@@ -0,0 +1,75 @@
+#ifndef StHFMassWindowFilter_hh
+#define StHFMassWindowFilter_hh
+
+/* **************************************************
+ *  Pre-filter of pair combinatorics using the invariant mass window
+ *
+ *  - The list of particles 2 (e.g. mIdxPicoPions) is sorted by |p|
+ *    once per event via setup(...)
+ *  - For one particle 1, partners(...) returns the positions in the
+ *    list of particles 2 which can form a pair inside the mass window.
+ *    The positions are sorted, so the pairs are created in the same
+ *    order as in the brute-force loop over the full list
+ *
+ *  The rotation of the momenta to the DCA point keeps |p| of the 
+ *  daughters, so for fixed |p1| the pair mass is bounded by
+ *      m_min(|p2|) : parallel daughters
+ *      m_max(|p2|) : back-to-back daughters
+ *  m_max is increasing with |p2|, m_min is convex with its minimum at
+ *  |p2| = |p1| * m2 / m1. Both conditions together select one continuous 
+ *  range in the sorted list, found by binary search.
+ *  The window is widened by a relative tolerance to account for the 
+ *  single precision of the pair mass.
+ *
+ *  - verify(...) calculates the mass of all pairs outside the returned 
+ *    range and returns how many of those are inside the mass window
+ *    (has to be 0)
+ *
+ *  - Modes to be used by the makers : 
+ *      kNoMassFilter     - brute-force loop
+ *      kMassFilter       - use pre-filter
+ *      kMassFilterVerify - use pre-filter and verify every result
+ *
+ *  - the class does not depend on STAR libraries
+ *
+ * **************************************************
+ */
+
+#include <vector>
+
+class StHFTrackTable;
+
+class StHFMassWindowFilter
+{
+ public:
+  enum eMassFilterMode {kNoMassFilter, kMassFilter, kMassFilterVerify};
+
+  StHFMassWindowFilter();
+  ~StHFMassWindowFilter() {;}
+
+  void setup(StHFTrackTable const & table, std::vector<unsigned short> const & idxList2, float mass2);
+
+  void partners(StHFTrackTable const & table, unsigned int row1, float mass1, 
+		float massMin, float massMax, std::vector<unsigned short> & positions) const;
+
+  unsigned int verify(StHFTrackTable const & table, unsigned int row1, float mass1, 
+		      float massMin, float massMax, std::vector<unsigned short> const & positions) const;
+
+  void  setTolerance(float f);
+  float tolerance() const;
+
+ private:
+  StHFMassWindowFilter(StHFMassWindowFilter const &);
+  StHFMassWindowFilter& operator=(StHFMassWindowFilter const &);
+
+  float                       mMass2;     // mass hypothesis of particles 2
+  float                       mTolerance; // relative widening of the mass window
+
+  std::vector<double>         mP;         // |p| of particles 2, sorted
+  std::vector<int>            mRow;       // row in track table, sorted by |p|
+  std::vector<unsigned short> mPos;       // position in the list of particles 2, sorted by |p|
+};
+
+inline void  StHFMassWindowFilter::setTolerance(float f) { mTolerance = f; }
+inline float StHFMassWindowFilter::tolerance() const     { return mTolerance; }
+#endif
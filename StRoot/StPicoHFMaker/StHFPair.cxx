@@ -9,11 +9,18 @@
 #include "SystemOfUnits.h"
 #include "StPicoDstMaker/StPicoTrack.h"
 
+#include "StHFTrackCache.h"
+#include "StHFCascadeV0.h"
+#include "StHFTrackTable.h"
+#include "StHFPairKernel.h"
+#include "StHFHelixF.h"
+#include "StHFCuts.h"
+
 ClassImp(StHFPair)
 
 // _________________________________________________________
 StHFPair::StHFPair(): mLorentzVector(StLorentzVectorF()),
-  mPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+  mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
   mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()),
   mParticle1Idx(std::numeric_limits<unsigned short>::max()), mParticle2Idx(std::numeric_limits<unsigned short>::max()),
   mDcaDaughters(std::numeric_limits<float>::max()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN()),
@@ -22,7 +29,7 @@ StHFPair::StHFPair(): mLorentzVector(StLorentzVectorF()),
 
 // _________________________________________________________
 StHFPair::StHFPair(StHFPair const * t) : mLorentzVector(t->mLorentzVector),
-   mPointingAngle(t->mPointingAngle), mDecayLength(t->mDecayLength),
+   mCosPointingAngle(t->mCosPointingAngle), mDecayLength(t->mDecayLength),
    mParticle1Dca(t->mParticle1Dca), mParticle2Dca(t->mParticle2Dca),
    mParticle1Idx(t->mParticle1Idx), mParticle2Idx(t->mParticle2Idx),
    mDcaDaughters(t->mDcaDaughters), mCosThetaStar(t->mCosThetaStar),
@@ -34,35 +41,274 @@ StHFPair::StHFPair(StPicoTrack const * const particle1, StPicoTrack const * cons
 		   float p1MassHypo, float p2MassHypo, unsigned short const p1Idx, unsigned short const p2Idx,
 		   StThreeVectorF const & vtx, float const bField) : 
   mLorentzVector(StLorentzVectorF()),
-  mPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+  mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
   mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()),
   mParticle1Idx(p1Idx), mParticle2Idx(p2Idx),
   mDcaDaughters(std::numeric_limits<float>::max()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN()),
   mV0x(std::numeric_limits<float>::max()), mV0y(std::numeric_limits<float>::max()),  mV0z(std::numeric_limits<float>::max()) {
   // -- Create pair out of 2 tracks
+
+  if ((!particle1 || !particle2) || (particle1->id() == particle2->id())) {
+    mParticle1Idx = std::numeric_limits<unsigned short>::max();
+    mParticle2Idx = std::numeric_limits<unsigned short>::max();
+    return;
+  }
+
+  StHFCachedTrack const p1(particle1, p1Idx, vtx, bField);
+  StHFCachedTrack const p2(particle2, p2Idx, vtx, bField);
+
+  createPair(p1, p2, p1MassHypo, p2MassHypo, vtx, bField);
+}
+
+// _________________________________________________________
+StHFPair::StHFPair(StHFCachedTrack const & particle1, StHFCachedTrack const & particle2,
+		   float p1MassHypo, float p2MassHypo,
+		   StThreeVectorF const & vtx, float const bField) : 
+  mLorentzVector(StLorentzVectorF()),
+  mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Idx(particle1.idx()), mParticle2Idx(particle2.idx()),
+  mDcaDaughters(std::numeric_limits<float>::max()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN()),
+  mV0x(std::numeric_limits<float>::max()), mV0y(std::numeric_limits<float>::max()),  mV0z(std::numeric_limits<float>::max()) {
+  // -- Create pair out of 2 cached tracks
+
+  if (particle1.id() == particle2.id()) {
+    mParticle1Idx = std::numeric_limits<unsigned short>::max();
+    mParticle2Idx = std::numeric_limits<unsigned short>::max();
+    return;
+  }
+
+  createPair(particle1, particle2, p1MassHypo, p2MassHypo, vtx, bField);
+}
+
+// _________________________________________________________
+StHFPair::StHFPair(StPicoTrack const * const particle1, StHFPair const * const particle2,
+		   float p1MassHypo, float p2MassHypo, unsigned short const p1Idx, unsigned short const p2Idx,
+		   StThreeVectorF const & vtx, float const bField) :
+  mLorentzVector(StLorentzVectorF()),
+  mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Idx(p1Idx), mParticle2Idx(p2Idx),
+  mDcaDaughters(std::numeric_limits<float>::max()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN()) {
+  // -- Create pair out of a particle and and a pair
+
+  // -- checking that particle1 and tertiary particle (=pair) exists, and particle1 id different from both used to reconstruct tertiary pair
+  if ((!particle1 || !particle2) || (particle1->id() == particle2->particle1Idx()) || ( particle1->id() == particle2->particle2Idx())) {
+    mParticle1Idx = std::numeric_limits<unsigned short>::max();
+    mParticle2Idx = std::numeric_limits<unsigned short>::max();
+    return;
+  }
+
+  StHFCachedTrack const p1(particle1, p1Idx, vtx, bField);
+  StHFCascadeV0 const p2(*particle2, p2Idx, vtx, bField);
+
+  createPair(p1, p2, p1MassHypo, p2MassHypo);
+}
+
+// _________________________________________________________
+StHFPair::StHFPair(StHFCachedTrack const & particle1, StHFPair const * const particle2,
+		   float p1MassHypo, float p2MassHypo, unsigned short const p2Idx,
+		   StThreeVectorF const & vtx, float const bField) :
+  mLorentzVector(StLorentzVectorF()),
+  mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Idx(particle1.idx()), mParticle2Idx(p2Idx),
+  mDcaDaughters(std::numeric_limits<float>::max()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN()) {
+  // -- Create pair out of a cached track and and a pair
+
+  if (!particle2 || (particle1.id() == particle2->particle1Idx()) || (particle1.id() == particle2->particle2Idx())) {
+    mParticle1Idx = std::numeric_limits<unsigned short>::max();
+    mParticle2Idx = std::numeric_limits<unsigned short>::max();
+    return;
+  }
+
+  StHFCascadeV0 const p2(*particle2, p2Idx, vtx, bField);
+
+  createPair(particle1, p2, p1MassHypo, p2MassHypo);
+}
+
+// _________________________________________________________
+StHFPair::StHFPair(StHFCachedTrack const & particle1, StHFCascadeV0 const & particle2,
+		   float p1MassHypo, float p2MassHypo) :
+  mLorentzVector(StLorentzVectorF()),
+  mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Idx(particle1.idx()), mParticle2Idx(particle2.idx()),
+  mDcaDaughters(std::numeric_limits<float>::max()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN()) {
+  // -- Create pair out of a cached track and a pair set up as StHFCascadeV0
+
+  if (particle2.isDaughter(particle1)) {
+    mParticle1Idx = std::numeric_limits<unsigned short>::max();
+    mParticle2Idx = std::numeric_limits<unsigned short>::max();
+    return;
+  }
+
+  createPair(particle1, particle2, p1MassHypo, p2MassHypo);
+}
+
+// _________________________________________________________
+StHFPair::StHFPair(StHFTrackTable const & table, unsigned int const row1, unsigned int const row2,
+		   float p1MassHypo, float p2MassHypo) :
+  mLorentzVector(StLorentzVectorF()),
+  mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Idx(std::numeric_limits<unsigned short>::max()), mParticle2Idx(std::numeric_limits<unsigned short>::max()),
+  mDcaDaughters(std::numeric_limits<float>::max()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN()),
+  mV0x(std::numeric_limits<float>::max()), mV0y(std::numeric_limits<float>::max()),  mV0z(std::numeric_limits<float>::max()) {
+  // -- Create pair out of 2 rows of the track table
+
+  createPair(table, row1, row2, p1MassHypo, p2MassHypo, NULL, 0, NULL);
+}
+
+// _________________________________________________________
+bool StHFPair::createGoodPair(StHFTrackTable const & table, unsigned int const row1, unsigned int const row2,
+			      float const p1MassHypo, float const p2MassHypo, StHFCuts const & cuts, int const pairType,
+			      unsigned int * const nCutsPassed) {
+  // -- Create pair out of 2 rows of the track table, if it passes the pair cuts
+  //    of type pairType (StHFCuts::ePairType). The cuts are applied in the order
+  //    set in StHFCuts, as soon as the quantity is known. 
+  //    If the pair is rejected, only the quantities up to the failed cut are filled.
+  //    nCutsPassed (if given) is set to the index of the failed cut in this order
+
+  return createPair(table, row1, row2, p1MassHypo, p2MassHypo, &cuts, pairType, nCutsPassed);
+}
+
+// _________________________________________________________
+bool StHFPair::createPair(StHFTrackTable const & table, unsigned int const row1, unsigned int const row2,
+			  float const p1MassHypo, float const p2MassHypo, StHFCuts const * const cuts, int const pairType,
+			  unsigned int * const nCutsPassed) {
+  // -- Create pair out of 2 rows of the track table, in stages
+  //     - cheap quantities first : dcaDaughters and decay length from the straight lines
+  //                                (or the helices, see StHFCuts::vertexingMode()),
+  //                                in double or single precision (StHFCuts::kinematicsPrecision()),
+  //                                mass from the momenta at the DCA
+  //     - pointing angle
+  //     - only for pairs passing all cuts : cosThetaStar boost, decay vertex and daughter DCAs 
   //     prefixes code:
   //      p1 means particle 1
   //      p2 means particle 2
   //      pair means particle1-particle2  pair
 
-  if ((!particle1 || !particle2) || (particle1->id() == particle2->id())) {
+  mLorentzVector = StLorentzVectorF();
+  mCosPointingAngle = std::numeric_limits<float>::quiet_NaN();
+  mDecayLength   = std::numeric_limits<float>::quiet_NaN();
+  mParticle1Dca  = std::numeric_limits<float>::quiet_NaN();
+  mParticle2Dca  = std::numeric_limits<float>::quiet_NaN();
+  mParticle1Idx  = table.idx()[row1];
+  mParticle2Idx  = table.idx()[row2];
+  mDcaDaughters  = std::numeric_limits<float>::max();
+  mCosThetaStar  = std::numeric_limits<float>::quiet_NaN();
+  mV0x = std::numeric_limits<float>::max();
+  mV0y = std::numeric_limits<float>::max();
+  mV0z = std::numeric_limits<float>::max();
+
+  if (nCutsPassed)
+    *nCutsPassed = 0;
+
+  if (table.id()[row1] == table.id()[row2]) {
     mParticle1Idx = std::numeric_limits<unsigned short>::max();
     mParticle2Idx = std::numeric_limits<unsigned short>::max();
-    return;
+    return false;
   }
 
-  StPhysicalHelixD p1Helix = particle1->dcaGeometry().helix();
-  StPhysicalHelixD p2Helix = particle2->dcaGeometry().helix();
+  // -- straight line approximation, vertex relative to primary vertex
+  //    in double precision or float only (StHFCuts::kinematicsPrecision())
+  bool const bSinglePrecision = cuts && cuts->kinematicsPrecision() == StHFPairKernel::kSinglePrecision;
 
-  // -- move origins of helices to the primary vertex origin
-  p1Helix.moveOrigin(p1Helix.pathLength(vtx));
-  p2Helix.moveOrigin(p2Helix.pathLength(vtx));
+  StHFHelixF helix1;
+  StHFHelixF helix2;
+  StHFPairKinematics kin;
+
+  if (bSinglePrecision) {
+    helix1.set(table, row1);
+    helix2.set(table, row2);
+    StHFPairKernel::straightLineDca(helix1, helix2, kin);
+  }
+  else
+    StHFPairKernel::straightLineDca(table, row1, row2, kin);
+
+  // -- refine DCA on the helices, if requested
+  if (cuts && cuts->vertexingMode() == StHFCuts::kHelixRefine)
+    StHFPairKernel::refineHelixDca(table, row1, row2, cuts->vertexingIterations(), 0., kin);
+  else if (cuts && cuts->vertexingMode() == StHFCuts::kHelixFull)
+    StHFPairKernel::refineHelixDca(table, row1, row2, 
+				   StHFPairKernel::helixFullIterationsMax, StHFPairKernel::helixFullTolerance, kin);
+
+  mDcaDaughters = kin.dcaDaughters;
+
+  StThreeVectorF const vtxToV0(kin.v0[0], kin.v0[1], kin.v0[2]);
+  mDecayLength = vtxToV0.mag();
+
+  StLorentzVectorF p1FourMom;
+  StLorentzVectorF p2FourMom;
+  bool bHasMomenta = false;
+
+  for (unsigned int iCut = 0; iCut < StHFCuts::kPairCutMax; ++iCut) {
+    int const cut = cuts ? cuts->cutPairOrder(iCut) : iCut;
+
+    // -- calculate Lorentz vector of particle1-particle2 pair, when first needed
+    if ((cut == StHFCuts::kPairMass || cut == StHFCuts::kPairPointingAngle) && !bHasMomenta) {
+      if (bSinglePrecision)
+	StHFPairKernel::rotateMomenta(helix1, helix2, kin);
+      else
+	StHFPairKernel::rotateMomenta(table, row1, row2, kin);
+
+      StThreeVectorF const p1MomAtDca(kin.p1Mom[0], kin.p1Mom[1], kin.p1Mom[2]);
+      StThreeVectorF const p2MomAtDca(kin.p2Mom[0], kin.p2Mom[1], kin.p2Mom[2]);
+
+      p1FourMom = StLorentzVectorF(p1MomAtDca, p1MomAtDca.massHypothesis(p1MassHypo));
+      p2FourMom = StLorentzVectorF(p2MomAtDca, p2MomAtDca.massHypothesis(p2MassHypo));
+
+      mLorentzVector = p1FourMom + p2FourMom;
+      bHasMomenta = true;
+    }
+
+    // -- calculate cos of pointing angle with respect to primary vertex 
+    if (cut == StHFCuts::kPairPointingAngle)
+      mCosPointingAngle = StHFPairKernel::cosAngle(kin.v0[0], kin.v0[1], kin.v0[2], 
+						   mLorentzVector.px(), mLorentzVector.py(), mLorentzVector.pz());
+
+    if (cuts && !cuts->isGoodPairCut(cut, pairType, *this))
+      return false;
+
+    if (nCutsPassed)
+      *nCutsPassed = iCut + 1;
+  }
+
+  // -- calculate cosThetaStar
+  StLorentzVectorF const pairFourMomReverse(-mLorentzVector.px(), -mLorentzVector.py(), -mLorentzVector.pz(), mLorentzVector.e());
+  StLorentzVectorF const p1FourMomStar = p1FourMom.boost(pairFourMomReverse);
+  mCosThetaStar = std::cos(p1FourMomStar.vect().angle(mLorentzVector.vect()));
+
+  // -- calculate decay vertex (secondary or tertiary) 
+  mV0x = table.vtxX() + kin.v0[0];
+  mV0y = table.vtxY() + kin.v0[1];
+  mV0z = table.vtxZ() + kin.v0[2];
+
+  // -- DCA of tracks to primary vertex
+  mParticle1Dca = table.dca()[row1];
+  mParticle2Dca = table.dca()[row2];
+
+  return true;
+}
+
+// _________________________________________________________
+void StHFPair::createPair(StHFCachedTrack const & p1, StHFCachedTrack const & p2,
+			  float p1MassHypo, float p2MassHypo, StThreeVectorF const & vtx, float const bField) {
+  // -- Calculate pair out of 2 tracks
+  //     prefixes code:
+  //      p1 means particle 1
+  //      p2 means particle 2
+  //      pair means particle1-particle2  pair
+  //
+  //     helices of cached tracks have their origins already moved to the primary vertex
+
+  StPhysicalHelixD const & p1Helix = p1.helix();
+  StPhysicalHelixD const & p2Helix = p2.helix();
 
   // -- use straight lines approximation to get point of DCA of particle1-particle2 pair
-  StThreeVectorF const p1Mom = p1Helix.momentum(bField * kilogauss);
-  StThreeVectorF const p2Mom = p2Helix.momentum(bField * kilogauss);
-  StPhysicalHelixD const p1StraightLine(p1Mom, p1Helix.origin(), 0, particle1->charge());
-  StPhysicalHelixD const p2StraightLine(p2Mom, p2Helix.origin(), 0, particle2->charge());
+  StPhysicalHelixD const p1StraightLine(p1.momentum(), p1Helix.origin(), 0, p1.charge());
+  StPhysicalHelixD const p2StraightLine(p2.momentum(), p2Helix.origin(), 0, p2.charge());
 
   pair<double, double> const ss = p1StraightLine.pathLengths(p2StraightLine);
   StThreeVectorF const p1AtDcaToP2 = p1StraightLine.at(ss.first);
@@ -91,58 +337,41 @@ StHFPair::StHFPair(StPicoTrack const * const particle1, StPicoTrack const * cons
   mV0y = decayVtx.y();
   mV0z = decayVtx.z(); 
 
-  // -- calculate pointing angle and decay length with respect to primary vertex 
+  // -- calculate cos of pointing angle and decay length with respect to primary vertex 
   //    if decay vertex is a tertiary vertex
   //    -> only rough estimate -> needs to be updated after secondary vertex is found
   StThreeVectorF const vtxToV0 = decayVtx - vtx;
-  mPointingAngle = vtxToV0.angle(mLorentzVector.vect());
+  mCosPointingAngle = StHFPairKernel::cosAngle(vtxToV0.x(), vtxToV0.y(), vtxToV0.z(), 
+					       mLorentzVector.px(), mLorentzVector.py(), mLorentzVector.pz());
   mDecayLength = vtxToV0.mag();
 
-  // -- calculate DCA of tracks to primary vertex
+  // -- DCA of tracks to primary vertex
   //    if decay vertex is a tertiary vertex
   //    -> only rough estimate -> needs to be updated after secondary vertex is found
-  mParticle1Dca = (p1Helix.origin() - vtx).mag();
-  mParticle2Dca = (p2Helix.origin() - vtx).mag();
+  mParticle1Dca = p1.dca();
+  mParticle2Dca = p2.dca();
 }
 
 // _________________________________________________________
-StHFPair::StHFPair(StPicoTrack const * const particle1, StHFPair const * const particle2,
-		   float p1MassHypo, float p2MassHypo, unsigned short const p1Idx, unsigned short const p2Idx,
-		   StThreeVectorF const & vtx, float const bField) :
-  mLorentzVector(StLorentzVectorF()),
-  mPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
-  mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()),
-  mParticle1Idx(p1Idx), mParticle2Idx(p2Idx),
-  mDcaDaughters(std::numeric_limits<float>::max()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN()) {
-  // -- Create pair out of a particle and and a pair
+void StHFPair::createPair(StHFCachedTrack const & p1, StHFCascadeV0 const & p2,
+			  float p1MassHypo, float p2MassHypo) {
+  // -- Calculate pair out of a track and a pair
   //     prefixes code:
   //      p1 means particle 1
   //      p2 means particle 2 - which is a pair of tertiaryP1 and tertiaryP2
   //      pair means particle1-particle2  pair
-  
-  // -- assume incoming pair always to be neutral 
-  float p2Charge = 0.;
+  //
+  //     incoming pair is neutral, its helix is already moved to the primary vertex
 
-  // -- checking that particle1 and tertiary particle (=pair) exists, and particle1 id different from both used to reconstruct tertiary pair
-  if ((!particle1 || !particle2) || (particle1->id() == particle2->particle1Idx()) || ( particle1->id() == particle2->particle2Idx())) {
-    mParticle1Idx = std::numeric_limits<unsigned short>::max();
-    mParticle2Idx = std::numeric_limits<unsigned short>::max();
-    return;
-  }
-
-  StPhysicalHelixD p1Helix = particle1->dcaGeometry().helix();
-  StThreeVectorF const p2Mom(particle2->px(),particle2->py(),particle2->pz());
-  StThreeVectorF const p2Origin(particle2->v0x(),particle2->v0y(),particle2->v0z());
-  StPhysicalHelixD p2Helix(p2Mom,p2Origin,bField*kilogauss, p2Charge);
+  StThreeVectorF const & vtx = p2.primVtx();
+  float const bField = p2.bField();
 
-  // --move origins of helices to the primary vertex origin
-  p1Helix.moveOrigin(p1Helix.pathLength(vtx));
-  p2Helix.moveOrigin(p2Helix.pathLength(vtx));
+  StPhysicalHelixD const & p1Helix = p1.helix();
+  StPhysicalHelixD const & p2Helix = p2.helix();
 
   // --use straight lines approximation to get point of DCA of particle1-particle2 pair
-  StThreeVectorF const p1Mom = p1Helix.momentum(bField * kilogauss);
-  StPhysicalHelixD const p1StraightLine(p1Mom, p1Helix.origin(), 0, particle1->charge());
-  StPhysicalHelixD const p2StraightLine(p2Mom, p2Helix.origin(), 0, p2Charge);
+  StPhysicalHelixD const p1StraightLine = p1.straightLine();
+  StPhysicalHelixD const & p2StraightLine = p2.straightLine();
   
   pair<double, double> const ss = p1StraightLine.pathLengths(p2StraightLine);
   StThreeVectorF const p1AtDcaToP2 = p1StraightLine.at(ss.first);
@@ -171,14 +400,20 @@ StHFPair::StHFPair(StPicoTrack const * const particle1, StHFPair const * const p
   mV0y = decayVtx.y();
   mV0z = decayVtx.z();
 
-  // -- calculate pointing angle and decay length with respect to primary vertex
+  // -- calculate cos of pointing angle and decay length with respect to primary vertex
   StThreeVectorF const vtxToV0 = decayVtx - vtx;
-  mPointingAngle = vtxToV0.angle(mLorentzVector.vect());
+  mCosPointingAngle = StHFPairKernel::cosAngle(vtxToV0.x(), vtxToV0.y(), vtxToV0.z(), 
+					       mLorentzVector.px(), mLorentzVector.py(), mLorentzVector.pz());
   mDecayLength = vtxToV0.mag();
    
   // -- calculate DCA of tracks to primary vertex
-  mParticle1Dca = (p1Helix.origin() - vtx).mag();
-  mParticle2Dca = (p2Helix.origin() - vtx).mag();
+  mParticle1Dca = p1.dca();
+  mParticle2Dca = p2.dca();
+}
+// _________________________________________________________
+float StHFPair::pointingAngle() const {
+  // -- pointing angle from the stored cos, prefer cosPointingAngle() for cuts
+  return std::acos(mCosPointingAngle);
 }
 // _________________________________________________________
 float StHFPair::pointingAngle(StThreeVectorF const & vtx2) const{
@@ -11,6 +11,31 @@
  *    - in the current implementation the incoming pair is seen as having charge = 0
  *    - after determining the vertex of particle and incoming pair, the 
  *      decay vertex (tertiary vertex) of incoming particle can be updated
+ *  - both can also be created from entries of the event-wise track cache
+ *    (StHFTrackCache), which avoids to redo the helix setup of a track
+ *    for every pair it is used in
+ *  - a cached track and a pair whose state is already set up once (StHFCascadeV0), 
+ *    using
+ *      StHFPair(StHFCachedTrack const & particle1, StHFCascadeV0 const & particle2, ...
+ *    the V0 helix is not recreated for every bachelor track, the tertiary 
+ *    quantities with respect to this pair are updated via StHFCascadeV0
+ *  - two particles from the structure-of-arrays track table (StHFTrackTable),
+ *    using the rows of the table
+ *      StHFPair(StHFTrackTable const & table, unsigned int row1, unsigned int row2, ...
+ *    - the kinematics are calculated by StHFPairKernel from the table arrays
+ *    - createGoodPair(table, row1, row2, ..., cuts, pairType) builds the pair
+ *      in stages and applies the pair cuts of StHFCuts as early as possible,
+ *      the cosThetaStar boost and the daughter DCAs are only calculated
+ *      for pairs passing all cuts. If nCutsPassed is given, it is set to the 
+ *      number of cuts passed in the order of StHFCuts::cutPairOrder, i.e. the
+ *      index of the failed cut (StHFCuts::kPairCutMax if all are passed)
+ *    - with the cuts, the decay vertex follows StHFCuts::vertexingMode(),
+ *      straight lines (default) or refined on the helices, and the straight
+ *      lines are calculated in the precision of StHFCuts::kinematicsPrecision().
+ *      All other constructors use the straight line approximation
+ *  - the cos of the pointing angle is stored (cosPointingAngle()), cuts should 
+ *    use it directly. pointingAngle() returns its acos. Version 1 stored the 
+ *    angle, it is converted when reading (read rule in StPicoHFMakerLinkDef.h)
  *
  * **************************************************
  *  Authors:  Xin Dong        (xdong@lbl.gov)
@@ -26,6 +51,10 @@
 #include "StLorentzVectorF.hh"
 
 class StPicoTrack;
+class StHFCachedTrack;
+class StHFCascadeV0;
+class StHFTrackTable;
+class StHFCuts;
 
 class StHFPair : public TObject
 {
@@ -43,7 +72,25 @@ class StHFPair : public TObject
 	   unsigned short p1Idx, unsigned short p2Idx,
 	   StThreeVectorF const & vtx, float bField);
 
+  StHFPair(StHFCachedTrack const & particle1, StHFCachedTrack const & particle2, 
+	   float p1MassHypo, float p2MassHypo,
+	   StThreeVectorF const & vtx, float bField);
+
+  StHFPair(StHFCachedTrack const & particle1, StHFPair const * particle2, 
+	   float p1MassHypo, float p2MassHypo, unsigned short p2Idx,
+	   StThreeVectorF const & vtx, float bField);
+
+  StHFPair(StHFCachedTrack const & particle1, StHFCascadeV0 const & particle2, 
+	   float p1MassHypo, float p2MassHypo);
+
+  StHFPair(StHFTrackTable const & table, unsigned int row1, unsigned int row2,
+	   float p1MassHypo, float p2MassHypo);
+
   ~StHFPair() {;}
+
+  bool createGoodPair(StHFTrackTable const & table, unsigned int row1, unsigned int row2,
+		      float p1MassHypo, float p2MassHypo, StHFCuts const & cuts, int pairType,
+		      unsigned int * nCutsPassed = NULL);
   
 
   StLorentzVectorF const & lorentzVector() const;
@@ -51,6 +98,7 @@ class StHFPair : public TObject
   float pt()   const;
   float eta()  const;
   float phi()  const;
+  float cosPointingAngle() const;
   float pointingAngle() const;
   float pointingAngle(StThreeVectorF const & vtx2) const;
   float decayLength() const;
@@ -73,9 +121,18 @@ class StHFPair : public TObject
  private:
   StHFPair(StHFPair const &);
   StHFPair& operator=(StHFPair const &);
+
+  void createPair(StHFCachedTrack const & p1, StHFCachedTrack const & p2,
+		  float p1MassHypo, float p2MassHypo, StThreeVectorF const & vtx, float bField);
+  void createPair(StHFCachedTrack const & p1, StHFCascadeV0 const & p2,
+		  float p1MassHypo, float p2MassHypo);
+  bool createPair(StHFTrackTable const & table, unsigned int row1, unsigned int row2,
+		  float p1MassHypo, float p2MassHypo, StHFCuts const * cuts, int pairType,
+		  unsigned int * nCutsPassed);
+
   StLorentzVectorF mLorentzVector; 
 
-  float mPointingAngle;
+  float mCosPointingAngle; // cos of pointing angle, until version 1 mPointingAngle
   float mDecayLength;
   float mParticle1Dca;
   float mParticle2Dca;
@@ -90,7 +147,7 @@ class StHFPair : public TObject
   float mV0y;
   float mV0z;
   
-  ClassDef(StHFPair,1)
+  ClassDef(StHFPair,2)
 };
 inline StLorentzVectorF const & StHFPair::lorentzVector() const { return mLorentzVector;}
 inline float StHFPair::m()    const { return mLorentzVector.m();}
@@ -100,7 +157,7 @@ inline float StHFPair::phi()  const { return mLorentzVector.phi();}
 inline float StHFPair::px()   const { return mLorentzVector.px();}
 inline float StHFPair::py()   const { return mLorentzVector.py();}
 inline float StHFPair::pz()   const { return mLorentzVector.pz();}
-inline float StHFPair::pointingAngle() const { return mPointingAngle;}
+inline float StHFPair::cosPointingAngle() const { return mCosPointingAngle;}
 inline float StHFPair::decayLength()   const { return mDecayLength;}
 inline float StHFPair::particle1Dca()  const { return mParticle1Dca;}
 inline float StHFPair::particle2Dca()  const { return mParticle2Dca;}
@@ -0,0 +1,571 @@
+#include <cmath>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "StHFPairKernel.h"
+#include "StHFTrackTable.h"
+#include "StHFHelixF.h"
+
+// -- vector width and operations of the batch kernel
+#if defined(__AVX512F__)
+#define HF_VWIDTH 16
+typedef __m512  hfVec;
+typedef __m512i hfVecI;
+#define HF_SET1(x)         _mm512_set1_ps(x)
+#define HF_ADD(a, b)       _mm512_add_ps(a, b)
+#define HF_SUB(a, b)       _mm512_sub_ps(a, b)
+#define HF_MUL(a, b)       _mm512_mul_ps(a, b)
+#define HF_DIV(a, b)       _mm512_div_ps(a, b)
+#define HF_SQRT(a)         _mm512_sqrt_ps(a)
+#define HF_LOADI(p)        _mm512_loadu_si512(static_cast<void const *>(p))
+#define HF_GATHER(base, i) _mm512_i32gather_ps(i, base, 4)
+#define HF_STORE(p, a)     _mm512_storeu_ps(p, a)
+#elif defined(__AVX2__)
+#define HF_VWIDTH 8
+typedef __m256  hfVec;
+typedef __m256i hfVecI;
+#define HF_SET1(x)         _mm256_set1_ps(x)
+#define HF_ADD(a, b)       _mm256_add_ps(a, b)
+#define HF_SUB(a, b)       _mm256_sub_ps(a, b)
+#define HF_MUL(a, b)       _mm256_mul_ps(a, b)
+#define HF_DIV(a, b)       _mm256_div_ps(a, b)
+#define HF_SQRT(a)         _mm256_sqrt_ps(a)
+#define HF_LOADI(p)        _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p))
+#define HF_GATHER(base, i) _mm256_i32gather_ps(base, i, 4)
+#define HF_STORE(p, a)     _mm256_storeu_ps(p, a)
+#endif
+
+namespace {
+  // -- |rotation angle| of a daughter momentum above which the polynomial 
+  //    sin/cos of the batch kernel is not precise enough and the pair is 
+  //    recomputed with the scalar kernel
+  float const kMaxBatchPhi = 0.5;
+
+  // _________________________________________________________
+  void fillBatchEntry(StHFPairKinematics const & kin, unsigned int const i, StHFPairBatch & batch) {
+    // -- fill entry i of the batch from the scalar kinematics
+
+    batch.s1[i]           = kin.s1;
+    batch.s2[i]           = kin.s2;
+    batch.dcaDaughters[i] = kin.dcaDaughters;
+    batch.v0x[i]          = kin.v0[0];
+    batch.v0y[i]          = kin.v0[1];
+    batch.v0z[i]          = kin.v0[2];
+    batch.px[i]           = kin.p1Mom[0] + kin.p2Mom[0];
+    batch.py[i]           = kin.p1Mom[1] + kin.p2Mom[1];
+    batch.pz[i]           = kin.p1Mom[2] + kin.p2Mom[2];
+
+    double const v0Mag = std::sqrt(double(kin.v0[0])*kin.v0[0] + double(kin.v0[1])*kin.v0[1] + double(kin.v0[2])*kin.v0[2]);
+    double const pMag  = std::sqrt(double(batch.px[i])*batch.px[i] + double(batch.py[i])*batch.py[i] + double(batch.pz[i])*batch.pz[i]);
+
+    batch.decayLength[i]      = v0Mag;
+    batch.cosPointingAngle[i] = (kin.v0[0]*batch.px[i] + kin.v0[1]*batch.py[i] + kin.v0[2]*batch.pz[i]) / (v0Mag * pMag);
+  }
+
+  // _________________________________________________________
+  bool isOutsideTolerance(float const value, float const reference, float const tolerance) {
+    // -- relative difference, with 10 um / 1 MeV / 1e-3 in cos as the smallest scale
+    return !(std::fabs(value - reference) <= tolerance * (std::fabs(reference) + 1.e-3));
+  }
+
+  // _________________________________________________________
+  struct HelixTrack {
+    // -- helix in path length s, starting at o with unit direction a,
+    //    transverse direction turns by omega * s (see StHFPairKernel::rotateMomenta)
+    double o[3];
+    double a[3];
+    double omega;
+
+    HelixTrack(StHFTrackTable const & table, unsigned int const row) {
+      double const px = table.px()[row];
+      double const py = table.py()[row];
+      double const pz = table.pz()[row];
+      double const pMag = std::sqrt(px*px + py*py + pz*pz);
+
+      o[0] = table.dcaX()[row];  o[1] = table.dcaY()[row];  o[2] = table.dcaZ()[row];
+      a[0] = px/pMag;            a[1] = py/pMag;            a[2] = pz/pMag;
+      omega = -StHFPairKernel::cLight * table.charge()[row] * table.bField() / pMag;
+    }
+
+    // -- position x, direction t and curvature vector k = dt/ds at s
+    void at(double const s, double * const x, double * const t, double * const k) const {
+      double const phi = omega * s;
+      double const sn  = std::sin(phi);
+      double const c   = std::cos(phi);
+
+      // -- sin(phi)/omega and (1-cos(phi))/omega, as series for small angles
+      double fs, fc;
+      if (std::fabs(phi) < 1.e-6) {
+	fs = s;
+	fc = 0.5 * phi * s;
+      }
+      else {
+	fs = sn / omega;
+	fc = (1. - c) / omega;
+      }
+
+      x[0] = o[0] + a[0]*fs - a[1]*fc;
+      x[1] = o[1] + a[1]*fs + a[0]*fc;
+      x[2] = o[2] + a[2]*s;
+
+      t[0] = a[0]*c - a[1]*sn;
+      t[1] = a[0]*sn + a[1]*c;
+      t[2] = a[2];
+
+      k[0] = -omega * t[1];
+      k[1] =  omega * t[0];
+      k[2] = 0.;
+    }
+  };
+
+  // _________________________________________________________
+  double distanceSq(double const * const x1, double const * const x2) {
+    return (x1[0]-x2[0])*(x1[0]-x2[0]) + (x1[1]-x2[1])*(x1[1]-x2[1]) + (x1[2]-x2[2])*(x1[2]-x2[2]);
+  }
+
+#ifdef HF_VWIDTH
+  // _________________________________________________________
+  void straightLineBatchSimd(StHFTrackTable const & table, unsigned int const row1, 
+			     int const * const rows2, unsigned int const nRows2, 
+			     unsigned int const offset, StHFPairBatch & batch) {
+    // -- one vector of pairs: particle 1 is broadcast, particles 2 are gathered
+    //    see straightLinePair for the formulas, except
+    //     - 1 - ab^2 is calculated as |a1 x a2|^2, which is stable in single precision
+    //     - sin/cos of the rotation angle are calculated as polynomials
+
+    // -- pad unused lanes with the first row
+    int rows[HF_VWIDTH];
+    for (unsigned int i = 0; i < HF_VWIDTH; ++i)
+      rows[i] = rows2[(i < nRows2) ? i : 0];
+
+    // -- particle 1
+    float const p1xS  = table.px()[row1];
+    float const p1yS  = table.py()[row1];
+    float const p1zS  = table.pz()[row1];
+    float const p1Mag = std::sqrt(p1xS*p1xS + p1yS*p1yS + p1zS*p1zS);
+
+    hfVec const p1x = HF_SET1(p1xS);
+    hfVec const p1y = HF_SET1(p1yS);
+    hfVec const p1z = HF_SET1(p1zS);
+    hfVec const a1x = HF_SET1(p1xS/p1Mag);
+    hfVec const a1y = HF_SET1(p1yS/p1Mag);
+    hfVec const a1z = HF_SET1(p1zS/p1Mag);
+    hfVec const o1x = HF_SET1(table.dcaX()[row1]);
+    hfVec const o1y = HF_SET1(table.dcaY()[row1]);
+    hfVec const o1z = HF_SET1(table.dcaZ()[row1]);
+
+    // -- particles 2
+    hfVecI const idx = HF_LOADI(rows);
+
+    hfVec const p2x = HF_GATHER(table.px(), idx);
+    hfVec const p2y = HF_GATHER(table.py(), idx);
+    hfVec const p2z = HF_GATHER(table.pz(), idx);
+    hfVec const o2x = HF_GATHER(table.dcaX(), idx);
+    hfVec const o2y = HF_GATHER(table.dcaY(), idx);
+    hfVec const o2z = HF_GATHER(table.dcaZ(), idx);
+    hfVec const q2  = HF_GATHER(table.charge(), idx);
+
+    hfVec const one    = HF_SET1(1.f);
+    hfVec const p2Mag  = HF_SQRT(HF_ADD(HF_ADD(HF_MUL(p2x, p2x), HF_MUL(p2y, p2y)), HF_MUL(p2z, p2z)));
+    hfVec const p2MagI = HF_DIV(one, p2Mag);
+    hfVec const a2x    = HF_MUL(p2x, p2MagI);
+    hfVec const a2y    = HF_MUL(p2y, p2MagI);
+    hfVec const a2z    = HF_MUL(p2z, p2MagI);
+
+    // -- path lengths at DCA of two straight lines
+    hfVec const dvx = HF_SUB(o2x, o1x);
+    hfVec const dvy = HF_SUB(o2y, o1y);
+    hfVec const dvz = HF_SUB(o2z, o1z);
+
+    hfVec const ab = HF_ADD(HF_ADD(HF_MUL(a1x, a2x), HF_MUL(a1y, a2y)), HF_MUL(a1z, a2z));
+    hfVec const g  = HF_ADD(HF_ADD(HF_MUL(dvx, a1x), HF_MUL(dvy, a1y)), HF_MUL(dvz, a1z));
+    hfVec const k  = HF_ADD(HF_ADD(HF_MUL(dvx, a2x), HF_MUL(dvy, a2y)), HF_MUL(dvz, a2z));
+
+    hfVec const cx  = HF_SUB(HF_MUL(a1y, a2z), HF_MUL(a1z, a2y));
+    hfVec const cy  = HF_SUB(HF_MUL(a1z, a2x), HF_MUL(a1x, a2z));
+    hfVec const cz  = HF_SUB(HF_MUL(a1x, a2y), HF_MUL(a1y, a2x));
+    hfVec const den = HF_ADD(HF_ADD(HF_MUL(cx, cx), HF_MUL(cy, cy)), HF_MUL(cz, cz));
+
+    hfVec const s2 = HF_DIV(HF_SUB(HF_MUL(ab, g), k), den);
+    hfVec const s1 = HF_ADD(g, HF_MUL(s2, ab));
+
+    // -- points of DCA, DCA between daughters and decay vertex
+    hfVec const x1 = HF_ADD(o1x, HF_MUL(s1, a1x));
+    hfVec const y1 = HF_ADD(o1y, HF_MUL(s1, a1y));
+    hfVec const z1 = HF_ADD(o1z, HF_MUL(s1, a1z));
+    hfVec const x2 = HF_ADD(o2x, HF_MUL(s2, a2x));
+    hfVec const y2 = HF_ADD(o2y, HF_MUL(s2, a2y));
+    hfVec const z2 = HF_ADD(o2z, HF_MUL(s2, a2z));
+
+    hfVec const dx = HF_SUB(x1, x2);
+    hfVec const dy = HF_SUB(y1, y2);
+    hfVec const dz = HF_SUB(z1, z2);
+    hfVec const dcaDaughters = HF_SQRT(HF_ADD(HF_ADD(HF_MUL(dx, dx), HF_MUL(dy, dy)), HF_MUL(dz, dz)));
+
+    hfVec const half = HF_SET1(0.5f);
+    hfVec const v0x  = HF_MUL(half, HF_ADD(x1, x2));
+    hfVec const v0y  = HF_MUL(half, HF_ADD(y1, y2));
+    hfVec const v0z  = HF_MUL(half, HF_ADD(z1, z2));
+    hfVec const decayLength = HF_SQRT(HF_ADD(HF_ADD(HF_MUL(v0x, v0x), HF_MUL(v0y, v0y)), HF_MUL(v0z, v0z)));
+
+    // -- rotation of momenta at DCA
+    float const cB = -StHFPairKernel::cLight * table.bField();
+    hfVec const phi1 = HF_MUL(HF_SET1(cB * table.charge()[row1] / p1Mag), s1);
+    hfVec const phi2 = HF_MUL(HF_MUL(HF_SET1(cB), q2), HF_MUL(s2, p2MagI));
+
+    // -- sin/cos polynomials, precise to < 1e-8 for |phi| < kMaxBatchPhi
+    hfVec const sinC3 = HF_SET1(-1.f/6.f);
+    hfVec const sinC5 = HF_SET1(1.f/120.f);
+    hfVec const sinC7 = HF_SET1(-1.f/5040.f);
+    hfVec const cosC2 = HF_SET1(-0.5f);
+    hfVec const cosC4 = HF_SET1(1.f/24.f);
+    hfVec const cosC6 = HF_SET1(-1.f/720.f);
+    hfVec const cosC8 = HF_SET1(1.f/40320.f);
+
+    hfVec const phi1Sq = HF_MUL(phi1, phi1);
+    hfVec const phi2Sq = HF_MUL(phi2, phi2);
+    hfVec const sn1 = HF_MUL(phi1, HF_ADD(one, HF_MUL(phi1Sq, HF_ADD(sinC3, HF_MUL(phi1Sq, HF_ADD(sinC5, HF_MUL(phi1Sq, sinC7)))))));
+    hfVec const sn2 = HF_MUL(phi2, HF_ADD(one, HF_MUL(phi2Sq, HF_ADD(sinC3, HF_MUL(phi2Sq, HF_ADD(sinC5, HF_MUL(phi2Sq, sinC7)))))));
+    hfVec const c1  = HF_ADD(one, HF_MUL(phi1Sq, HF_ADD(cosC2, HF_MUL(phi1Sq, HF_ADD(cosC4, HF_MUL(phi1Sq, HF_ADD(cosC6, HF_MUL(phi1Sq, cosC8))))))));
+    hfVec const c2  = HF_ADD(one, HF_MUL(phi2Sq, HF_ADD(cosC2, HF_MUL(phi2Sq, HF_ADD(cosC4, HF_MUL(phi2Sq, HF_ADD(cosC6, HF_MUL(phi2Sq, cosC8))))))));
+
+    // -- pair momentum and pointing angle
+    hfVec const px = HF_ADD(HF_SUB(HF_MUL(p1x, c1), HF_MUL(p1y, sn1)), HF_SUB(HF_MUL(p2x, c2), HF_MUL(p2y, sn2)));
+    hfVec const py = HF_ADD(HF_ADD(HF_MUL(p1x, sn1), HF_MUL(p1y, c1)), HF_ADD(HF_MUL(p2x, sn2), HF_MUL(p2y, c2)));
+    hfVec const pz = HF_ADD(p1z, p2z);
+    hfVec const pMag = HF_SQRT(HF_ADD(HF_ADD(HF_MUL(px, px), HF_MUL(py, py)), HF_MUL(pz, pz)));
+
+    hfVec const v0DotP = HF_ADD(HF_ADD(HF_MUL(v0x, px), HF_MUL(v0y, py)), HF_MUL(v0z, pz));
+    hfVec const cosPointingAngle = HF_DIV(v0DotP, HF_MUL(decayLength, pMag));
+
+    HF_STORE(batch.s1               + offset, s1);
+    HF_STORE(batch.s2               + offset, s2);
+    HF_STORE(batch.dcaDaughters     + offset, dcaDaughters);
+    HF_STORE(batch.v0x              + offset, v0x);
+    HF_STORE(batch.v0y              + offset, v0y);
+    HF_STORE(batch.v0z              + offset, v0z);
+    HF_STORE(batch.decayLength      + offset, decayLength);
+    HF_STORE(batch.cosPointingAngle + offset, cosPointingAngle);
+    HF_STORE(batch.px               + offset, px);
+    HF_STORE(batch.py               + offset, py);
+    HF_STORE(batch.pz               + offset, pz);
+
+    // -- recompute pairs with large rotation angles with the scalar kernel
+    float aPhi1[HF_VWIDTH];
+    float aPhi2[HF_VWIDTH];
+    HF_STORE(aPhi1, phi1);
+    HF_STORE(aPhi2, phi2);
+
+    for (unsigned int i = 0; i < nRows2; ++i) {
+      if (std::fabs(aPhi1[i]) < kMaxBatchPhi && std::fabs(aPhi2[i]) < kMaxBatchPhi)
+	continue;
+
+      StHFPairKinematics kin;
+      StHFPairKernel::straightLinePair(table, row1, rows2[i], kin);
+      fillBatchEntry(kin, offset + i, batch);
+    }
+  }
+#endif
+}
+
+// _________________________________________________________
+void StHFPairKernel::straightLinePair(StHFTrackTable const & table, unsigned int const row1, unsigned int const row2,
+				      StHFPairKinematics & kin) {
+  // -- straight line approximation of pair at the DCA to the primary vertex
+
+  straightLineDca(table, row1, row2, kin);
+  rotateMomenta(table, row1, row2, kin);
+}
+
+// _________________________________________________________
+void StHFPairKernel::straightLineDca(StHFTrackTable const & table, unsigned int const row1, unsigned int const row2,
+				     StHFPairKinematics & kin) {
+  // -- path lengths, DCA between daughters and decay vertex in straight line approximation
+  //     prefixes code:
+  //      p1 means particle 1
+  //      p2 means particle 2
+  //     calculation done in double precision, as in StPhysicalHelixD
+
+  double const p1x = table.px()[row1];
+  double const p1y = table.py()[row1];
+  double const p1z = table.pz()[row1];
+  double const p2x = table.px()[row2];
+  double const p2y = table.py()[row2];
+  double const p2z = table.pz()[row2];
+
+  double const p1Mag = std::sqrt(p1x*p1x + p1y*p1y + p1z*p1z);
+  double const p2Mag = std::sqrt(p2x*p2x + p2y*p2y + p2z*p2z);
+
+  // -- unit vectors of straight lines
+  double const a1x = p1x/p1Mag, a1y = p1y/p1Mag, a1z = p1z/p1Mag;
+  double const a2x = p2x/p2Mag, a2y = p2y/p2Mag, a2z = p2z/p2Mag;
+
+  // -- origins of straight lines, relative to the primary vertex
+  double const o1x = table.dcaX()[row1], o1y = table.dcaY()[row1], o1z = table.dcaZ()[row1];
+  double const o2x = table.dcaX()[row2], o2y = table.dcaY()[row2], o2z = table.dcaZ()[row2];
+
+  // -- path lengths at DCA of two straight lines (see StHelix::pathLengths)
+  double const dvx = o2x - o1x, dvy = o2y - o1y, dvz = o2z - o1z;
+  double const ab = a1x*a2x + a1y*a2y + a1z*a2z;
+  double const g  = dvx*a1x + dvy*a1y + dvz*a1z;
+  double const k  = dvx*a2x + dvy*a2y + dvz*a2z;
+  double const s2 = (k - ab*g) / (ab*ab - 1.);
+  double const s1 = g + s2*ab;
+
+  // -- points of DCA
+  double const x1 = o1x + s1*a1x, y1 = o1y + s1*a1y, z1 = o1z + s1*a1z;
+  double const x2 = o2x + s2*a2x, y2 = o2y + s2*a2y, z2 = o2z + s2*a2z;
+
+  kin.s1 = s1;
+  kin.s2 = s2;
+  kin.dcaDaughters = std::sqrt((x1-x2)*(x1-x2) + (y1-y2)*(y1-y2) + (z1-z2)*(z1-z2));
+
+  kin.v0[0] = 0.5 * (x1 + x2);
+  kin.v0[1] = 0.5 * (y1 + y2);
+  kin.v0[2] = 0.5 * (z1 + z2);
+}
+
+// _________________________________________________________
+void StHFPairKernel::rotateMomenta(StHFTrackTable const & table, unsigned int const row1, unsigned int const row2,
+				   StHFPairKinematics & kin) {
+  // -- momenta at DCA: rotate transverse momentum along the helix by the path length
+  //    (see StPhysicalHelix::momentumAt), pz is unchanged
+  //    needs kin.s1 and kin.s2 from straightLineDca
+
+  double const p1x = table.px()[row1];
+  double const p1y = table.py()[row1];
+  double const p1z = table.pz()[row1];
+  double const p2x = table.px()[row2];
+  double const p2y = table.py()[row2];
+  double const p2z = table.pz()[row2];
+
+  double const p1Mag = std::sqrt(p1x*p1x + p1y*p1y + p1z*p1z);
+  double const p2Mag = std::sqrt(p2x*p2x + p2y*p2y + p2z*p2z);
+
+  double const bField = table.bField();
+  double const phi1 = -cLight * table.charge()[row1] * bField * double(kin.s1) / p1Mag;
+  double const phi2 = -cLight * table.charge()[row2] * bField * double(kin.s2) / p2Mag;
+
+  double const c1 = std::cos(phi1), sn1 = std::sin(phi1);
+  double const c2 = std::cos(phi2), sn2 = std::sin(phi2);
+
+  kin.p1Mom[0] = p1x*c1 - p1y*sn1;
+  kin.p1Mom[1] = p1x*sn1 + p1y*c1;
+  kin.p1Mom[2] = p1z;
+
+  kin.p2Mom[0] = p2x*c2 - p2y*sn2;
+  kin.p2Mom[1] = p2x*sn2 + p2y*c2;
+  kin.p2Mom[2] = p2z;
+}
+
+// _________________________________________________________
+void StHFPairKernel::straightLinePairSingle(StHFTrackTable const & table, unsigned int const row1, unsigned int const row2,
+					    StHFPairKinematics & kin) {
+  // -- straight line approximation of pair at the DCA to the primary vertex, in float only
+
+  StHFHelixF const helix1(table, row1);
+  StHFHelixF const helix2(table, row2);
+
+  straightLineDca(helix1, helix2, kin);
+  rotateMomenta(helix1, helix2, kin);
+}
+
+// _________________________________________________________
+void StHFPairKernel::straightLineDca(StHFHelixF const & helix1, StHFHelixF const & helix2, StHFPairKinematics & kin) {
+  // -- path lengths, DCA between daughters and decay vertex in straight line approximation, in float only
+
+  helix1.pathLengths(helix2, kin.s1, kin.s2);
+
+  float x1[3];
+  float x2[3];
+  helix1.pointAt(kin.s1, x1);
+  helix2.pointAt(kin.s2, x2);
+
+  float const dx = x1[0] - x2[0];
+  float const dy = x1[1] - x2[1];
+  float const dz = x1[2] - x2[2];
+  kin.dcaDaughters = std::sqrt(dx*dx + dy*dy + dz*dz);
+
+  kin.v0[0] = 0.5f * (x1[0] + x2[0]);
+  kin.v0[1] = 0.5f * (x1[1] + x2[1]);
+  kin.v0[2] = 0.5f * (x1[2] + x2[2]);
+}
+
+// _________________________________________________________
+void StHFPairKernel::rotateMomenta(StHFHelixF const & helix1, StHFHelixF const & helix2, StHFPairKinematics & kin) {
+  // -- momenta at DCA, in float only
+  //    needs kin.s1 and kin.s2 from straightLineDca
+
+  helix1.momentumAt(kin.s1, kin.p1Mom);
+  helix2.momentumAt(kin.s2, kin.p2Mom);
+}
+
+// _________________________________________________________
+unsigned int StHFPairKernel::refineHelixDca(StHFTrackTable const & table, unsigned int const row1, unsigned int const row2,
+					    unsigned int const nIterationsMax, float const tolerance,
+					    StHFPairKinematics & kin) {
+  // -- Newton steps on 1/2 |x1(s1) - x2(s2)|^2, with d = x1 - x2
+  //     gradient : ( d.t1, -d.t2 )
+  //     hessian  : ( 1 + d.k1 , -t1.t2    )
+  //                ( -t1.t2   ,  1 - d.k2 )
+  //    needs kin from straightLineDca as seed, the closest points on the helices
+  //    of the seed and of all steps are kept
+
+  HelixTrack const helix1(table, row1);
+  HelixTrack const helix2(table, row2);
+
+  double s1 = kin.s1;
+  double s2 = kin.s2;
+
+  double x1[3], t1[3], k1[3];
+  double x2[3], t2[3], k2[3];
+
+  // -- the seed on the helices
+  helix1.at(s1, x1, t1, k1);
+  helix2.at(s2, x2, t2, k2);
+
+  // -- closest points found so far
+  double bestDcaSq = distanceSq(x1, x2);
+  double bestS1 = s1, bestS2 = s2;
+  double bestX1[3] = {x1[0], x1[1], x1[2]};
+  double bestX2[3] = {x2[0], x2[1], x2[2]};
+
+  unsigned int nIterations = 0;
+  while (nIterations < nIterationsMax) {
+    double const d[3] = {x1[0]-x2[0], x1[1]-x2[1], x1[2]-x2[2]};
+
+    double const g1  =  d[0]*t1[0] + d[1]*t1[1] + d[2]*t1[2];
+    double const g2  = -d[0]*t2[0] - d[1]*t2[1] - d[2]*t2[2];
+    double const h11 = 1. + d[0]*k1[0] + d[1]*k1[1];
+    double const h22 = 1. - d[0]*k2[0] - d[1]*k2[1];
+    double const h12 = -(t1[0]*t2[0] + t1[1]*t2[1] + t1[2]*t2[2]);
+
+    // -- (almost) parallel or not at a minimum : keep what we have
+    double const det = h11*h22 - h12*h12;
+    if (det <= 1.e-12)
+      break;
+
+    double const ds1 = -( h22*g1 - h12*g2) / det;
+    double const ds2 = -(-h12*g1 + h11*g2) / det;
+
+    s1 += ds1;
+    s2 += ds2;
+    helix1.at(s1, x1, t1, k1);
+    helix2.at(s2, x2, t2, k2);
+    ++nIterations;
+
+    double const dcaSq = distanceSq(x1, x2);
+    if (dcaSq <= bestDcaSq) {
+      bestDcaSq = dcaSq;
+      bestS1 = s1;
+      bestS2 = s2;
+      for (int ii = 0; ii < 3; ++ii) {
+	bestX1[ii] = x1[ii];
+	bestX2[ii] = x2[ii];
+      }
+    }
+
+    if (std::fabs(ds1) < tolerance && std::fabs(ds2) < tolerance)
+      break;
+  }
+
+  kin.s1 = bestS1;
+  kin.s2 = bestS2;
+  kin.dcaDaughters = std::sqrt(bestDcaSq);
+
+  kin.v0[0] = 0.5 * (bestX1[0] + bestX2[0]);
+  kin.v0[1] = 0.5 * (bestX1[1] + bestX2[1]);
+  kin.v0[2] = 0.5 * (bestX1[2] + bestX2[2]);
+
+  return nIterations;
+}
+
+// _________________________________________________________
+float StHFPairKernel::cosAngle(float const ax, float const ay, float const az, 
+			       float const bx, float const by, float const bz) {
+  // -- cos of angle between a and b, in double precision 
+  //    to keep the resolution of angles close to 0
+
+  double const norm = (double(ax)*ax + double(ay)*ay + double(az)*az) * (double(bx)*bx + double(by)*by + double(bz)*bz);
+  if (!(norm > 0.))
+    return 1.;
+
+  return (double(ax)*bx + double(ay)*by + double(az)*bz) / std::sqrt(norm);
+}
+
+// _________________________________________________________
+unsigned int StHFPairKernel::batchWidth() {
+  // -- number of pairs calculated at a time by straightLineBatch
+
+#ifdef HF_VWIDTH
+  return HF_VWIDTH;
+#else
+  return 1;
+#endif
+}
+
+// _________________________________________________________
+void StHFPairKernel::straightLineBatch(StHFTrackTable const & table, unsigned int const row1, 
+				       int const * const rows2, unsigned int const nRows2, StHFPairBatch & batch) {
+  // -- straight line approximation for particle 1 and up to StHFPairBatch::kMaxSize 
+  //    particles 2, given by their rows in the table
+  //    entry i of the batch holds the pair of row1 and rows2[i]
+
+  unsigned int const nPairs = (nRows2 < StHFPairBatch::kMaxSize) ? nRows2 : StHFPairBatch::kMaxSize;
+
+#ifdef HF_VWIDTH
+  for (unsigned int offset = 0; offset < nPairs; offset += HF_VWIDTH) {
+    unsigned int const nLanes = (nPairs - offset < HF_VWIDTH) ? nPairs - offset : HF_VWIDTH;
+    straightLineBatchSimd(table, row1, rows2 + offset, nLanes, offset, batch);
+  }
+#else
+  straightLineBatchScalar(table, row1, rows2, nPairs, batch);
+#endif
+}
+
+// _________________________________________________________
+void StHFPairKernel::straightLineBatchScalar(StHFTrackTable const & table, unsigned int const row1, 
+					     int const * const rows2, unsigned int const nRows2, StHFPairBatch & batch) {
+  // -- scalar version of straightLineBatch, using straightLinePair
+
+  unsigned int const nPairs = (nRows2 < StHFPairBatch::kMaxSize) ? nRows2 : StHFPairBatch::kMaxSize;
+
+  for (unsigned int i = 0; i < nPairs; ++i) {
+    StHFPairKinematics kin;
+    straightLinePair(table, row1, rows2[i], kin);
+    fillBatchEntry(kin, i, batch);
+  }
+}
+
+// _________________________________________________________
+unsigned int StHFPairKernel::validateBatch(StHFTrackTable const & table, unsigned int const row1, 
+					   int const * const rows2, unsigned int const nRows2, float const tolerance) {
+  // -- compare straightLineBatch to the scalar kernel (as used by StHFPair)
+  //    returns the number of pairs with at least one quantity outside the tolerance
+
+  StHFPairBatch batch;
+  StHFPairBatch reference;
+
+  straightLineBatch(table, row1, rows2, nRows2, batch);
+  straightLineBatchScalar(table, row1, rows2, nRows2, reference);
+
+  unsigned int const nPairs = (nRows2 < StHFPairBatch::kMaxSize) ? nRows2 : StHFPairBatch::kMaxSize;
+  unsigned int nBad = 0;
+
+  for (unsigned int i = 0; i < nPairs; ++i) {
+    if (isOutsideTolerance(batch.dcaDaughters[i],     reference.dcaDaughters[i],     tolerance) ||
+	isOutsideTolerance(batch.v0x[i],              reference.v0x[i],              tolerance) ||
+	isOutsideTolerance(batch.v0y[i],              reference.v0y[i],              tolerance) ||
+	isOutsideTolerance(batch.v0z[i],              reference.v0z[i],              tolerance) ||
+	isOutsideTolerance(batch.decayLength[i],      reference.decayLength[i],      tolerance) ||
+	isOutsideTolerance(batch.cosPointingAngle[i], reference.cosPointingAngle[i], tolerance) ||
+	isOutsideTolerance(batch.px[i],               reference.px[i],               tolerance) ||
+	isOutsideTolerance(batch.py[i],               reference.py[i],               tolerance) ||
+	isOutsideTolerance(batch.pz[i],               reference.pz[i],               tolerance))
+      ++nBad;
+  }
+
+  return nBad;
+}
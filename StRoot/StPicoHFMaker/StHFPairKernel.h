@@ -0,0 +1,137 @@
+#ifndef StHFPairKernel_hh
+#define StHFPairKernel_hh
+
+/* **************************************************
+ *  Kernels calculating the topology of two-track pairs
+ *  directly from the arrays of StHFTrackTable
+ *
+ *  - straight line approximation at the DCA to the primary
+ *    vertex, as done in StHFPair and StKaonPion:
+ *     - path lengths of both tracks to their point of closest approach
+ *     - DCA between the daughters
+ *     - decay vertex, relative to the primary vertex
+ *     - daughter momenta at the decay vertex, rotated along
+ *       the helix of the track by the path length
+ *    straightLinePair does both, straightLineDca and rotateMomenta
+ *    do one step each, to allow rejecting pairs before the rotation
+ *
+ *  - single precision path : the same straight line approximation in
+ *    float only, on two StHFHelixF loaded from the table rows
+ *      straightLineDca(helix1, helix2, kin), rotateMomenta(helix1, helix2, kin)
+ *      straightLinePairSingle(table, row1, row2, kin)
+ *    selected via ePrecision (StHFCuts::setKinematicsPrecision, 
+ *    StKaonPion, StPicoD0EventMaker::setKinematicsPrecision). 
+ *    Deviations from the double precision path are reported 
+ *    per stored variable by hfKinematicsBenchmark
+ *
+ *  - helix refinement of the straight line DCA : refineHelixDca(...)
+ *    does Newton steps in the path lengths on the helices of both
+ *    tracks, seeded by the path lengths of straightLineDca
+ *     - at most nIterationsMax steps, stops earlier if the step 
+ *       is smaller than the tolerance (in cm) 
+ *     - the closest points on the helices of the seed and of all
+ *       steps are kept, a diverging step can not make it worse
+ *     - s1, s2, dcaDaughters and v0 are updated, rotateMomenta 
+ *       afterwards gives the momenta at the refined DCA points
+ *    corrects the decay vertex of low pT daughters, where the straight
+ *    lines deviate from the helices over the decay length
+ *
+ *  - batch kernel for one particle 1 and a block of up to
+ *    StHFPairBatch::kMaxSize particles 2, in single precision:
+ *     - path lengths, DCA between the daughters, decay vertex,
+ *       decay length, cos(pointing angle) and pair momentum
+ *     - vectorized with AVX-512 (16 pairs) or AVX2 (8 pairs), if the
+ *       library is compiled with -mavx512f or -mavx2, otherwise
+ *       a scalar loop over straightLinePair is used
+ *     - batchWidth() returns the number of pairs computed at a time
+ *     - validateBatch(...) compares the batch results to the scalar
+ *       (double precision) kernel within a relative tolerance.
+ *       Path lengths of almost parallel daughters are badly conditioned,
+ *       for those differences of a few 1e-3 are seen in single precision
+ *
+ *  - cosAngle(...) : cos of the angle between two vectors in double
+ *    precision, used for the stored cos(pointing angle) of the candidates
+ *
+ *  - all positions are relative to the primary vertex
+ *  - the kernels do not depend on STAR libraries
+ *
+ * **************************************************
+ */
+
+class StHFTrackTable;
+class StHFHelixF;
+
+struct StHFPairKinematics
+{
+  float s1;              // path length of particle 1 to DCA point
+  float s2;              // path length of particle 2 to DCA point
+  float dcaDaughters;    // DCA between particle 1 and 2
+  float v0[3];           // decay vertex relative to primary vertex
+  float p1Mom[3];        // momentum of particle 1 at its DCA point
+  float p2Mom[3];        // momentum of particle 2 at its DCA point
+};
+
+struct StHFPairBatch
+{
+  enum {kMaxSize = 16};
+
+  float s1[kMaxSize];               // path length of particle 1 to DCA point
+  float s2[kMaxSize];               // path length of particle 2 to DCA point
+  float dcaDaughters[kMaxSize];     // DCA between particle 1 and 2
+  float v0x[kMaxSize];              // decay vertex relative to primary vertex
+  float v0y[kMaxSize];
+  float v0z[kMaxSize];
+  float decayLength[kMaxSize];      // distance of decay vertex to primary vertex
+  float cosPointingAngle[kMaxSize]; // cos of angle between decay vertex and pair momentum
+  float px[kMaxSize];               // pair momentum at the decay vertex
+  float py[kMaxSize];
+  float pz[kMaxSize];
+};
+
+namespace StHFPairKernel
+{
+  // -- c_light in GeV/(kG cm), for curvature = c_light * |q * B| / pT
+  float const cLight = 2.99792458e-4;
+
+  // -- precision of the straight line kinematics
+  enum ePrecision {kDoublePrecision, kSinglePrecision};
+
+  // -- Newton steps of refineHelixDca until convergence (StHFCuts::kHelixFull)
+  unsigned int const helixFullIterationsMax = 20;
+  float const        helixFullTolerance     = 1.e-5;  // cm
+
+  void straightLinePair(StHFTrackTable const & table, unsigned int row1, unsigned int row2,
+			StHFPairKinematics & kin);
+
+  // -- the two stages of straightLinePair
+  void straightLineDca(StHFTrackTable const & table, unsigned int row1, unsigned int row2,
+		       StHFPairKinematics & kin);
+  void rotateMomenta(StHFTrackTable const & table, unsigned int row1, unsigned int row2,
+		     StHFPairKinematics & kin);
+
+  // -- single precision path
+  void straightLinePairSingle(StHFTrackTable const & table, unsigned int row1, unsigned int row2,
+			      StHFPairKinematics & kin);
+  void straightLineDca(StHFHelixF const & helix1, StHFHelixF const & helix2, StHFPairKinematics & kin);
+  void rotateMomenta(StHFHelixF const & helix1, StHFHelixF const & helix2, StHFPairKinematics & kin);
+
+  // -- helix refinement, between straightLineDca and rotateMomenta
+  //    returns the number of Newton steps done
+  unsigned int refineHelixDca(StHFTrackTable const & table, unsigned int row1, unsigned int row2,
+			      unsigned int nIterationsMax, float tolerance, StHFPairKinematics & kin);
+
+  // -- cos of angle between a and b, 1 if one of them is a null vector (as StThreeVector::angle)
+  float cosAngle(float ax, float ay, float az, float bx, float by, float bz);
+
+  unsigned int batchWidth();
+
+  void straightLineBatch(StHFTrackTable const & table, unsigned int row1, 
+			 int const * rows2, unsigned int nRows2, StHFPairBatch & batch);
+
+  void straightLineBatchScalar(StHFTrackTable const & table, unsigned int row1, 
+			       int const * rows2, unsigned int nRows2, StHFPairBatch & batch);
+
+  unsigned int validateBatch(StHFTrackTable const & table, unsigned int row1, 
+			     int const * rows2, unsigned int nRows2, float tolerance = 1.e-2);
+}
+#endif
@@ -0,0 +1,139 @@
+#include <fstream>
+#include <iomanip>
+
+#include "TH1D.h"
+
+#include "StHFStageProfiler.h"
+
+namespace {
+  // _________________________________________________________
+  int findName(std::vector<std::string> const & names, std::string const & name) {
+    for (unsigned int ii = 0; ii < names.size(); ++ii)
+      if (names[ii] == name)
+	return ii;
+    return -1;
+  }
+
+  // _________________________________________________________
+  std::string jsonString(std::string const & str) {
+    std::string quoted = "\"";
+    for (unsigned int ii = 0; ii < str.size(); ++ii) {
+      if (str[ii] == '"' || str[ii] == '\\')
+	quoted += '\\';
+      quoted += str[ii];
+    }
+    return quoted + "\"";
+  }
+}
+
+// _________________________________________________________
+StHFStageProfiler::StHFStageProfiler() : mEnabled(false), 
+  mStageNames(), mStageSeconds(), mStageStart(), mStageCalls(),
+  mCounterNames(), mCounterValues() {
+}
+
+// _________________________________________________________
+int StHFStageProfiler::addStage(char const* name) {
+  // -- register stage, returns id of existing stage with same name
+
+  int const idx = findName(mStageNames, name);
+  if (idx >= 0)
+    return idx;
+
+  mStageNames.push_back(name);
+  mStageSeconds.push_back(0.);
+  mStageStart.push_back(0.);
+  mStageCalls.push_back(0);
+
+  return mStageNames.size() - 1;
+}
+
+// _________________________________________________________
+int StHFStageProfiler::addCounter(char const* name) {
+  // -- register counter, returns id of existing counter with same name
+
+  int const idx = findName(mCounterNames, name);
+  if (idx >= 0)
+    return idx;
+
+  mCounterNames.push_back(name);
+  mCounterValues.push_back(0);
+
+  return mCounterNames.size() - 1;
+}
+
+// _________________________________________________________
+void StHFStageProfiler::add(StHFStageProfiler const & profiler) {
+  // -- add times and counts of profiler, matched by name
+
+  for (unsigned int ii = 0; ii < profiler.nStages(); ++ii) {
+    int const idx = addStage(profiler.stageName(ii));
+    mStageSeconds[idx] += profiler.mStageSeconds[ii];
+    mStageCalls[idx]   += profiler.mStageCalls[ii];
+  }
+
+  for (unsigned int ii = 0; ii < profiler.nCounters(); ++ii) {
+    int const idx = addCounter(profiler.counterName(ii));
+    mCounterValues[idx] += profiler.mCounterValues[ii];
+  }
+}
+
+// _________________________________________________________
+TH1D* StHFStageProfiler::createTimeHistogram(char const* name) const {
+  // -- seconds per stage, one labeled bin per stage
+  //    not attached to a directory, caller owns it
+
+  unsigned int const nBins = nStages() > 0 ? nStages() : 1;
+  TH1D* hist = new TH1D(name, "time per stage;;t (s)", nBins, 0, nBins);
+  hist->SetDirectory(NULL);
+
+  for (unsigned int ii = 0; ii < nStages(); ++ii) {
+    hist->GetXaxis()->SetBinLabel(ii+1, stageName(ii));
+    hist->SetBinContent(ii+1, mStageSeconds[ii]);
+  }
+
+  return hist;
+}
+
+// _________________________________________________________
+TH1D* StHFStageProfiler::createCounterHistogram(char const* name) const {
+  // -- value per counter, one labeled bin per counter
+  //    not attached to a directory, caller owns it
+
+  unsigned int const nBins = nCounters() > 0 ? nCounters() : 1;
+  TH1D* hist = new TH1D(name, "counters;;counts", nBins, 0, nBins);
+  hist->SetDirectory(NULL);
+
+  for (unsigned int ii = 0; ii < nCounters(); ++ii) {
+    hist->GetXaxis()->SetBinLabel(ii+1, counterName(ii));
+    hist->SetBinContent(ii+1, static_cast<double>(mCounterValues[ii]));
+  }
+
+  return hist;
+}
+
+// _________________________________________________________
+bool StHFStageProfiler::writeJson(char const* fileName, char const* makerName) const {
+  // -- machine-readable report :
+  //    {"maker": ..., "stages": {<name>: {"calls": n, "seconds": t}, ...}, "counters": {<name>: n, ...}}
+
+  std::ofstream out(fileName);
+  if (!out.is_open())
+    return false;
+
+  out << std::setprecision(9);
+  out << "{\n  \"maker\": " << jsonString(makerName) << ",\n";
+
+  out << "  \"stages\": {";
+  for (unsigned int ii = 0; ii < nStages(); ++ii)
+    out << (ii ? ",\n    " : "\n    ") << jsonString(mStageNames[ii]) 
+	<< ": {\"calls\": " << mStageCalls[ii] << ", \"seconds\": " << mStageSeconds[ii] << "}";
+  out << "\n  },\n";
+
+  out << "  \"counters\": {";
+  for (unsigned int ii = 0; ii < nCounters(); ++ii)
+    out << (ii ? ",\n    " : "\n    ") << jsonString(mCounterNames[ii]) << ": " << mCounterValues[ii];
+  out << "\n  }\n}\n";
+
+  return out.good();
+}
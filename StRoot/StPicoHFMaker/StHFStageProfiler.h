@@ -0,0 +1,130 @@
+#ifndef StHFStageProfiler_hh
+#define StHFStageProfiler_hh
+
+/* **************************************************
+ *  Timers and counters per processing stage
+ *
+ *  - stages and counters are registered by name via addStage(...) and
+ *    addCounter(...), which return the id used in start(id), stop(id)
+ *    and count(id, n)
+ *  - StHFStageTimer starts a stage timer and stops it at the end of its scope
+ *  - timers use the monotonic clock, times of nested stages are 
+ *    included in the outer stage
+ *  - switched off by default, switch on at run time via setEnabled(true).
+ *    Switched off, every call returns after testing one flag
+ *  - compiled with -DST_HF_NO_PROFILING all calls are empty, 
+ *    isEnabled() is always false
+ *  - add(...) adds stages and counters of another profiler (same names),
+ *    used to merge the profilers of threads
+ *  - summary as histograms createTimeHistogram(...), createCounterHistogram(...)
+ *    and as JSON report writeJson(...)
+ *
+ * **************************************************
+ */
+
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include "Rtypes.h"
+
+class TH1D;
+
+class StHFStageProfiler
+{
+ public:
+  StHFStageProfiler();
+  ~StHFStageProfiler() {;}
+
+  void setEnabled(bool b);
+  bool isEnabled() const;
+
+  int  addStage(char const* name);
+  int  addCounter(char const* name);
+
+  void start(int stage);
+  void stop(int stage);
+  void count(int counter, ULong64_t n = 1);
+
+  void add(StHFStageProfiler const & profiler);
+
+  TH1D* createTimeHistogram(char const* name) const;
+  TH1D* createCounterHistogram(char const* name) const;
+  bool  writeJson(char const* fileName, char const* makerName) const;
+
+  unsigned int       nStages()                     const;
+  char const *       stageName(unsigned int idx)   const;
+  double             stageSeconds(unsigned int idx) const;
+  ULong64_t stageCalls(unsigned int idx)  const;
+
+  unsigned int       nCounters()                   const;
+  char const *       counterName(unsigned int idx) const;
+  ULong64_t counterValue(unsigned int idx) const;
+
+  static double now();
+
+ private:
+  bool mEnabled;
+
+  std::vector<std::string>        mStageNames;
+  std::vector<double>             mStageSeconds;
+  std::vector<double>             mStageStart;
+  std::vector<ULong64_t> mStageCalls;
+
+  std::vector<std::string>        mCounterNames;
+  std::vector<ULong64_t> mCounterValues;
+};
+
+// _________________________________________________________
+class StHFStageTimer
+{
+ public:
+  StHFStageTimer(StHFStageProfiler & profiler, int stage) : mProfiler(profiler), mStage(stage) { mProfiler.start(mStage); }
+  ~StHFStageTimer() { mProfiler.stop(mStage); }
+
+ private:
+  StHFStageTimer(StHFStageTimer const &);
+  StHFStageTimer& operator=(StHFStageTimer const &);
+
+  StHFStageProfiler & mProfiler;
+  int                 mStage;
+};
+
+inline void StHFStageProfiler::setEnabled(bool b) { mEnabled = b; }
+
+#ifdef ST_HF_NO_PROFILING
+inline bool StHFStageProfiler::isEnabled() const { return false; }
+#else
+inline bool StHFStageProfiler::isEnabled() const { return mEnabled; }
+#endif
+
+inline double StHFStageProfiler::now() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1.e-9 * ts.tv_nsec;
+}
+
+inline void StHFStageProfiler::start(int stage) {
+  if (!isEnabled()) return;
+  mStageStart[stage] = now();
+}
+
+inline void StHFStageProfiler::stop(int stage) {
+  if (!isEnabled()) return;
+  mStageSeconds[stage] += now() - mStageStart[stage];
+  ++mStageCalls[stage];
+}
+
+inline void StHFStageProfiler::count(int counter, ULong64_t n) {
+  if (!isEnabled()) return;
+  mCounterValues[counter] += n;
+}
+
+inline unsigned int       StHFStageProfiler::nStages()                      const { return mStageNames.size(); }
+inline char const *       StHFStageProfiler::stageName(unsigned int idx)    const { return mStageNames[idx].c_str(); }
+inline double             StHFStageProfiler::stageSeconds(unsigned int idx) const { return mStageSeconds[idx]; }
+inline ULong64_t          StHFStageProfiler::stageCalls(unsigned int idx)   const { return mStageCalls[idx]; }
+inline unsigned int       StHFStageProfiler::nCounters()                    const { return mCounterNames.size(); }
+inline char const *       StHFStageProfiler::counterName(unsigned int idx)  const { return mCounterNames[idx].c_str(); }
+inline ULong64_t          StHFStageProfiler::counterValue(unsigned int idx) const { return mCounterValues[idx]; }
+#endif
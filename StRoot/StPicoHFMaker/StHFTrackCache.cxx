@@ -0,0 +1,111 @@
+#include <limits>
+
+#include "StHFTrackCache.h"
+#include "StHFTrackTable.h"
+
+#include "StThreeVectorF.hh"
+#include "StPhysicalHelixD.hh"
+#include "SystemOfUnits.h"
+#include "StPicoDstMaker/StPicoTrack.h"
+
+// _________________________________________________________
+StHFCachedTrack::StHFCachedTrack() : mTrack(NULL), mHelix(), mMomentum(), mOrigin(),
+  mDca(std::numeric_limits<float>::quiet_NaN()), mCharge(0), mId(-1),
+  mIdx(std::numeric_limits<unsigned short>::max()) {
+}
+
+// _________________________________________________________
+StHFCachedTrack::StHFCachedTrack(StPicoTrack const * const trk, unsigned short const idx,
+				 StThreeVectorF const & vtx, float const bField) :
+  mTrack(trk), mHelix(trk->dcaGeometry().helix()), mMomentum(), mOrigin(),
+  mDca(std::numeric_limits<float>::quiet_NaN()), mCharge(trk->charge()), mId(trk->id()), mIdx(idx) {
+  setup(vtx, bField);
+}
+
+// _________________________________________________________
+StHFCachedTrack::StHFCachedTrack(StPhysicalHelixD const & helix, short const charge, int const id, unsigned short const idx,
+				 StThreeVectorF const & vtx, float const bField) :
+  mTrack(NULL), mHelix(helix), mMomentum(), mOrigin(),
+  mDca(std::numeric_limits<float>::quiet_NaN()), mCharge(charge), mId(id), mIdx(idx) {
+  setup(vtx, bField);
+}
+
+// _________________________________________________________
+void StHFCachedTrack::setup(StThreeVectorF const & vtx, float const bField) {
+  // -- move origin of helix to the primary vertex origin
+  mHelix.moveOrigin(mHelix.pathLength(vtx));
+
+  mMomentum = mHelix.momentum(bField * kilogauss);
+  mOrigin   = mHelix.origin();
+
+  // -- DCA of track to primary vertex
+  mDca = (mHelix.origin() - vtx).mag();
+}
+
+// _________________________________________________________
+StPhysicalHelixD StHFCachedTrack::straightLine() const {
+  // -- straight line through the DCA point to the primary vertex, along the momentum there
+  return StPhysicalHelixD(mMomentum, mHelix.origin(), 0, mCharge);
+}
+
+// _________________________________________________________
+int StHFCachedTrack::addToTable(StHFTrackTable & table, float const tofBeta) const {
+  // -- add track as row to the structure-of-arrays table
+  //    DCA point is stored relative to the primary vertex of the table
+  //    (without StPicoTrack, the nSigma are 0)
+
+  return table.addTrack(mIdx, mId,
+			mHelix.origin().x() - table.vtxX(), mHelix.origin().y() - table.vtxY(), mHelix.origin().z() - table.vtxZ(),
+			mMomentum.x(), mMomentum.y(), mMomentum.z(), mCharge,
+			mTrack ? mTrack->nSigmaPion()   : 0.f, 
+			mTrack ? mTrack->nSigmaKaon()   : 0.f, 
+			mTrack ? mTrack->nSigmaProton() : 0.f, tofBeta);
+}
+
+// _________________________________________________________
+StHFLineDca::StHFLineDca() : atLine1(), atLine2(), dca(std::numeric_limits<float>::max()) {
+}
+
+// _________________________________________________________
+StHFLineDca::StHFLineDca(StPhysicalHelixD const & line1, StPhysicalHelixD const & line2) : 
+  atLine1(), atLine2(), dca(std::numeric_limits<float>::max()) {
+  // -- points of closest approach of two straight lines and their distance
+
+  std::pair<double, double> const ss = line1.pathLengths(line2);
+  atLine1 = line1.at(ss.first);
+  atLine2 = line2.at(ss.second);
+  dca = (atLine1 - atLine2).mag();
+}
+
+// _________________________________________________________
+StHFTrackCache::StHFTrackCache() : mPrimVtx(), mBField(0.), mTracks(), mSlot() {
+}
+
+// _________________________________________________________
+void StHFTrackCache::reset(unsigned int const nTracks, StThreeVectorF const & vtx, float const bField) {
+  // -- prepare cache for a new event
+  //    reserve space for all tracks, so that entries never get reallocated
+
+  mPrimVtx = vtx;
+  mBField  = bField;
+
+  mTracks.clear();
+  mTracks.reserve(nTracks);
+
+  mSlot.assign(nTracks, -1);
+}
+
+// _________________________________________________________
+StHFCachedTrack const * StHFTrackCache::add(StPicoTrack const * const trk, unsigned short const idx) {
+  // -- add track to the cache, if it is not cached yet
+
+  if (!trk || idx >= mSlot.size())
+    return NULL;
+
+  if (mSlot[idx] < 0) {
+    mSlot[idx] = mTracks.size();
+    mTracks.push_back(StHFCachedTrack(trk, idx, mPrimVtx, mBField));
+  }
+
+  return &mTracks[mSlot[idx]];
+}
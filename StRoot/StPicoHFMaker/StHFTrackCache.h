@@ -0,0 +1,133 @@
+#ifndef StHFTrackCache_hh
+#define StHFTrackCache_hh
+
+/* **************************************************
+ *  Event-wise cache of track quantities used to build
+ *  pairs and triplets in HF analysis
+ *
+ *  - StHFCachedTrack holds for one track
+ *     - its helix, with the origin moved to the DCA to the primary vertex
+ *     - its momentum at the DCA to the primary vertex
+ *     - its DCA to the primary vertex
+ *     - its charge, id and index in the StPicoDst track array
+ *    it can also be created from a helix directly (e.g. for generated
+ *    tracks in standalone benchmarks), then track() is NULL
+ *
+ *  - StHFTrackCache holds one StHFCachedTrack per track of the event
+ *     - reset(...) has to be called at the beginning of every event
+ *     - add(...) creates the entry of a track (only once per track)
+ *     - get(...) returns the entry of a track by its StPicoDst index,
+ *       or NULL if the track was not added
+ *
+ *  The helix setup of a track is done only once per event, independent
+ *  of how many pairs or triplets the track is used in.
+ *
+ *  StHFCachedTrack::addToTable(...) copies the entry into the 
+ *  structure-of-arrays StHFTrackTable.
+ *
+ *  - StHFLineDca holds the points of closest approach of the straight
+ *    lines (StHFCachedTrack::straightLine()) of two tracks and their
+ *    distance, as used for the daughters of StHFTriplet
+ *
+ * **************************************************
+ */
+
+#include <vector>
+
+#include "StThreeVectorF.hh"
+#include "StPhysicalHelixD.hh"
+
+class StPicoTrack;
+class StHFTrackTable;
+
+class StHFCachedTrack
+{
+ public:
+  StHFCachedTrack();
+  StHFCachedTrack(StPicoTrack const * trk, unsigned short idx,
+		  StThreeVectorF const & vtx, float bField);
+  StHFCachedTrack(StPhysicalHelixD const & helix, short charge, int id, unsigned short idx,
+		  StThreeVectorF const & vtx, float bField);
+  ~StHFCachedTrack() {;}
+
+  StPhysicalHelixD const & helix()    const;
+  StThreeVectorF   const & momentum() const;
+  StThreeVectorF   const & origin()   const;
+  float                    dca()      const;
+  short                    charge()   const;
+  int                      id()       const;
+  unsigned short           idx()      const;
+  StPicoTrack      const * track()    const;
+
+  StPhysicalHelixD straightLine() const;
+
+  int addToTable(StHFTrackTable & table, float tofBeta) const;
+
+ private:
+  void setup(StThreeVectorF const & vtx, float bField);
+
+  StPicoTrack const * mTrack;    // ptr to track in StPicoDst, NULL if created from a helix
+
+  StPhysicalHelixD mHelix;       // helix, origin moved to DCA to primary vertex
+  StThreeVectorF   mMomentum;    // momentum at DCA to primary vertex
+  StThreeVectorF   mOrigin;      // DCA point to primary vertex
+
+  float            mDca;         // DCA to primary vertex
+  short            mCharge;
+  int              mId;
+  unsigned short   mIdx;         // index of track in StPicoDst
+};
+
+inline StPhysicalHelixD const & StHFCachedTrack::helix()    const { return mHelix; }
+inline StThreeVectorF   const & StHFCachedTrack::momentum() const { return mMomentum; }
+inline StThreeVectorF   const & StHFCachedTrack::origin()   const { return mOrigin; }
+inline float                    StHFCachedTrack::dca()      const { return mDca; }
+inline short                    StHFCachedTrack::charge()   const { return mCharge; }
+inline int                      StHFCachedTrack::id()       const { return mId; }
+inline unsigned short           StHFCachedTrack::idx()      const { return mIdx; }
+inline StPicoTrack      const * StHFCachedTrack::track()    const { return mTrack; }
+
+// _________________________________________________________
+struct StHFLineDca
+{
+  StHFLineDca();
+  StHFLineDca(StPhysicalHelixD const & line1, StPhysicalHelixD const & line2);
+
+  StThreeVectorF atLine1;  // point of line 1 at the DCA to line 2
+  StThreeVectorF atLine2;  // point of line 2 at the DCA to line 1
+  float          dca;
+};
+
+// _________________________________________________________
+class StHFTrackCache
+{
+ public:
+  StHFTrackCache();
+  ~StHFTrackCache() {;}
+
+  void                    reset(unsigned int nTracks, StThreeVectorF const & vtx, float bField);
+  StHFCachedTrack const * add(StPicoTrack const * trk, unsigned short idx);
+  StHFCachedTrack const * get(unsigned short idx) const;
+
+  unsigned int            size() const;
+  StHFCachedTrack const & at(unsigned int i) const;
+
+ private:
+  StHFTrackCache(StHFTrackCache const &);
+  StHFTrackCache& operator=(StHFTrackCache const &);
+
+  StThreeVectorF               mPrimVtx;
+  float                        mBField;
+
+  std::vector<StHFCachedTrack> mTracks; // cached tracks - capacity is reserved in reset(),
+                                        // so that pointers stay valid for the whole event
+  std::vector<int>             mSlot;   // position in mTracks, per StPicoDst index (-1 if not cached)
+};
+
+inline unsigned int            StHFTrackCache::size() const             { return mTracks.size(); }
+inline StHFCachedTrack const & StHFTrackCache::at(unsigned int i) const { return mTracks[i]; }
+
+inline StHFCachedTrack const * StHFTrackCache::get(unsigned short idx) const {
+  return (idx < mSlot.size() && mSlot[idx] >= 0) ? &mTracks[mSlot[idx]] : NULL;
+}
+#endif
@@ -0,0 +1,183 @@
+#include "phys_constants.h"
+
+#include "StHFTrackSelection.h"
+#include "StHFCuts.h"
+#include "StHFCutPredicates.h"
+
+namespace {
+  // -- loops over all tracks, compiled for the specialised predicate (see StHFCutPredicates)
+
+  struct TrackLoop {
+    unsigned int nTracks;
+    unsigned char const * isHFTTrack;
+    int const * nHitsFit;
+    unsigned int * masks;
+    
+    template <class Pred> void operator()(Pred const & pred) {
+      for (unsigned int ii = 0; ii < nTracks; ++ii)
+	masks[ii] = pred(isHFTTrack[ii], nHitsFit[ii]) << StHFTrackSelection::kGoodTrack;
+    }
+  };
+    
+  struct TPCLoop {
+    unsigned int nTracks;
+    float const * pt;
+    float const * eta;
+    float const * nSigma;
+    unsigned int * masks;
+    int bit;
+
+    template <class Pred> void operator()(Pred const & pred) {
+      for (unsigned int ii = 0; ii < nTracks; ++ii)
+	masks[ii] |= pred(pt[ii], eta[ii], nSigma[ii]) << bit;
+    }
+  };
+
+  struct TOFLoop {
+    unsigned int nTracks;
+    float const * pt;
+    float const * p;
+    float const * tofBeta;
+    unsigned int * masks;
+    int bit;
+
+    template <class Pred> void operator()(Pred const & pred) {
+      for (unsigned int ii = 0; ii < nTracks; ++ii)
+	masks[ii] |= pred(pt[ii], p[ii], tofBeta[ii]) << bit;
+    }
+  };
+}
+
+// _________________________________________________________
+StHFTrackSelection::StHFTrackSelection() : mIdx(), mPt(), mEta(), mP(), mTofBeta(), 
+  mNSigmaPion(), mNSigmaKaon(), mNSigmaProton(), mNHitsFit(), mIsHFTTrack(), mMasks() {
+}
+
+// _________________________________________________________
+void StHFTrackSelection::addRequirement(int const particle, unsigned int const bits) {
+  // -- add alternative set of bits which selects particle, kGoodTrack is always required
+  mRequirements[particle].push_back(bits | bit(kGoodTrack));
+}
+
+// _________________________________________________________
+void StHFTrackSelection::clearRequirements() {
+  for (int iParticle = 0; iParticle < kParticleMax; ++iParticle)
+    mRequirements[iParticle].clear();
+}
+
+// _________________________________________________________
+bool StHFTrackSelection::hasRequirements() const {
+  for (int iParticle = 0; iParticle < kParticleMax; ++iParticle)
+    if (!mRequirements[iParticle].empty())
+      return true;
+  return false;
+}
+
+// _________________________________________________________
+void StHFTrackSelection::reset(unsigned int const nTracks) {
+  // -- start new event, memory of previous events is reused
+
+  mIdx.clear();
+  mPt.clear();
+  mEta.clear();
+  mP.clear();
+  mTofBeta.clear();
+  mNSigmaPion.clear();
+  mNSigmaKaon.clear();
+  mNSigmaProton.clear();
+  mNHitsFit.clear();
+  mIsHFTTrack.clear();
+  mMasks.clear();
+
+  mIdx.reserve(nTracks);
+  mPt.reserve(nTracks);
+  mEta.reserve(nTracks);
+  mP.reserve(nTracks);
+  mTofBeta.reserve(nTracks);
+  mNSigmaPion.reserve(nTracks);
+  mNSigmaKaon.reserve(nTracks);
+  mNSigmaProton.reserve(nTracks);
+  mNHitsFit.reserve(nTracks);
+  mIsHFTTrack.reserve(nTracks);
+  mMasks.reserve(nTracks);
+}
+
+// _________________________________________________________
+void StHFTrackSelection::addTrack(unsigned short const idx, float const pt, float const eta, float const p, float const tofBeta,
+				  float const nSigmaPion, float const nSigmaKaon, float const nSigmaProton, 
+				  int const nHitsFit, bool const isHFTTrack) {
+  mIdx.push_back(idx);
+  mPt.push_back(pt);
+  mEta.push_back(eta);
+  mP.push_back(p);
+  mTofBeta.push_back(tofBeta);
+  mNSigmaPion.push_back(nSigmaPion);
+  mNSigmaKaon.push_back(nSigmaKaon);
+  mNSigmaProton.push_back(nSigmaProton);
+  mNHitsFit.push_back(nHitsFit);
+  mIsHFTTrack.push_back(isHFTTrack);
+  mMasks.push_back(0);
+}
+
+// _________________________________________________________
+void StHFTrackSelection::evaluate(StHFCuts const & cuts) {
+  // -- evaluate track and PID cuts for all tracks, one loop per cut type
+  //    with predicates specialised on the bounds set in cuts
+
+  unsigned int const nTracks = size();
+  if (!nTracks)
+    return;
+
+  unsigned int * const masks = &mMasks[0];
+
+  // -- good track
+  TrackLoop trackLoop = {nTracks, &mIsHFTTrack[0], &mNHitsFit[0], masks};
+  StHFCutPredicates::dispatchTrack(cuts, trackLoop);
+
+  // -- TPC
+  float const * const aNSigma[kParticleMax] = {&mNSigmaPion[0], &mNSigmaKaon[0], &mNSigmaProton[0]};
+  int   const         aTPCBit[kParticleMax] = {kTPCPion, kTPCKaon, kTPCProton};
+
+  for (int iParticle = 0; iParticle < kParticleMax; ++iParticle) {
+    TPCLoop tpcLoop = {nTracks, &mPt[0], &mEta[0], aNSigma[iParticle], masks, aTPCBit[iParticle]};
+    StHFCutPredicates::dispatchTPC(cuts, iParticle, tpcLoop);
+  }
+
+  // -- TOF
+  double const aMass[kParticleMax]  = {M_PION_PLUS, M_KAON_PLUS, M_PROTON};
+  int   const aTOFBit[kParticleMax] = {kTOFPion, kTOFKaon, kTOFProton};
+
+  for (int iParticle = 0; iParticle < kParticleMax; ++iParticle) {
+    TOFLoop tofLoop = {nTracks, &mPt[0], &mP[0], &mTofBeta[0], masks, aTOFBit[iParticle]};
+    StHFCutPredicates::dispatchTOF(cuts, iParticle, aMass[iParticle], tofLoop);
+  }
+}
+
+// _________________________________________________________
+void StHFTrackSelection::select(std::vector<unsigned short> & pions, std::vector<unsigned short> & kaons, 
+				std::vector<unsigned short> & protons, std::vector<unsigned int> & selected) const {
+  // -- fill index lists of particles in one sweep, 
+  //    selected gets the entries selected as any particle
+
+  std::vector<unsigned short> * aLists[kParticleMax] = {&pions, &kaons, &protons};
+
+  for (unsigned int ii = 0; ii < size(); ++ii) {
+    unsigned int const mask = mMasks[ii];
+    unsigned int bSelected = 0;
+
+    for (int iParticle = 0; iParticle < kParticleMax; ++iParticle) {
+      std::vector<unsigned int> const & requirements = mRequirements[iParticle];
+
+      unsigned int bPass = 0;
+      for (unsigned int iReq = 0; iReq < requirements.size(); ++iReq)
+	bPass |= ((mask & requirements[iReq]) == requirements[iReq]);
+
+      if (bPass)
+	aLists[iParticle]->push_back(mIdx[ii]);
+      bSelected |= bPass;
+    }
+
+    if (bSelected)
+      selected.push_back(ii);
+  }
+}
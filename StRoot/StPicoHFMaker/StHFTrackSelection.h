@@ -0,0 +1,108 @@
+#ifndef StHFTrackSelection_hh
+#define StHFTrackSelection_hh
+
+/* **************************************************
+ *  Batched track selection for HF analysis
+ *
+ *  - fill(...) : the quantities used by the track and PID cuts are 
+ *    computed once per track and stored in contiguous arrays
+ *    (pt, eta, |p|, TOF beta, nSigma, nHitsFit, HFT flag)
+ *  - evaluate(cuts) : the track and PID cuts of StHFCuts are evaluated
+ *    for all tracks in branch-free loops, the results are stored as 
+ *    bits of one mask per track (see eTrackBit), with the same results
+ *    as StHFCuts::isGoodTrack, isTPCPion, ..., isTOFProton
+ *  - custom predicates can set the bits kUserBit, kUserBit+1, ... 
+ *    via masks(), looping over the arrays
+ *  - select(...) : one sweep over all tracks fills the index lists 
+ *    of pions, kaons and protons
+ *     - a particle is selected, if its mask contains all bits of at least
+ *       one of its requirements, set via addRequirement(particle, bits).
+ *       kGoodTrack is always required (as in the track-by-track selection)
+ *     - e.g. pion  : addRequirement(kPion, bit(kTPCPion))
+ *                    addRequirement(kPion, bit(kTOFPion))  -> TPC or TOF pion
+ *     - no requirement for a particle : no tracks selected 
+ *
+ *  - the class does not depend on StPicoTrack, it is filled by StPicoHFMaker
+ *
+ * **************************************************
+ */
+
+#include <cstddef>
+#include <vector>
+
+class StHFCuts;
+
+class StHFTrackSelection
+{
+ public:
+  enum eTrackBit {kGoodTrack, kTPCPion, kTPCKaon, kTPCProton, kTOFPion, kTOFKaon, kTOFProton, kUserBit = 16};
+  enum eParticle {kPion, kKaon, kProton, kParticleMax};
+
+  StHFTrackSelection();
+  ~StHFTrackSelection() {;}
+
+  // -- setup, once
+  void addRequirement(int particle, unsigned int bits);
+  void clearRequirements();
+  bool hasRequirements() const;
+
+  // -- per event
+  void reset(unsigned int nTracks);
+  void addTrack(unsigned short idx, float pt, float eta, float p, float tofBeta,
+		float nSigmaPion, float nSigmaKaon, float nSigmaProton, int nHitsFit, bool isHFTTrack);
+  void evaluate(StHFCuts const & cuts);
+  void select(std::vector<unsigned short> & pions, std::vector<unsigned short> & kaons, 
+	      std::vector<unsigned short> & protons, std::vector<unsigned int> & selected) const;
+
+  static unsigned int bit(int trackBit);
+
+  // -- arrays, valid for entries [0, size())
+  unsigned int           size()         const;
+  unsigned short const * idx()          const;
+  float const *          pt()           const;
+  float const *          eta()          const;
+  float const *          p()            const;
+  float const *          tofBeta()      const;
+  float const *          nSigmaPion()   const;
+  float const *          nSigmaKaon()   const;
+  float const *          nSigmaProton() const;
+  int const *            nHitsFit()     const;
+  unsigned char const *  isHFTTrack()   const;
+  unsigned int *         masks();
+  unsigned int const *   masks()        const;
+
+ private:
+  StHFTrackSelection(StHFTrackSelection const &);
+  StHFTrackSelection& operator=(StHFTrackSelection const &);
+
+  std::vector<unsigned int> mRequirements[kParticleMax]; // alternatives of required bits
+
+  std::vector<unsigned short> mIdx;        // index in StPicoDst
+  std::vector<float>          mPt;
+  std::vector<float>          mEta;
+  std::vector<float>          mP;
+  std::vector<float>          mTofBeta;
+  std::vector<float>          mNSigmaPion;
+  std::vector<float>          mNSigmaKaon;
+  std::vector<float>          mNSigmaProton;
+  std::vector<int>            mNHitsFit;
+  std::vector<unsigned char>  mIsHFTTrack;
+  std::vector<unsigned int>   mMasks;      // passed cuts, one bit per eTrackBit
+};
+
+inline unsigned int StHFTrackSelection::bit(int trackBit) { return 1u << trackBit; }
+
+inline unsigned int           StHFTrackSelection::size()         const { return mIdx.size(); }
+inline unsigned short const * StHFTrackSelection::idx()          const { return mIdx.empty() ? NULL : &mIdx[0]; }
+inline float const *          StHFTrackSelection::pt()           const { return mPt.empty() ? NULL : &mPt[0]; }
+inline float const *          StHFTrackSelection::eta()          const { return mEta.empty() ? NULL : &mEta[0]; }
+inline float const *          StHFTrackSelection::p()            const { return mP.empty() ? NULL : &mP[0]; }
+inline float const *          StHFTrackSelection::tofBeta()      const { return mTofBeta.empty() ? NULL : &mTofBeta[0]; }
+inline float const *          StHFTrackSelection::nSigmaPion()   const { return mNSigmaPion.empty() ? NULL : &mNSigmaPion[0]; }
+inline float const *          StHFTrackSelection::nSigmaKaon()   const { return mNSigmaKaon.empty() ? NULL : &mNSigmaKaon[0]; }
+inline float const *          StHFTrackSelection::nSigmaProton() const { return mNSigmaProton.empty() ? NULL : &mNSigmaProton[0]; }
+inline int const *            StHFTrackSelection::nHitsFit()     const { return mNHitsFit.empty() ? NULL : &mNHitsFit[0]; }
+inline unsigned char const *  StHFTrackSelection::isHFTTrack()   const { return mIsHFTTrack.empty() ? NULL : &mIsHFTTrack[0]; }
+inline unsigned int *         StHFTrackSelection::masks()              { return mMasks.empty() ? NULL : &mMasks[0]; }
+inline unsigned int const *   StHFTrackSelection::masks()        const { return mMasks.empty() ? NULL : &mMasks[0]; }
+#endif
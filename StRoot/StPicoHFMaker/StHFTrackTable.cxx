@@ -0,0 +1,70 @@
+#include <cmath>
+
+#include "StHFTrackTable.h"
+
+// _________________________________________________________
+StHFTrackTable::StHFTrackTable() : mVtxX(0.), mVtxY(0.), mVtxZ(0.), mBField(0.) {
+}
+
+// _________________________________________________________
+void StHFTrackTable::reset(unsigned int const nTracks, float const vtxX, float const vtxY, float const vtxZ,
+			   float const bField) {
+  // -- prepare table for a new event
+  //    capacity of the arrays is kept from event to event
+
+  mVtxX   = vtxX;
+  mVtxY   = vtxY;
+  mVtxZ   = vtxZ;
+  mBField = bField;
+
+  mDcaX.clear();
+  mDcaY.clear();
+  mDcaZ.clear();
+  mPx.clear();
+  mPy.clear();
+  mPz.clear();
+  mCharge.clear();
+  mNSigmaPion.clear();
+  mNSigmaKaon.clear();
+  mNSigmaProton.clear();
+  mTofBeta.clear();
+  mDca.clear();
+  mId.clear();
+  mIdx.clear();
+
+  mRow.assign(nTracks, -1);
+}
+
+// _________________________________________________________
+int StHFTrackTable::addTrack(unsigned short const idx, int const id,
+			     float const dcaX, float const dcaY, float const dcaZ,
+			     float const px, float const py, float const pz, float const charge,
+			     float const nSigmaPion, float const nSigmaKaon, float const nSigmaProton,
+			     float const tofBeta) {
+  // -- append track to the table, if it is not in the table yet
+
+  if (idx >= mRow.size())
+    return -1;
+
+  if (mRow[idx] >= 0)
+    return mRow[idx];
+
+  mRow[idx] = mIdx.size();
+
+  mDcaX.push_back(dcaX);
+  mDcaY.push_back(dcaY);
+  mDcaZ.push_back(dcaZ);
+  mPx.push_back(px);
+  mPy.push_back(py);
+  mPz.push_back(pz);
+  mCharge.push_back(charge);
+  mNSigmaPion.push_back(nSigmaPion);
+  mNSigmaKaon.push_back(nSigmaKaon);
+  mNSigmaProton.push_back(nSigmaProton);
+  mTofBeta.push_back(tofBeta);
+  mDca.push_back(std::sqrt(dcaX*dcaX + dcaY*dcaY + dcaZ*dcaZ));
+  mId.push_back(id);
+  mIdx.push_back(idx);
+
+  return mRow[idx];
+}
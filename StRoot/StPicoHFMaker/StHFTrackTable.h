@@ -0,0 +1,117 @@
+#ifndef StHFTrackTable_hh
+#define StHFTrackTable_hh
+
+/* **************************************************
+ *  Event-wise structure-of-arrays snapshot of the tracks
+ *  selected for candidate building in HF analysis
+ *
+ *  - one row per selected track, every quantity is stored
+ *    in its own contiguous array:
+ *     - dcaX/Y/Z : point of DCA to the primary vertex,
+ *                  relative to the primary vertex
+ *     - px/y/z   : momentum at the DCA to the primary vertex
+ *     - charge, nSigmaPion/Kaon/Proton, tofBeta, dca
+ *
+ *  - reset(...) has to be called at the beginning of every event
+ *  - addTrack(...) appends a row, row(idx) returns the row of a
+ *    track by its StPicoDst index (-1 if the track is not in the table)
+ *
+ *  - the class does not depend on StPicoTrack, it is filled
+ *    by StPicoHFMaker / StPicoD0EventMaker from the track cache
+ *
+ *  - StHFPairKernel works on the arrays of this table
+ *
+ * **************************************************
+ */
+
+#include <vector>
+
+class StHFTrackTable
+{
+ public:
+  StHFTrackTable();
+  ~StHFTrackTable() {;}
+
+  void reset(unsigned int nTracks, float vtxX, float vtxY, float vtxZ, float bField);
+
+  int  addTrack(unsigned short idx, int id,
+		float dcaX, float dcaY, float dcaZ,
+		float px, float py, float pz, float charge,
+		float nSigmaPion, float nSigmaKaon, float nSigmaProton,
+		float tofBeta);
+
+  unsigned int size()                 const;
+  int          row(unsigned short idx) const;
+
+  // -- event information
+  float vtxX()   const;
+  float vtxY()   const;
+  float vtxZ()   const;
+  float bField() const;
+
+  // -- arrays, valid for rows [0, size())
+  float const *          dcaX()         const;
+  float const *          dcaY()         const;
+  float const *          dcaZ()         const;
+  float const *          px()           const;
+  float const *          py()           const;
+  float const *          pz()           const;
+  float const *          charge()       const;
+  float const *          nSigmaPion()   const;
+  float const *          nSigmaKaon()   const;
+  float const *          nSigmaProton() const;
+  float const *          tofBeta()      const;
+  float const *          dca()          const;
+  int const *            id()           const;
+  unsigned short const * idx()          const;
+
+ private:
+  StHFTrackTable(StHFTrackTable const &);
+  StHFTrackTable& operator=(StHFTrackTable const &);
+
+  float mVtxX;
+  float mVtxY;
+  float mVtxZ;
+  float mBField;
+
+  std::vector<float>          mDcaX;
+  std::vector<float>          mDcaY;
+  std::vector<float>          mDcaZ;
+  std::vector<float>          mPx;
+  std::vector<float>          mPy;
+  std::vector<float>          mPz;
+  std::vector<float>          mCharge;
+  std::vector<float>          mNSigmaPion;
+  std::vector<float>          mNSigmaKaon;
+  std::vector<float>          mNSigmaProton;
+  std::vector<float>          mTofBeta;
+  std::vector<float>          mDca;
+  std::vector<int>            mId;
+  std::vector<unsigned short> mIdx;   // index of track in StPicoDst
+
+  std::vector<int>            mRow;   // row per StPicoDst index (-1 if not in table)
+};
+
+inline unsigned int StHFTrackTable::size() const { return mIdx.size(); }
+inline int StHFTrackTable::row(unsigned short idx) const { return (idx < mRow.size()) ? mRow[idx] : -1; }
+
+inline float StHFTrackTable::vtxX()   const { return mVtxX; }
+inline float StHFTrackTable::vtxY()   const { return mVtxY; }
+inline float StHFTrackTable::vtxZ()   const { return mVtxZ; }
+inline float StHFTrackTable::bField() const { return mBField; }
+
+inline float const *          StHFTrackTable::dcaX()         const { return mDcaX.empty()         ? 0 : &mDcaX[0]; }
+inline float const *          StHFTrackTable::dcaY()         const { return mDcaY.empty()         ? 0 : &mDcaY[0]; }
+inline float const *          StHFTrackTable::dcaZ()         const { return mDcaZ.empty()         ? 0 : &mDcaZ[0]; }
+inline float const *          StHFTrackTable::px()           const { return mPx.empty()           ? 0 : &mPx[0]; }
+inline float const *          StHFTrackTable::py()           const { return mPy.empty()           ? 0 : &mPy[0]; }
+inline float const *          StHFTrackTable::pz()           const { return mPz.empty()           ? 0 : &mPz[0]; }
+inline float const *          StHFTrackTable::charge()       const { return mCharge.empty()       ? 0 : &mCharge[0]; }
+inline float const *          StHFTrackTable::nSigmaPion()   const { return mNSigmaPion.empty()   ? 0 : &mNSigmaPion[0]; }
+inline float const *          StHFTrackTable::nSigmaKaon()   const { return mNSigmaKaon.empty()   ? 0 : &mNSigmaKaon[0]; }
+inline float const *          StHFTrackTable::nSigmaProton() const { return mNSigmaProton.empty() ? 0 : &mNSigmaProton[0]; }
+inline float const *          StHFTrackTable::tofBeta()      const { return mTofBeta.empty()      ? 0 : &mTofBeta[0]; }
+inline float const *          StHFTrackTable::dca()          const { return mDca.empty()          ? 0 : &mDca[0]; }
+inline int const *            StHFTrackTable::id()           const { return mId.empty()           ? 0 : &mId[0]; }
+inline unsigned short const * StHFTrackTable::idx()          const { return mIdx.empty()          ? 0 : &mIdx[0]; }
+#endif
@@ -10,11 +10,14 @@
 #include "SystemOfUnits.h"
 #include "StPicoDstMaker/StPicoTrack.h"
 
+#include "StHFTrackCache.h"
+#include "StHFPairKernel.h"
+
 ClassImp(StHFTriplet)
 
 // _________________________________________________________
 StHFTriplet::StHFTriplet(): mLorentzVector(StLorentzVectorF()),
-  mPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+  mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
   mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()), 
   mParticle3Dca(std::numeric_limits<float>::quiet_NaN()),
   mParticle1Idx(std::numeric_limits<unsigned short>::max()), mParticle2Idx(std::numeric_limits<unsigned short>::max()), 
@@ -27,20 +30,26 @@ StHFTriplet::StHFTriplet(): mLorentzVector(StLorentzVectorF()),
 // _________________________________________________________
 StHFTriplet::StHFTriplet(StHFTriplet const * t) : 
   mLorentzVector(t->mLorentzVector),
-  mPointingAngle(t->mPointingAngle), mDecayLength(t->mDecayLength), 
+  mCosPointingAngle(t->mCosPointingAngle), mDecayLength(t->mDecayLength), 
   mParticle1Dca(t->mParticle1Dca), mParticle2Dca(t->mParticle2Dca), mParticle3Dca(t->mParticle3Dca),
   mParticle1Idx(t->mParticle1Idx), mParticle2Idx(t->mParticle2Idx), mParticle3Idx(t->mParticle3Idx),
   mDcaDaughters12(t->mDcaDaughters12),  mDcaDaughters23(t->mDcaDaughters23), mDcaDaughters31(t->mDcaDaughters31), 
   mCosThetaStar(t->mCosThetaStar)
 {
 }
+
+// _________________________________________________________
+float StHFTriplet::pointingAngle() const {
+  // -- pointing angle from the stored cos, prefer cosPointingAngle() for cuts
+  return std::acos(mCosPointingAngle);
+}
 //------------------------------------
 StHFTriplet::StHFTriplet(StPicoTrack const * const particle1, StPicoTrack const * const particle2, StPicoTrack const * const particle3,
 			 float p1MassHypo, float p2MassHypo, float p3MassHypo,
 			 unsigned short const p1Idx, unsigned short const p2Idx, unsigned short const p3Idx,
 			 StThreeVectorF const & vtx, float const bField)  : 
   mLorentzVector(StLorentzVectorF()),
-  mPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+  mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
   mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()), 
   mParticle3Dca(std::numeric_limits<float>::quiet_NaN()),
   mParticle1Idx(p1Idx), mParticle2Idx(p2Idx),  mParticle3Idx(p3Idx),
@@ -48,12 +57,6 @@ StHFTriplet::StHFTriplet(StPicoTrack const * const particle1, StPicoTrack const
   mDcaDaughters31(std::numeric_limits<float>::max()),
   mCosThetaStar(std::numeric_limits<float>::min()) {
   // -- Create triplet out of 3 tracks
-  //     prefixes code:
-  //      p1 means particle 1
-  //      p2 means particle 2
-  //      p3 means particle 3
-  //      pair means particle1-particle2 pair||  particle2-particle3 pair ||  particle1-particle3 pair
-  //      triplet particle1-particle2-particle3
 
   if ((!particle1 || !particle2 || !particle3) || 
       (particle1->id() == particle2->id() || particle1->id() == particle3->id() || particle2->id() == particle3->id())) {
@@ -63,44 +66,110 @@ StHFTriplet::StHFTriplet(StPicoTrack const * const particle1, StPicoTrack const
     return;
   }
 
-  StPhysicalHelixD p1Helix = particle1->dcaGeometry().helix();
-  StPhysicalHelixD p2Helix = particle2->dcaGeometry().helix();
-  StPhysicalHelixD p3Helix = particle3->dcaGeometry().helix();
-  
-   // -- move origins of helices to the primary vertex origin
-  p1Helix.moveOrigin(p1Helix.pathLength(vtx));
-  p2Helix.moveOrigin(p2Helix.pathLength(vtx));
-  p3Helix.moveOrigin(p3Helix.pathLength(vtx));
-  
-  // -- use straight lines approximation to get point of DCA of particle1-particle2 pair
-  StThreeVectorF const p1Mom = p1Helix.momentum(bField * kilogauss);
-  StThreeVectorF const p2Mom = p2Helix.momentum(bField * kilogauss);
-  StThreeVectorF const p3Mom = p3Helix.momentum(bField * kilogauss);
-  
-  StPhysicalHelixD const p1StraightLine(p1Mom, p1Helix.origin(), 0, particle1->charge());
-  StPhysicalHelixD const p2StraightLine(p2Mom, p2Helix.origin(), 0, particle2->charge());
-  StPhysicalHelixD const p3StraightLine(p3Mom, p3Helix.origin(), 0, particle3->charge());
-  
-  pair<double, double> const ss12 = p1StraightLine.pathLengths(p2StraightLine);
-  StThreeVectorF const p1AtDcaToP2 = p1StraightLine.at(ss12.first);
-  StThreeVectorF const p2AtDcaToP1 = p2StraightLine.at(ss12.second);
+  StHFCachedTrack const p1(particle1, p1Idx, vtx, bField);
+  StHFCachedTrack const p2(particle2, p2Idx, vtx, bField);
+  StHFCachedTrack const p3(particle3, p3Idx, vtx, bField);
 
-  pair<double, double> const ss23 = p2StraightLine.pathLengths(p3StraightLine);
-  StThreeVectorF const p2AtDcaToP3 = p2StraightLine.at(ss23.first);
-  StThreeVectorF const p3AtDcaToP2 = p3StraightLine.at(ss23.second);
-  
-  pair<double, double> const ss31 = p3StraightLine.pathLengths(p1StraightLine);
-  StThreeVectorF const p3AtDcaToP1 = p3StraightLine.at(ss31.first);
-  StThreeVectorF const p1AtDcaToP3 = p1StraightLine.at(ss31.second);
-  
-  // -- calculate DCA of particle1 to particl2 at their DCA
-  mDcaDaughters12 = (p1AtDcaToP2 - p2AtDcaToP1).mag();
-  
-  // -- calculate DCA of particle2 to particl3 at their DCA
-  mDcaDaughters23 = (p2AtDcaToP3 - p3AtDcaToP2).mag();
-  
-  // -- calculate DCA of particle3 to particle1 at their DCA
-  mDcaDaughters31 = (p3AtDcaToP1 - p1AtDcaToP3).mag();
+  createTriplet(p1, p2, p3, p1MassHypo, p2MassHypo, p3MassHypo, vtx, bField);
+}
+
+//------------------------------------
+StHFTriplet::StHFTriplet(StHFCachedTrack const & particle1, StHFCachedTrack const & particle2, StHFCachedTrack const & particle3,
+			 float p1MassHypo, float p2MassHypo, float p3MassHypo,
+			 StThreeVectorF const & vtx, float const bField)  : 
+  mLorentzVector(StLorentzVectorF()),
+  mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()), 
+  mParticle3Dca(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Idx(particle1.idx()), mParticle2Idx(particle2.idx()),  mParticle3Idx(particle3.idx()),
+  mDcaDaughters12(std::numeric_limits<float>::max()), mDcaDaughters23(std::numeric_limits<float>::max()),  
+  mDcaDaughters31(std::numeric_limits<float>::max()),
+  mCosThetaStar(std::numeric_limits<float>::min()) {
+  // -- Create triplet out of 3 cached tracks
+
+  if (particle1.id() == particle2.id() || particle1.id() == particle3.id() || particle2.id() == particle3.id()) {
+    mParticle1Idx = std::numeric_limits<unsigned short>::max();
+    mParticle2Idx = std::numeric_limits<unsigned short>::max();
+    mParticle3Idx = std::numeric_limits<unsigned short>::max();
+    return;
+  }
+
+  createTriplet(particle1, particle2, particle3, p1MassHypo, p2MassHypo, p3MassHypo, vtx, bField);
+}
+
+//------------------------------------
+StHFTriplet::StHFTriplet(StHFCachedTrack const & particle1, StHFCachedTrack const & particle2, StHFCachedTrack const & particle3, 
+			 StHFLineDca const & dca12, StHFLineDca const & dca23, StHFLineDca const & dca31,
+			 float p1MassHypo, float p2MassHypo, float p3MassHypo,
+			 StThreeVectorF const & vtx, float const bField)  : 
+  mLorentzVector(StLorentzVectorF()),
+  mCosPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()), 
+  mParticle3Dca(std::numeric_limits<float>::quiet_NaN()),
+  mParticle1Idx(particle1.idx()), mParticle2Idx(particle2.idx()),  mParticle3Idx(particle3.idx()),
+  mDcaDaughters12(std::numeric_limits<float>::max()), mDcaDaughters23(std::numeric_limits<float>::max()),  
+  mDcaDaughters31(std::numeric_limits<float>::max()),
+  mCosThetaStar(std::numeric_limits<float>::min()) {
+  // -- Create triplet out of 3 cached tracks, DCAs of their straight lines are given
+
+  if (particle1.id() == particle2.id() || particle1.id() == particle3.id() || particle2.id() == particle3.id()) {
+    mParticle1Idx = std::numeric_limits<unsigned short>::max();
+    mParticle2Idx = std::numeric_limits<unsigned short>::max();
+    mParticle3Idx = std::numeric_limits<unsigned short>::max();
+    return;
+  }
+
+  createTriplet(particle1, particle2, particle3, dca12, dca23, dca31, p1MassHypo, p2MassHypo, p3MassHypo, vtx, bField);
+}
+
+//------------------------------------
+void StHFTriplet::createTriplet(StHFCachedTrack const & p1, StHFCachedTrack const & p2, StHFCachedTrack const & p3,
+				float p1MassHypo, float p2MassHypo, float p3MassHypo,
+				StThreeVectorF const & vtx, float const bField) {
+  // -- Calculate triplet out of 3 tracks
+  //     prefixes code:
+  //      p1 means particle 1
+  //      p2 means particle 2
+  //      p3 means particle 3
+  //      pair means particle1-particle2 pair||  particle2-particle3 pair ||  particle1-particle3 pair
+  //      triplet particle1-particle2-particle3
+  //
+  //     helices of cached tracks have their origins already moved to the primary vertex
+
+  // -- use straight lines approximation to get points of DCA of the daughter pairs
+  StPhysicalHelixD const p1StraightLine = p1.straightLine();
+  StPhysicalHelixD const p2StraightLine = p2.straightLine();
+  StPhysicalHelixD const p3StraightLine = p3.straightLine();
+
+  StHFLineDca const dca12(p1StraightLine, p2StraightLine);
+  StHFLineDca const dca23(p2StraightLine, p3StraightLine);
+  StHFLineDca const dca31(p3StraightLine, p1StraightLine);
+
+  createTriplet(p1, p2, p3, dca12, dca23, dca31, p1MassHypo, p2MassHypo, p3MassHypo, vtx, bField);
+}
+
+//------------------------------------
+void StHFTriplet::createTriplet(StHFCachedTrack const & p1, StHFCachedTrack const & p2, StHFCachedTrack const & p3,
+				StHFLineDca const & dca12, StHFLineDca const & dca23, StHFLineDca const & dca31,
+				float p1MassHypo, float p2MassHypo, float p3MassHypo,
+				StThreeVectorF const & vtx, float const bField) {
+  // -- Calculate triplet out of 3 tracks and the DCAs of their straight lines
+
+  StPhysicalHelixD const & p1Helix = p1.helix();
+  StPhysicalHelixD const & p2Helix = p2.helix();
+  StPhysicalHelixD const & p3Helix = p3.helix();
+
+  StThreeVectorF const & p1AtDcaToP2 = dca12.atLine1;
+  StThreeVectorF const & p2AtDcaToP1 = dca12.atLine2;
+  StThreeVectorF const & p2AtDcaToP3 = dca23.atLine1;
+  StThreeVectorF const & p3AtDcaToP2 = dca23.atLine2;
+  StThreeVectorF const & p3AtDcaToP1 = dca31.atLine1;
+  StThreeVectorF const & p1AtDcaToP3 = dca31.atLine2;
+
+  // -- DCA of the daughter pairs at their DCA
+  mDcaDaughters12 = dca12.dca;
+  mDcaDaughters23 = dca23.dca;
+  mDcaDaughters31 = dca31.dca;
   
   // -- calculate decay vertex (secondary)
   StThreeVectorF decayVtx = ( p1AtDcaToP2 + p2AtDcaToP1 + p2AtDcaToP3 + p3AtDcaToP2 + p3AtDcaToP1 + p1AtDcaToP3 ) / 6.0;
@@ -130,14 +199,15 @@ StHFTriplet::StHFTriplet(StPicoTrack const * const particle1, StPicoTrack const
   StLorentzVectorF const p1FourMomStar = p1FourMom.boost(tripletFourMomReverse);
   mCosThetaStar = std::cos(p1FourMomStar.vect().angle(mLorentzVector.vect()));
   
-  // -- calculate pointing angle and decay length
+  // -- calculate cos of pointing angle and decay length
   StThreeVectorF const vtxToV0 = decayVtx - vtx;
-  mPointingAngle = vtxToV0.angle(mLorentzVector.vect());
+  mCosPointingAngle = StHFPairKernel::cosAngle(vtxToV0.x(), vtxToV0.y(), vtxToV0.z(), 
+					       mLorentzVector.px(), mLorentzVector.py(), mLorentzVector.pz());
   mDecayLength = vtxToV0.mag();
   
-  // --- calculate DCA of tracks to primary vertex
-  mParticle1Dca = (p1Helix.origin() - vtx).mag();
-  mParticle2Dca = (p2Helix.origin() - vtx).mag();
-  mParticle3Dca = (p3Helix.origin() - vtx).mag();
+  // --- DCA of tracks to primary vertex
+  mParticle1Dca = p1.dca();
+  mParticle2Dca = p2.dca();
+  mParticle3Dca = p3.dca();
 }
 
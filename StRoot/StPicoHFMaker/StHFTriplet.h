@@ -7,6 +7,18 @@
  *  - three particles, using
  *      StHFTriplet(StPicoTrack const * particle1, StPicoTrack const * particle2, 
  *                  StPicoTrack const * particle3, ...
+ *  - three entries of the event-wise track cache (StHFTrackCache), using
+ *      StHFTriplet(StHFCachedTrack const & particle1, StHFCachedTrack const & particle2, 
+ *                  StHFCachedTrack const & particle3, ...
+ *  - three entries of the track cache with the DCAs of their straight 
+ *    lines already calculated (e.g. by StHFTripletBuilder), using
+ *      StHFTriplet(StHFCachedTrack const & particle1, ..., 
+ *                  StHFLineDca const & dca12, StHFLineDca const & dca23, 
+ *                  StHFLineDca const & dca31, ...
+ *    (dca31 : line 1 is particle 3, line 2 is particle 1)
+ *  - the cos of the pointing angle is stored (cosPointingAngle()), 
+ *    pointingAngle() returns its acos. Version 1 stored the angle, it is 
+ *    converted when reading (read rule in StPicoHFMakerLinkDef.h)
  *
  * **************************************************
  *  Authors:  Xin Dong        (xdong@lbl.gov)
@@ -23,6 +35,8 @@
 
 class StPicoTrack;
 class StPicoEvent;
+class StHFCachedTrack;
+struct StHFLineDca;
 
 class StHFTriplet : public TObject
 {
@@ -33,6 +47,13 @@ class StHFTriplet : public TObject
 	     float p1MassHypo, float p2MassHypo, float p3MassHypo,
 	     unsigned short p1Idx, unsigned short p2Idx, unsigned short p3Idx,
 	     StThreeVectorF const & vtx, float bField);
+  StHFTriplet(StHFCachedTrack const & particle1, StHFCachedTrack const & particle2, StHFCachedTrack const & particle3, 
+	     float p1MassHypo, float p2MassHypo, float p3MassHypo,
+	     StThreeVectorF const & vtx, float bField);
+  StHFTriplet(StHFCachedTrack const & particle1, StHFCachedTrack const & particle2, StHFCachedTrack const & particle3, 
+	     StHFLineDca const & dca12, StHFLineDca const & dca23, StHFLineDca const & dca31,
+	     float p1MassHypo, float p2MassHypo, float p3MassHypo,
+	     StThreeVectorF const & vtx, float bField);
   ~StHFTriplet() {;}
 
   StLorentzVectorF const & lorentzVector() const { return mLorentzVector;}
@@ -40,6 +61,7 @@ class StHFTriplet : public TObject
   float pt()   const;
   float eta()  const;
   float phi()  const;
+  float cosPointingAngle() const;
   float pointingAngle() const;
   float decayLength() const;
   float particle1Dca() const;
@@ -62,9 +84,18 @@ class StHFTriplet : public TObject
  private:
   StHFTriplet(StHFTriplet const &);
   StHFTriplet& operator=(StHFTriplet const &);
+
+  void createTriplet(StHFCachedTrack const & p1, StHFCachedTrack const & p2, StHFCachedTrack const & p3,
+		     float p1MassHypo, float p2MassHypo, float p3MassHypo,
+		     StThreeVectorF const & vtx, float bField);
+  void createTriplet(StHFCachedTrack const & p1, StHFCachedTrack const & p2, StHFCachedTrack const & p3,
+		     StHFLineDca const & dca12, StHFLineDca const & dca23, StHFLineDca const & dca31,
+		     float p1MassHypo, float p2MassHypo, float p3MassHypo,
+		     StThreeVectorF const & vtx, float bField);
+
   StLorentzVectorF mLorentzVector; 
 
-  float mPointingAngle;
+  float mCosPointingAngle; // cos of pointing angle, until version 1 mPointingAngle
   float mDecayLength;
 
   float mParticle1Dca;
@@ -85,7 +116,7 @@ class StHFTriplet : public TObject
   float mV0y;
   float mV0z;
   
-  ClassDef(StHFTriplet,1)
+  ClassDef(StHFTriplet,2)
 };
 
 inline float StHFTriplet::m()    const { return mLorentzVector.m();}
@@ -95,7 +126,7 @@ inline float StHFTriplet::phi()  const { return mLorentzVector.phi();}
 inline float StHFTriplet::px()   const { return mLorentzVector.px();}
 inline float StHFTriplet::py()   const { return mLorentzVector.py();}
 inline float StHFTriplet::pz()   const { return mLorentzVector.pz();}
-inline float StHFTriplet::pointingAngle() const { return mPointingAngle;}
+inline float StHFTriplet::cosPointingAngle() const { return mCosPointingAngle;}
 inline float StHFTriplet::decayLength()   const { return mDecayLength;}
 inline float StHFTriplet::particle1Dca()  const { return mParticle1Dca;}
 inline float StHFTriplet::particle2Dca()  const { return mParticle2Dca;}
@@ -0,0 +1,118 @@
+#include <vector>
+
+#include "StHFTripletBuilder.h"
+#include "StHFTrackCache.h"
+
+#include "StPhysicalHelixD.hh"
+
+// _________________________________________________________
+StHFTripletBuilder::StHFTripletBuilder() : 
+  mTracks1(), mTracks2(), mTracks3(), mLines1(), mLines2(), mLines3(),
+  mDca23(), mHasDca23Row(), mDca31(), mSeeds(), mNPairsTried(0), mNPairsPassed(0) {
+}
+
+// _________________________________________________________
+void StHFTripletBuilder::setupList(StHFTrackCache const & cache, std::vector<unsigned short> const & idxList,
+				   std::vector<StHFCachedTrack const *> & tracks, std::vector<StPhysicalHelixD> & lines) const {
+  // -- cached tracks and their straight lines, once per event and list
+
+  tracks.resize(idxList.size());
+  lines.resize(idxList.size());
+
+  for (unsigned int ii = 0; ii < idxList.size(); ++ii) {
+    tracks[ii] = cache.get(idxList[ii]);
+    if (tracks[ii])
+      lines[ii] = tracks[ii]->straightLine();
+  }
+}
+
+// _________________________________________________________
+void StHFTripletBuilder::build(StHFTrackCache const & cache, 
+			       std::vector<unsigned short> const & idxList1, std::vector<unsigned short> const & idxList2,
+			       std::vector<unsigned short> const & idxList3, bool const sameList23, bool const sameMass23,
+			       float const dcaDaughters12Max, float const dcaDaughters23Max, float const dcaDaughters31Max) {
+  // -- find all combinations of the three lists passing the dcaDaughters cuts
+
+  mSeeds.clear();
+  mNPairsTried  = 0;
+  mNPairsPassed = 0;
+
+  // -- same particles with the same mass hypothesis : each pair 2-3 only once
+  bool const bUnordered23 = sameList23 && sameMass23;
+
+  setupList(cache, idxList1, mTracks1, mLines1);
+  setupList(cache, idxList2, mTracks2, mLines2);
+  if (!sameList23)
+    setupList(cache, idxList3, mTracks3, mLines3);
+
+  std::vector<StHFCachedTrack const *> const & tracks3 = sameList23 ? mTracks2 : mTracks3;
+  std::vector<StPhysicalHelixD>        const & lines3  = sameList23 ? mLines2  : mLines3;
+
+  unsigned int const n1 = mTracks1.size();
+  unsigned int const n2 = mTracks2.size();
+  unsigned int const n3 = tracks3.size();
+
+  mDca23.resize(n2 * n3);
+  mHasDca23Row.assign(n2, 0);
+  mDca31.resize(n3);
+
+  for (unsigned int i1 = 0; i1 < n1; ++i1) {
+    StHFCachedTrack const * const p1 = mTracks1[i1];
+    if (!p1) 
+      continue;
+
+    bool bHasDca31 = false;
+
+    for (unsigned int i2 = 0; i2 < n2; ++i2) {
+      StHFCachedTrack const * const p2 = mTracks2[i2];
+      if (!p2 || p1->id() == p2->id())
+	continue;
+
+      // -- prune 1-2 pairs
+      ++mNPairsTried;
+      StHFLineDca const dca12(mLines1[i1], mLines2[i2]);
+      if (!(dca12.dca < dcaDaughters12Max))
+	continue;
+      ++mNPairsPassed;
+
+      // -- 2-3 and 3-1 DCAs, only for particles 1 and 2 used in a surviving pair
+      if (!mHasDca23Row[i2]) {
+	for (unsigned int i3 = bUnordered23 ? i2 + 1 : 0; i3 < n3; ++i3)
+	  if (tracks3[i3])
+	    mDca23[i2 * n3 + i3] = StHFLineDca(mLines2[i2], lines3[i3]);
+	mHasDca23Row[i2] = 1;
+      }
+
+      if (!bHasDca31) {
+	for (unsigned int i3 = 0; i3 < n3; ++i3)
+	  if (tracks3[i3])
+	    mDca31[i3] = StHFLineDca(lines3[i3], mLines1[i1]);
+	bHasDca31 = true;
+      }
+
+      // -- add third particle
+      for (unsigned int i3 = bUnordered23 ? i2 + 1 : 0; i3 < n3; ++i3) {
+	StHFCachedTrack const * const p3 = tracks3[i3];
+	if (!p3 || p1->id() == p3->id() || p2->id() == p3->id())
+	  continue;
+
+	StHFLineDca const & dca23 = mDca23[i2 * n3 + i3];
+	if (!(dca23.dca < dcaDaughters23Max))
+	  continue;
+
+	StHFLineDca const & dca31 = mDca31[i3];
+	if (!(dca31.dca < dcaDaughters31Max))
+	  continue;
+
+	StHFTripletSeed seed;
+	seed.particle1 = p1;
+	seed.particle2 = p2;
+	seed.particle3 = p3;
+	seed.dca12 = dca12;
+	seed.dca23 = dca23;
+	seed.dca31 = dca31;
+	mSeeds.push_back(seed);
+      }
+    } // for (unsigned int i2 = 0; i2 < n2; ++i2) {
+  } // for (unsigned int i1 = 0; i1 < n1; ++i1) {
+}
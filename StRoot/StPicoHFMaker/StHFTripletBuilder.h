@@ -0,0 +1,100 @@
+#ifndef StHFTripletBuilder_hh
+#define StHFTripletBuilder_hh
+
+/* **************************************************
+ *  Per-event builder of triplet candidates (three-body decays)
+ *  out of three lists of particles (e.g. mIdxPicoProtons,
+ *  mIdxPicoKaons, mIdxPicoPions), with pair-level pruning
+ *
+ *  Instead of constructing a StHFTriplet for every combination,
+ *  build(...) 
+ *   - forms the 1-2 pairs first and drops those with a DCA of 
+ *     their straight lines above dcaDaughters12Max
+ *   - adds the third particle only to the surviving 1-2 pairs, 
+ *     the 2-3 and 3-1 DCAs are calculated once per pair of tracks
+ *     (not once per triplet) and checked against dcaDaughters23Max 
+ *     and dcaDaughters31Max
+ *   - keeps the surviving combinations as StHFTripletSeed, with the 
+ *     DCAs already calculated (StHFLineDca)
+ *   - the dcaDaughters cuts are applied as in StHFCuts (dca < max)
+ *
+ *  Only for the seeds the full triplet (decay vertex, momenta at
+ *  the decay vertex, ...) has to be calculated, via the
+ *  StHFTriplet(..., StHFLineDca const & dca12, ...) constructor,
+ *  see StPicoHFMaker::createSecondaryTriplets(...). 
+ *
+ *  The DCAs are the same as calculated by StHFTriplet, so exactly 
+ *  the triplets of the brute-force loop passing the dcaDaughters 
+ *  cuts are kept.
+ *
+ *  - Set sameList23 if list 2 and list 3 are the same list of particles 
+ *    (e.g. pions for D+ -> Kpipi), their setup is then shared. With the same 
+ *    mass hypothesis (sameMass23) every pair of particles 2 and 3 is used only 
+ *    once (position 3 > position 2), otherwise both assignments are built
+ *  - Triplets with the same track twice are skipped
+ *
+ * **************************************************
+ */
+
+#include <vector>
+
+#include "StPhysicalHelixD.hh"
+#include "StHFTrackCache.h"
+
+struct StHFTripletSeed
+{
+  StHFCachedTrack const * particle1;
+  StHFCachedTrack const * particle2;
+  StHFCachedTrack const * particle3;
+
+  StHFLineDca dca12;
+  StHFLineDca dca23;
+  StHFLineDca dca31;   // line 1 is particle 3, line 2 is particle 1
+};
+
+class StHFTripletBuilder
+{
+ public:
+  StHFTripletBuilder();
+  ~StHFTripletBuilder() {;}
+
+  void build(StHFTrackCache const & cache, 
+	     std::vector<unsigned short> const & idxList1, std::vector<unsigned short> const & idxList2,
+	     std::vector<unsigned short> const & idxList3, bool sameList23, bool sameMass23,
+	     float dcaDaughters12Max, float dcaDaughters23Max, float dcaDaughters31Max);
+
+  unsigned int            nSeeds() const;
+  StHFTripletSeed const & seed(unsigned int i) const;
+
+  unsigned int nPairsTried()  const;
+  unsigned int nPairsPassed() const;
+
+ private:
+  StHFTripletBuilder(StHFTripletBuilder const &);
+  StHFTripletBuilder& operator=(StHFTripletBuilder const &);
+
+  void setupList(StHFTrackCache const & cache, std::vector<unsigned short> const & idxList,
+		 std::vector<StHFCachedTrack const *> & tracks, std::vector<StPhysicalHelixD> & lines) const;
+
+  std::vector<StHFCachedTrack const *> mTracks1;  // cached tracks, per position in the lists
+  std::vector<StHFCachedTrack const *> mTracks2;
+  std::vector<StHFCachedTrack const *> mTracks3;
+  std::vector<StPhysicalHelixD>        mLines1;   // straight lines, per position in the lists
+  std::vector<StPhysicalHelixD>        mLines2;
+  std::vector<StPhysicalHelixD>        mLines3;
+
+  std::vector<StHFLineDca>   mDca23;        // 2-3 DCAs, n2 x n3, rows are filled on first use
+  std::vector<unsigned char> mHasDca23Row;  // row of particle 2 is filled
+  std::vector<StHFLineDca>   mDca31;        // 3-1 DCAs for the current particle 1
+
+  std::vector<StHFTripletSeed> mSeeds;      // combinations passing the dcaDaughters cuts
+
+  unsigned int mNPairsTried;   // 1-2 pairs of different tracks
+  unsigned int mNPairsPassed;  // 1-2 pairs passing dcaDaughters12Max
+};
+
+inline unsigned int            StHFTripletBuilder::nSeeds() const             { return mSeeds.size(); }
+inline StHFTripletSeed const & StHFTripletBuilder::seed(unsigned int i) const { return mSeeds[i]; }
+inline unsigned int            StHFTripletBuilder::nPairsTried()  const       { return mNPairsTried; }
+inline unsigned int            StHFTripletBuilder::nPairsPassed() const       { return mNPairsPassed; }
+#endif
@@ -0,0 +1,102 @@
+#include "StHFWorkQueue.h"
+
+// _________________________________________________________
+StHFWorkQueue::StHFWorkQueue() : mItems() {
+  pthread_mutex_init(&mMutex, NULL);
+  pthread_cond_init(&mCond, NULL);
+}
+
+// _________________________________________________________
+StHFWorkQueue::~StHFWorkQueue() {
+  pthread_cond_destroy(&mCond);
+  pthread_mutex_destroy(&mMutex);
+}
+
+// _________________________________________________________
+void StHFWorkQueue::push(void* item) {
+  pthread_mutex_lock(&mMutex);
+  mItems.push_back(item);
+  pthread_cond_signal(&mCond);
+  pthread_mutex_unlock(&mMutex);
+}
+
+// _________________________________________________________
+void* StHFWorkQueue::pop() {
+  // -- wait for next item
+
+  pthread_mutex_lock(&mMutex);
+  while (mItems.empty())
+    pthread_cond_wait(&mCond, &mMutex);
+
+  void* item = mItems.front();
+  mItems.pop_front();
+  pthread_mutex_unlock(&mMutex);
+
+  return item;
+}
+
+// _________________________________________________________
+StHFThreadPool::StHFThreadPool() : mThreads() {
+}
+
+// _________________________________________________________
+StHFThreadPool::~StHFThreadPool() {
+  join();
+}
+
+// _________________________________________________________
+unsigned int StHFThreadPool::start(void* (*run)(void*), std::vector<void*> const & args) {
+  // -- start one thread per argument, return number of started threads
+
+  for (unsigned int ii = 0; ii < args.size(); ++ii) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, run, args[ii]))
+      break;
+    mThreads.push_back(thread);
+  }
+
+  return mThreads.size();
+}
+
+// _________________________________________________________
+void StHFThreadPool::join() {
+  // -- wait for all threads to return
+
+  for (unsigned int ii = 0; ii < mThreads.size(); ++ii)
+    pthread_join(mThreads[ii], NULL);
+
+  mThreads.clear();
+}
+
+// _________________________________________________________
+StHFWorkCounter::StHFWorkCounter() : mNext(0), mSize(0) {
+  pthread_mutex_init(&mMutex, NULL);
+}
+
+// _________________________________________________________
+StHFWorkCounter::~StHFWorkCounter() {
+  pthread_mutex_destroy(&mMutex);
+}
+
+// _________________________________________________________
+void StHFWorkCounter::reset(unsigned int const n) {
+  // -- hand out indices 0 ... n-1, call before threads use next()
+
+  pthread_mutex_lock(&mMutex);
+  mNext = 0;
+  mSize = n;
+  pthread_mutex_unlock(&mMutex);
+}
+
+// _________________________________________________________
+bool StHFWorkCounter::next(unsigned int & idx) {
+  // -- get next index, false if all are handed out
+
+  pthread_mutex_lock(&mMutex);
+  bool const bValid = (mNext < mSize);
+  if (bValid)
+    idx = mNext++;
+  pthread_mutex_unlock(&mMutex);
+
+  return bValid;
+}
@@ -0,0 +1,85 @@
+#ifndef StHFWorkQueue_hh
+#define StHFWorkQueue_hh
+
+/* **************************************************
+ *  Minimal pthreads helpers for multithreaded HF analysis
+ *
+ *  - StHFWorkQueue is a blocking FIFO of pointers
+ *     - push(...) adds an item and wakes up one waiting pop()
+ *     - pop() waits until an item is available
+ *    A NULL item can be pushed as end marker for a consumer.
+ *
+ *  - StHFThreadPool starts one thread per argument, all running
+ *    the same function, and joins them
+ *
+ *  - StHFWorkCounter hands out the indices 0 ... n-1 to several
+ *    threads, each index exactly once. Threads which are done early
+ *    take over the remaining indices (dynamic load balancing)
+ *
+ *  - the classes do not depend on STAR libraries
+ *
+ * **************************************************
+ */
+
+#include <deque>
+#include <vector>
+#include <pthread.h>
+
+class StHFWorkQueue
+{
+ public:
+  StHFWorkQueue();
+  ~StHFWorkQueue();
+
+  void  push(void* item);
+  void* pop();
+
+ private:
+  StHFWorkQueue(StHFWorkQueue const &);
+  StHFWorkQueue& operator=(StHFWorkQueue const &);
+
+  pthread_mutex_t    mMutex;
+  pthread_cond_t     mCond;
+  std::deque<void*>  mItems;
+};
+
+// _________________________________________________________
+class StHFThreadPool
+{
+ public:
+  StHFThreadPool();
+  ~StHFThreadPool();
+
+  unsigned int start(void* (*run)(void*), std::vector<void*> const & args);
+  void         join();
+
+  unsigned int size() const;
+
+ private:
+  StHFThreadPool(StHFThreadPool const &);
+  StHFThreadPool& operator=(StHFThreadPool const &);
+
+  std::vector<pthread_t> mThreads;
+};
+
+inline unsigned int StHFThreadPool::size() const { return mThreads.size(); }
+
+// _________________________________________________________
+class StHFWorkCounter
+{
+ public:
+  StHFWorkCounter();
+  ~StHFWorkCounter();
+
+  void reset(unsigned int n);
+  bool next(unsigned int & idx);
+
+ private:
+  StHFWorkCounter(StHFWorkCounter const &);
+  StHFWorkCounter& operator=(StHFWorkCounter const &);
+
+  pthread_mutex_t mMutex;
+  unsigned int    mNext;
+  unsigned int    mSize;
+};
+#endif
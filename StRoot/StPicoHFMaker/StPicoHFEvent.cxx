@@ -3,43 +3,52 @@
 #include "StPicoHFEvent.h"
 #include "StHFPair.h"
 #include "StHFTriplet.h"
+#include "StHFTripletBuilder.h"
+#include "StHFTrackCache.h"
+#include "StHFCascadeV0.h"
+#include "StHFDaughter.h"
 
 ClassImp(StPicoHFEvent)
 
-TClonesArray *StPicoHFEvent::fgHFSecondaryVerticesArray = 0;
-TClonesArray *StPicoHFEvent::fgHFTertiaryVerticesArray  = 0;
-
 // _________________________________________________________
-StPicoHFEvent::StPicoHFEvent() : mRunId(-1), mEventId(-1), mNHFSecondaryVertices(0), mNHFTertiaryVertices(0),
-						  mHFSecondaryVerticesArray(NULL), mHFTertiaryVerticesArray(NULL) {
+StPicoHFEvent::StPicoHFEvent() : mRunId(-1), mEventId(-1), mNHFSecondaryVertices(0), mNHFTertiaryVertices(0), mNHFDaughters(0),
+						  mHFSecondaryVerticesArray(NULL), mHFTertiaryVerticesArray(NULL), mHFDaughtersArray(NULL),
+						  mNHFSecondaryVerticesMax(0), mNHFTertiaryVerticesMax(0) {
   // -- Default constructor
-  if (!fgHFSecondaryVerticesArray) fgHFSecondaryVerticesArray = new TClonesArray("StHFPair");
-  mHFSecondaryVerticesArray = fgHFSecondaryVerticesArray;
+  mHFSecondaryVerticesArray = new TClonesArray("StHFPair");
+  mHFDaughtersArray         = new TClonesArray("StHFDaughter");
 }
 
 // _________________________________________________________
-StPicoHFEvent::StPicoHFEvent(unsigned int mode) : mRunId(-1), mEventId(-1), mNHFSecondaryVertices(0), mNHFTertiaryVertices(0),
-						  mHFSecondaryVerticesArray(NULL), mHFTertiaryVerticesArray(NULL) {
+StPicoHFEvent::StPicoHFEvent(unsigned int mode) : mRunId(-1), mEventId(-1), mNHFSecondaryVertices(0), mNHFTertiaryVertices(0), mNHFDaughters(0),
+						  mHFSecondaryVerticesArray(NULL), mHFTertiaryVerticesArray(NULL), mHFDaughtersArray(NULL),
+						  mNHFSecondaryVerticesMax(0), mNHFTertiaryVerticesMax(0) {
   // -- Constructor with mode selection
   if (mode == StPicoHFEvent::kTwoAndTwoParticleDecay) {
-    if (!fgHFSecondaryVerticesArray) fgHFSecondaryVerticesArray = new TClonesArray("StHFPair");
-    mHFSecondaryVerticesArray = fgHFSecondaryVerticesArray;
-
-    if (!fgHFTertiaryVerticesArray) fgHFTertiaryVerticesArray = new TClonesArray("StHFPair");
-    mHFTertiaryVerticesArray = fgHFTertiaryVerticesArray;
+    mHFSecondaryVerticesArray = new TClonesArray("StHFPair");
+    mHFTertiaryVerticesArray  = new TClonesArray("StHFPair");
   }
   else if (mode == StPicoHFEvent::kThreeParticleDecay) {
-    if (!fgHFSecondaryVerticesArray) fgHFSecondaryVerticesArray = new TClonesArray("StHFTriplet");
-    mHFSecondaryVerticesArray = fgHFSecondaryVerticesArray;
+    mHFSecondaryVerticesArray = new TClonesArray("StHFTriplet");
   }
   else if (mode == StPicoHFEvent::kTwoParticleDecay) {
-    if (!fgHFSecondaryVerticesArray) fgHFSecondaryVerticesArray = new TClonesArray("StHFPair");
-    mHFSecondaryVerticesArray = fgHFSecondaryVerticesArray;
+    mHFSecondaryVerticesArray = new TClonesArray("StHFPair");
   }
   else {
-    if (!fgHFSecondaryVerticesArray) fgHFSecondaryVerticesArray = new TClonesArray("StHFPair");
-    mHFSecondaryVerticesArray = fgHFSecondaryVerticesArray;
+    mHFSecondaryVerticesArray = new TClonesArray("StHFPair");
   }
+
+  mHFDaughtersArray = new TClonesArray("StHFDaughter");
+}
+
+// _________________________________________________________
+StPicoHFEvent::~StPicoHFEvent() {
+  // -- Destructor
+  clear("C");
+
+  delete mHFSecondaryVerticesArray;
+  delete mHFTertiaryVerticesArray;
+  delete mHFDaughtersArray;
 }
 
 // _________________________________________________________
@@ -51,14 +60,29 @@ void StPicoHFEvent::addPicoEvent(StPicoEvent const & picoEvent) {
 
 // _________________________________________________________
 void StPicoHFEvent::clear(char const *option) {
+  // -- keep enough space for the largest event seen so far
+  if (mNHFSecondaryVertices > mNHFSecondaryVerticesMax)
+    mNHFSecondaryVerticesMax = mNHFSecondaryVertices;
+  if (mNHFTertiaryVertices > mNHFTertiaryVerticesMax)
+    mNHFTertiaryVerticesMax = mNHFTertiaryVertices;
+
   mHFSecondaryVerticesArray->Clear(option);
-  if (mHFTertiaryVerticesArray)
+  if (mHFSecondaryVerticesArray->GetSize() < static_cast<int>(mNHFSecondaryVerticesMax))
+    mHFSecondaryVerticesArray->Expand(mNHFSecondaryVerticesMax);
+
+  if (mHFTertiaryVerticesArray) {
     mHFTertiaryVerticesArray->Clear(option);
+    if (mHFTertiaryVerticesArray->GetSize() < static_cast<int>(mNHFTertiaryVerticesMax))
+      mHFTertiaryVerticesArray->Expand(mNHFTertiaryVerticesMax);
+  }
   
+  mHFDaughtersArray->Clear(option);
+
   mRunId                = -1;
   mEventId              = -1;
   mNHFSecondaryVertices = 0;
   mNHFTertiaryVertices  = 0;
+  mNHFDaughters         = 0;
 }
 
 // _________________________________________________________
@@ -78,3 +102,66 @@ void StPicoHFEvent::addHFTertiaryVertexPair(StHFPair const* t) {
   TClonesArray &vertexArray = *mHFTertiaryVerticesArray;
   new(vertexArray[mNHFTertiaryVertices++]) StHFPair(t);
 }
+
+// _________________________________________________________
+StHFPair* StPicoHFEvent::emplaceHFSecondaryVertexPair() {
+  TClonesArray &vertexArray = *mHFSecondaryVerticesArray;
+  return new(vertexArray[mNHFSecondaryVertices++]) StHFPair();
+}
+
+// _________________________________________________________
+StHFPair* StPicoHFEvent::emplaceHFSecondaryVertexPair(StHFCachedTrack const & particle1, StHFCascadeV0 const & particle2,
+						      float const p1MassHypo, float const p2MassHypo) {
+  TClonesArray &vertexArray = *mHFSecondaryVerticesArray;
+  return new(vertexArray[mNHFSecondaryVertices++]) StHFPair(particle1, particle2, p1MassHypo, p2MassHypo);
+}
+
+// _________________________________________________________
+StHFTriplet* StPicoHFEvent::emplaceHFSecondaryVertexTriplet(StHFCachedTrack const & particle1, StHFCachedTrack const & particle2, 
+							    StHFCachedTrack const & particle3, 
+							    float const p1MassHypo, float const p2MassHypo, float const p3MassHypo,
+							    StThreeVectorF const & vtx, float const bField) {
+  TClonesArray &vertexArray = *mHFSecondaryVerticesArray;
+  return new(vertexArray[mNHFSecondaryVertices++]) StHFTriplet(particle1, particle2, particle3, 
+							       p1MassHypo, p2MassHypo, p3MassHypo, vtx, bField);
+}
+
+// _________________________________________________________
+StHFTriplet* StPicoHFEvent::emplaceHFSecondaryVertexTriplet(StHFTripletSeed const & seed, 
+							    float const p1MassHypo, float const p2MassHypo, float const p3MassHypo,
+							    StThreeVectorF const & vtx, float const bField) {
+  TClonesArray &vertexArray = *mHFSecondaryVerticesArray;
+  return new(vertexArray[mNHFSecondaryVertices++]) StHFTriplet(*seed.particle1, *seed.particle2, *seed.particle3, 
+							       seed.dca12, seed.dca23, seed.dca31,
+							       p1MassHypo, p2MassHypo, p3MassHypo, vtx, bField);
+}
+
+// _________________________________________________________
+StHFPair* StPicoHFEvent::emplaceHFTertiaryVertexPair() {
+  TClonesArray &vertexArray = *mHFTertiaryVerticesArray;
+  return new(vertexArray[mNHFTertiaryVertices++]) StHFPair();
+}
+
+// _________________________________________________________
+void StPicoHFEvent::compactHFVertices() {
+  // -- remove slots behind the last stored candidate, left by rollbackHF...()
+
+  for (int idx = mHFSecondaryVerticesArray->GetEntriesFast() - 1; idx >= static_cast<int>(mNHFSecondaryVertices); --idx)
+    mHFSecondaryVerticesArray->RemoveAt(idx);
+
+  if (mHFTertiaryVerticesArray) {
+    for (int idx = mHFTertiaryVerticesArray->GetEntriesFast() - 1; idx >= static_cast<int>(mNHFTertiaryVertices); --idx)
+      mHFTertiaryVerticesArray->RemoveAt(idx);
+  }
+}
+
+// _________________________________________________________
+void StPicoHFEvent::addHFDaughter(StPicoTrack const & trk, unsigned short const idx, float const tofBeta) {
+  TClonesArray &daughterArray = *mHFDaughtersArray;
+  new(daughterArray[mNHFDaughters++]) StHFDaughter(trk, idx, tofBeta);
+}
+
+// _________________________________________________________
+StHFDaughter const * StPicoHFEvent::hfDaughter(unsigned short const idx) const {
+  return StHFDaughter::find(mHFDaughtersArray, mNHFDaughters, idx);
+}
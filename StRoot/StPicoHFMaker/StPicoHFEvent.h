@@ -10,6 +10,24 @@
  *   - StPicoHFEvent::kTwoAndTwoParticleDecay ->  two particle decay at secondary vertex (A -> B + C)
  *                                                and two particle decay at tertiary vertex (C -> D + E)
  *
+ *  The candidate arrays are owned by each instance, so that several 
+ *  events can be filled at the same time (e.g. by worker threads)
+ *
+ *  Candidates can be constructed directly in the arrays, without a
+ *  temporary copy, via emplaceHF...(). If the candidate does not pass
+ *  the cuts, rollbackHF...() frees the slot again, it is reused by the
+ *  next candidate. compactHFVertices() removes such slots from the 
+ *  arrays, it has to be called before the event is written.
+ *  The largest number of candidates seen in previous events is used 
+ *  as capacity hint of the arrays, so that they do not need to grow 
+ *  during an event.
+ *
+ *  Optionally compact copies of the daughter tracks of the candidates
+ *  (StHFDaughter) are stored via addHFDaughter(...), in increasing order 
+ *  of their StPicoDst index. hfDaughter(idx) returns the daughter with
+ *  the StPicoDst index idx (NULL if not stored), so that candidates can 
+ *  be analysed without the StPicoDst.
+ *
  *  Authors:  Xin Dong        (xdong@lbl.gov)
  *            Michael Lomnitz (mrlomnitz@lbl.gov)
  *            Mustafa Mustafa (mmustafa@lbl.gov)
@@ -20,18 +38,24 @@
 
 #include "TObject.h"
 #include "TClonesArray.h"
+#include "StThreeVectorF.hh"
 
 class StPicoEvent;
+class StPicoTrack;
 
 class StHFPair;
 class StHFTriplet;
+class StHFCachedTrack;
+class StHFCascadeV0;
+class StHFDaughter;
+struct StHFTripletSeed;
 
 class StPicoHFEvent : public TObject
 {
 public:
    StPicoHFEvent();
    StPicoHFEvent(unsigned int mode);
-   ~StPicoHFEvent(){ clear("C");}
+   ~StPicoHFEvent();
    void  clear(char const *option = "");
    void  addPicoEvent(StPicoEvent const & picoEvent);
 
@@ -40,12 +64,41 @@ public:
    void  addHFSecondaryVertexTriplet(StHFTriplet const*);
    void  addHFTertiaryVertexPair(StHFPair const*);
 
+   // -- construct pair or triplet directly in the array
+   //    pairs have to be filled by StHFPair::createGoodPair(...)
+   StHFPair*    emplaceHFSecondaryVertexPair();
+   StHFPair*    emplaceHFSecondaryVertexPair(StHFCachedTrack const & particle1, StHFCascadeV0 const & particle2,
+						float p1MassHypo, float p2MassHypo);
+   StHFTriplet* emplaceHFSecondaryVertexTriplet(StHFCachedTrack const & particle1, StHFCachedTrack const & particle2, 
+						StHFCachedTrack const & particle3, 
+						float p1MassHypo, float p2MassHypo, float p3MassHypo,
+						StThreeVectorF const & vtx, float bField);
+   StHFTriplet* emplaceHFSecondaryVertexTriplet(StHFTripletSeed const & seed, 
+						float p1MassHypo, float p2MassHypo, float p3MassHypo,
+						StThreeVectorF const & vtx, float bField);
+   StHFPair*    emplaceHFTertiaryVertexPair();
+
+   // -- remove last emplaced candidate
+   void  rollbackHFSecondaryVertex();
+   void  rollbackHFTertiaryVertex();
+
+   // -- remove slots of rolled back candidates from the arrays
+   void  compactHFVertices();
+
+   // -- add daughter track, has to be called in increasing order of idx
+   void  addHFDaughter(StPicoTrack const & trk, unsigned short idx, float tofBeta);
+
    // -- get array with particles from secondary and tertiary vertex
    TClonesArray const * aHFSecondaryVertices() const;
    unsigned int         nHFSecondaryVertices() const;
    TClonesArray const * aHFTertiaryVertices()  const;
    unsigned int         nHFTertiaryVertices()  const;
 
+   // -- get stored daughter tracks
+   TClonesArray const * aHFDaughters()  const;
+   unsigned int         nHFDaughters()  const;
+   StHFDaughter const * hfDaughter(unsigned short idx) const;
+
    // -- get variables from StPicoEvent
    Int_t runId()   const;
    Int_t eventId() const;
@@ -54,6 +107,8 @@ public:
    enum eHFEventMode {kTwoParticleDecay, kThreeParticleDecay,kTwoAndTwoParticleDecay };
 
 private:
+   StPicoHFEvent(StPicoHFEvent const &);
+   StPicoHFEvent& operator=(StPicoHFEvent const &);
 
    // -- some variables below are kept in ROOT types to match the same ones in StPicoEvent
    Int_t                mRunId;                       // run number
@@ -61,14 +116,16 @@ private:
 
    unsigned int         mNHFSecondaryVertices;        // number of stored secondary vertex candidates
    unsigned int         mNHFTertiaryVertices;         // number of stored tertiary vertex candidates
+   unsigned int         mNHFDaughters;                // number of stored daughter tracks
 
-   TClonesArray*        mHFSecondaryVerticesArray;    // secondary vertex candidates
-   static TClonesArray* fgHFSecondaryVerticesArray;
+   TClonesArray*        mHFSecondaryVerticesArray;    // secondary vertex candidates, owned by each event
+   TClonesArray*        mHFTertiaryVerticesArray;     // tertiary vertex candidates, owned by each event
+   TClonesArray*        mHFDaughtersArray;            // daughter tracks of candidates, sorted by StPicoDst index
 
-   TClonesArray*        mHFTertiaryVerticesArray;     // tertiary vertex candidates
-   static TClonesArray* fgHFTertiaryVerticesArray;
+   unsigned int         mNHFSecondaryVerticesMax;     //! largest number of secondary vertex candidates in an event
+   unsigned int         mNHFTertiaryVerticesMax;      //! largest number of tertiary vertex candidates in an event
 
-   ClassDef(StPicoHFEvent, 1)
+   ClassDef(StPicoHFEvent, 2)
 };
 
 inline TClonesArray const * StPicoHFEvent::aHFSecondaryVertices() const { return mHFSecondaryVerticesArray;}
@@ -77,6 +134,12 @@ inline unsigned int         StPicoHFEvent::nHFSecondaryVertices() const { return
 inline TClonesArray const * StPicoHFEvent::aHFTertiaryVertices()  const { return mHFTertiaryVerticesArray;}
 inline unsigned int         StPicoHFEvent::nHFTertiaryVertices()  const { return mNHFTertiaryVertices; }
 
+inline TClonesArray const * StPicoHFEvent::aHFDaughters()         const { return mHFDaughtersArray;}
+inline unsigned int         StPicoHFEvent::nHFDaughters()         const { return mNHFDaughters; }
+
+inline void  StPicoHFEvent::rollbackHFSecondaryVertex() { --mNHFSecondaryVertices; }
+inline void  StPicoHFEvent::rollbackHFTertiaryVertex()  { --mNHFTertiaryVertices; }
+
 inline Int_t StPicoHFEvent::runId()        const { return mRunId; }
 inline Int_t StPicoHFEvent::eventId()      const { return mEventId; }
 
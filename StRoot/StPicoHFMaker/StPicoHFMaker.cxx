@@ -1,8 +1,12 @@
 #include <vector>
+#include <algorithm>
+#include <iterator>
 
 #include "TTree.h"
 #include "TFile.h"
+#include "TDirectory.h"
 #include "TChain.h"
+#include "TThread.h"
 
 #include "phys_constants.h"
 #include "StThreeVectorF.hh"
@@ -14,22 +18,92 @@
 #include "StPicoDstMaker/StPicoBTofPidTraits.h"
 
 #include "StHFCuts.h"
+#include "StHFCutPredicates.h"
 #include "StPicoHFEvent.h"
 #include "StPicoHFMaker.h"
 #include "StHFPair.h"
 #include "StHFTriplet.h"
+#include "StHFTripletBuilder.h"
+#include "StHFCascadeV0.h"
+#include "StHFTrackCache.h"
+#include "StHFTrackTable.h"
+#include "StHFMassWindowFilter.h"
+#include "StHFDirectionGrid.h"
+#include "StHFEventSnapshot.h"
+#include "StHFWorkQueue.h"
+#include "StHFCandidateTree.h"
+#include "StHFEventIndex.h"
+#include "StHFDaughter.h"
+#include "StHFTrackSelection.h"
+#include "StHFEventArena.h"
+#include "StHFStageProfiler.h"
+#include "StHFCaptureFile.h"
 
 ClassImp(StPicoHFMaker)
 
+namespace {
+  // -- names of eProfileStage and eProfileCounter
+  char const * const aStageNames[StPicoHFMaker::kStageMax] = 
+    {"outside", "hfTreeRead", "eventSetup", "trackSelection", "makeHF", "storeDaughters", "treeFill"};
+  char const * const aCounterNames[StPicoHFMaker::kCountMax] = 
+    {"events", "goodEvents", "tracks", "pions", "kaons", "protons", "candidates", "bytesWritten", "pairsTried",
+     "pairsPassDcaDaughters", "pairsPassMass", "pairsPassDecayLength", "pairsPassPointingAngle",
+     "tripletPairsTried", "tripletPairsPassDcaDaughters12", "tripletsTried"};
+
+  // -- track cuts of all tracks of an event, via StHFCutPredicates::dispatchTrack(...)
+  //    once per event, so that the loop is compiled for the specialised predicate
+  struct GoodTrackLoop {
+    GoodTrackLoop(std::vector<StPicoTrack const*> const & tracks, std::vector<unsigned char> & good) : 
+      mTracks(tracks), mGood(good) {;}
+
+    template <class Pred> void operator()(Pred const & pred) {
+      for (unsigned int ii = 0; ii < mTracks.size(); ++ii)
+	mGood[ii] = mTracks[ii] && pred(mTracks[ii]->isHFTTrack(), mTracks[ii]->nHitsFit());
+    }
+
+    std::vector<StPicoTrack const*> const & mTracks;
+    std::vector<unsigned char> & mGood;
+  };
+}
+
 // _________________________________________________________
 StPicoHFMaker::StPicoHFMaker(char const* name, StPicoDstMaker* picoMaker, 
 				       char const* outputBaseFileName,  char const* inputHFListHFtree = "") :
-  StMaker(name), mPicoDst(NULL), mHFCuts(NULL), mPicoHFEvent(NULL), mBField(0.), mOutList(NULL),
+  StMaker(name), mPicoDst(NULL), mHFCuts(NULL), mPicoHFEvent(NULL), mBField(0.), mOutList(NULL), mTrackCache(NULL), mTrackTable(NULL), mMassFilter(NULL), mGrid(NULL), mEventArena(NULL),
   mDecayMode(StPicoHFEvent::kTwoParticleDecay), mMakerMode(StPicoHFMaker::kAnalyse), 
+  mMassFilterMode(StHFMassWindowFilter::kNoMassFilter), mDirectionGridMode(StHFDirectionGrid::kNoGrid), 
+  mNPairPartners(0), mGridPartners(), mPartnersIntersection(), 
+  mV0MassFilter(NULL), mV0Grid(NULL), mV0NPairPartners(0), mV0Partners(), mV0Positive1(), mV0Negative1(), mV0Positive2(), mV0Negative2(), mTripletBuilder(NULL), mHFCutsVariants(), mVariantOutLists(),
+  mNThreads(0), mIsWorker(false), mWorkers(), mThreadPool(NULL), mEventQueue(NULL), mFreeQueue(NULL), mNSnapshots(0), mSnapshot(NULL), mNEventsFailed(0),
   mOuputFileBaseName(outputBaseFileName), mInputFileName(inputHFListHFtree),
-  mPicoDstMaker(picoMaker), mPicoEvent(NULL), mTree(NULL), mHFChain(NULL), mEventCounter(0), 
+  mPicoDstMaker(picoMaker), mPicoEvent(NULL), mTree(NULL), 
+  mTreeFormat(StPicoHFMaker::kObjectTree), mFlatTreeColumns(""), mFlatTree(NULL),
+  mHFChain(NULL), mEventCounter(0), 
+  mReadMode(StPicoHFMaker::kSequentialRead), mHFTreeIndexFileName(""), mEventIndex(NULL), mNEventsNoHFEntry(0),
+  mStoreDaughters(false),
+  mTrackSelectionMode(StPicoHFMaker::kPerTrackSelection), mTrackSelection(NULL), mSelectedTracks(), mPerTrackTracks(), mPerTrackGood(),
+  mProfiling(false), mProfiler(NULL), mWorkerProfiler(NULL),
+  mCaptureFileName(""), mCapturePrescale(1), mCaptureMinTracks(0), mCaptureNEventsMax(0), 
+  mNCaptureCandidates(0), mCaptureWriter(NULL),
   mOutputFileTree(NULL), mOutputFileList(NULL) {
   // -- constructor
+
+  mTrackCache = new StHFTrackCache;
+  mTrackTable = new StHFTrackTable;
+  mMassFilter = new StHFMassWindowFilter;
+  mGrid = new StHFDirectionGrid;
+  mV0MassFilter = new StHFMassWindowFilter;
+  mV0Grid = new StHFDirectionGrid;
+  mTripletBuilder = new StHFTripletBuilder;
+  mTrackSelection = new StHFTrackSelection;
+  mEventArena = new StHFEventArena;
+
+  // -- register stages and counters in order of the enums
+  mProfiler = new StHFStageProfiler;
+  for (int ii = 0; ii < kStageMax; ++ii)
+    mProfiler->addStage(aStageNames[ii]);
+  for (int ii = 0; ii < kCountMax; ++ii)
+    mProfiler->addCounter(aCounterNames[ii]);
 }
 
 
@@ -37,10 +111,36 @@ StPicoHFMaker::StPicoHFMaker(char const* name, StPicoDstMaker* picoMaker,
 StPicoHFMaker::~StPicoHFMaker() {
    // -- destructor 
   
-  if (mHFCuts)
-    delete mHFCuts;
+  // -- cuts and queues are shared with the workers
+  if (mIsWorker) {
+    delete mPicoHFEvent;
+    delete mOutList;
+  }
+  else {
+    stopWorkers();
+    if (mHFCuts)
+      delete mHFCuts;
+    for (unsigned int ii = 0; ii < mHFCutsVariants.size(); ++ii)
+      delete mHFCutsVariants[ii];
+  }
+  mHFCutsVariants.clear();
   mHFCuts = NULL;
 
+  delete mTrackCache;
+  delete mTrackTable;
+  delete mMassFilter;
+  delete mGrid;
+  delete mV0MassFilter;
+  delete mV0Grid;
+  delete mTripletBuilder;
+  delete mTrackSelection;
+  delete mEventArena;
+  delete mProfiler;
+  delete mWorkerProfiler;
+  delete mCaptureWriter;
+  delete mFlatTree;
+  delete mEventIndex;
+
   /* mTree is owned by mOutputFile directory, it will be destructed once
    * the file is closed in ::Finish() */
 }
@@ -54,12 +154,28 @@ Int_t StPicoHFMaker::Init() {
   // -- check for cut class
   if (!mHFCuts)
     mHFCuts = new StHFCuts;
+
+  mProfiler->setEnabled(mProfiling);
+
+  // -- open up base cuts to the envelope of all cut variants
+  for (unsigned int ii = 0; ii < mHFCutsVariants.size(); ++ii)
+    mHFCuts->extendEnvelope(*mHFCutsVariants[ii]);
   
   // -- create HF event - using the proper decay mode to initialize
   mPicoHFEvent = new StPicoHFEvent(mDecayMode);
+
+  // -- flat candidate tree, only for pairs
+  if (mTreeFormat == StPicoHFMaker::kFlatTree && mMakerMode != StPicoHFMaker::kAnalyse) {
+    if (mDecayMode == StPicoHFEvent::kThreeParticleDecay) {
+      LOG_WARN << " StPicoHFMaker - Flat tree format not available for three particle decays, use object tree!" << endm;
+      mTreeFormat = StPicoHFMaker::kObjectTree;
+    }
+    else 
+      mFlatTree = new StHFCandidateTree;
+  }
  
   // -- READ ------------------------------------
-  if (mMakerMode == StPicoHFMaker::kRead) {
+  if (mMakerMode == StPicoHFMaker::kRead || mMakerMode == StPicoHFMaker::kReplay) {
 
     if (!mHFChain) {
       mHFChain = new TChain("T");
@@ -75,10 +191,35 @@ Int_t StPicoHFMaker::Init() {
 	LOG_ERROR << " StPicoHFMaker - Could not open list of files. ABORT!" << endm;
 	return kStErr;
       }
-    } // if (mMakerMode == StPicoHFMaker::kRead) {
+    } // if (!mHFChain) {
+
+    // -- index of HF tree, before branches are set up
+    if (mReadMode == StPicoHFMaker::kIndexedRead && mMakerMode == StPicoHFMaker::kRead) {
+      mEventIndex = new StHFEventIndex;
+      Long64_t const nEntries = mHFChain->GetEntries();
+
+      if (mHFTreeIndexFileName.IsNull() || !mEventIndex->read(mHFTreeIndexFileName.Data(), nEntries)) {
+	LOG_INFO << " StPicoHFMaker - Build index of " << nEntries << " HF tree entries" << endm;
+	mEventIndex->build(mHFChain, mFlatTree ? "runId" : "mRunId", mFlatTree ? "eventId" : "mEventId");
+	
+	if (!mHFTreeIndexFileName.IsNull() && !mEventIndex->write(mHFTreeIndexFileName.Data()))
+	  LOG_WARN << " StPicoHFMaker - Could not save index to " << mHFTreeIndexFileName << endm;
+      }
+      
+      if (mEventIndex->nDuplicates())
+	LOG_WARN << " StPicoHFMaker - " << mEventIndex->nDuplicates() << " duplicated events in HF tree, first entry is used" << endm;
+    }
 
-    mHFChain->GetBranch("hfEvent")->SetAutoDelete(kFALSE);
-    mHFChain->SetBranchAddress("hfEvent", &mPicoHFEvent);
+    if (mFlatTree) {
+      if (!mFlatTree->setupRead(mHFChain, mFlatTreeColumns.Data())) {
+	LOG_ERROR << " StPicoHFMaker - HF tree has no flat candidate branches. ABORT!" << endm;
+	return kStErr;
+      }
+    }
+    else {
+      mHFChain->GetBranch("hfEvent")->SetAutoDelete(kFALSE);
+      mHFChain->SetBranchAddress("hfEvent", &mPicoHFEvent);
+    }
   }
   
   // -- file which holds list of histograms
@@ -96,7 +237,10 @@ Int_t StPicoHFMaker::Init() {
     if (!mTree) 
       mTree = new TTree("T", "T", BufSize);
     mTree->SetAutoSave(1000000); // autosave every 1 Mbytes
-    mTree->Branch("hfEvent", "StPicoHFEvent", &mPicoHFEvent, BufSize, Split);
+    if (mFlatTree)
+      mFlatTree->createBranches(mTree, mDecayMode == StPicoHFEvent::kTwoAndTwoParticleDecay);
+    else
+      mTree->Branch("hfEvent", "StPicoHFEvent", &mPicoHFEvent, BufSize, Split);
   } // if (mMakerMode == StPicoHFMaker::kWrite) {
 
   // -- disable automatic adding of objects to file
@@ -111,14 +255,36 @@ Int_t StPicoHFMaker::Init() {
   // -- create event stat histograms
   initializeEventStats();
 
+  // -- lists for histograms of cut variants
+  createVariantOutLists();
+
   // -- call method of daughter class
   InitHF();
 
+  // -- requirements for kBatchSelection
+  initTrackSelection();
+
+  // -- cuts are final, select their specialised predicates before workers share them
+  mHFCuts->finalize();
+  for (unsigned int ii = 0; ii < mHFCutsVariants.size(); ++ii)
+    mHFCutsVariants[ii]->finalize();
+
+  // -- capture file, if requested
+  if (!mCaptureFileName.IsNull())
+    initCapture();
+
+  // -- create workers, they call InitHF() themselves
+  if (mNThreads > 1 && !startWorkers()) 
+    LOG_WARN << " StPicoHFMaker - Could not start " << mNThreads << " workers, run in one thread!" << endm;
+
   TH1::AddDirectory(oldStatus);
 
   // -- reset event to be in a defined state
   resetEvent();
 
+  // -- time until first event
+  mProfiler->start(kStageOutside);
+
   return kStOK;
 }
 
@@ -128,6 +294,24 @@ Int_t StPicoHFMaker::Finish() {
   //    NOT TO BE OVERWRITTEN by daughter class
   //    daughter class should implement FinishHF()
 
+  // -- process all queued events and add histograms of workers
+  stopWorkers();
+
+  if (mEventIndex)
+    LOG_INFO << " StPicoHFMaker - Read " << mEventCounter << " HF tree entries, " 
+	     << mNEventsNoHFEntry << " events without HF tree entry" << endm;
+
+  LOG_INFO << " StPicoHFMaker - Event arena : high-water mark " << mEventArena->highWaterMark() << " bytes, "
+	   << mEventArena->nEventsGrown() << " events with heap allocations" << endm;
+
+  if (mProfiler->isEnabled())
+    writeProfile();
+
+  if (mCaptureWriter) {
+    LOG_INFO << " StPicoHFMaker - Captured " << mCaptureWriter->nEvents() << " events to " << mCaptureFileName << endm;
+    mCaptureWriter->close();
+  }
+
   if (mMakerMode == StPicoHFMaker::kWrite) {
     mOutputFileTree->cd();
     mOutputFileTree->Write();
@@ -153,7 +337,10 @@ void StPicoHFMaker::resetEvent() {
   mIdxPicoKaons.clear();
   mIdxPicoProtons.clear();
   
-  mPicoHFEvent->clear("C");
+  // -- candidates and daughters own no memory, no Clear() per object needed
+  mPicoHFEvent->clear("");
+
+  mEventArena->reset();
 }
 
 // _________________________________________________________
@@ -173,10 +360,41 @@ Int_t StPicoHFMaker::Make() {
   // -- Inhertited from StMaker 
   //    NOT TO BE OVERWRITTEN by daughter class
   //    daughter class should implement MakeHF()
+
+  mProfiler->stop(kStageOutside);
+  mProfiler->count(kCountEvents);
+
+  Int_t const iReturn = makeEvent();
+
+  mProfiler->start(kStageOutside);
+
+  return iReturn;
+}
+
+// _________________________________________________________
+Int_t StPicoHFMaker::makeEvent() {
+  // -- process one event, called by Make()
   // -- isPion, isKaon, isProton methods are to be 
   //    implemented by daughter class (
   //    -> methods of StHFCuts can and should be used
 
+  // -- replay of HF tree, without picoDst
+  if (mMakerMode == StPicoHFMaker::kReplay) {
+    if (mEventCounter >= getHFEntries())
+      return kStEOF;
+
+    readHFEntry(mEventCounter++);
+    mPicoDst = NULL;
+
+    // -- call method of daughter class
+    mProfiler->start(kStageMakeHF);
+    Int_t iReturn = MakeHF();
+    mProfiler->stop(kStageMakeHF);
+
+    resetEvent();
+    return (kStOK && iReturn);
+  }
+
   if (!mPicoDstMaker) {
     LOG_WARN << " StPicoHFMaker - No PicoDstMaker! Skip! " << endm;
     return kStWarn;
@@ -189,44 +407,76 @@ Int_t StPicoHFMaker::Make() {
   }
   
   // -- read in HF tree
-  if (mMakerMode == StPicoHFMaker::kRead) {
-    mHFChain->GetEntry(mEventCounter++);
+  if (mMakerMode == StPicoHFMaker::kRead && mEventIndex) {
+    Long64_t const entry = mEventIndex->entry(mPicoDst->event()->runId(), mPicoDst->event()->eventId());
+    if (entry < 0) {
+      // -- no candidates for this event : fill the event statistics 
+      //    as for sequential reads, then skip it
+      ++mNEventsNoHFEntry;
+      setupEvent();
+      resetEvent();
+      return kStOK;
+    }
+
+    readHFEntry(entry);
+    ++mEventCounter;
+  }
+  else if (mMakerMode == StPicoHFMaker::kRead) {
+    readHFEntry(mEventCounter++);
+
+    Int_t const runId   = mFlatTree ? mFlatTree->runId()   : mPicoHFEvent->runId();
+    Int_t const eventId = mFlatTree ? mFlatTree->eventId() : mPicoHFEvent->eventId();
 
-    if (mPicoHFEvent->runId() != mPicoDst->event()->runId() || mPicoHFEvent->eventId() != mPicoDst->event()->eventId()) {
+    if (runId != mPicoDst->event()->runId() || eventId != mPicoDst->event()->eventId()) {
       LOG_ERROR <<" StPicoHFMaker - !!!!!!!!!!!! ATTENTION !!!!!!!!!!!!!"<<endm;
       LOG_ERROR <<" StPicoHFMaker - SOMETHING TERRIBLE JUST HAPPENED. StPicoEvent and StPicoHFEvent are not in sync."<<endm;
       exit(1);
     }
-  } // if (mMakerMode == StPicoHFMaker::kRead) {
+  } // else if (mMakerMode == StPicoHFMaker::kRead) {
   
+  // -- hand over good events to the workers
+  if (!mWorkers.empty()) {
+    if (setupEvent())
+      queueEvent();
+
+    resetEvent();
+    return kStOK;
+  }
+
   Int_t iReturn = kStOK;
 
   if (setupEvent()) {
-    UInt_t nTracks = mPicoDst->numberOfTracks();
-
     // -- Fill vectors of particle types
-    if (mMakerMode == StPicoHFMaker::kWrite || mMakerMode == StPicoHFMaker::kAnalyse) {
-      for (unsigned short iTrack = 0; iTrack < nTracks; ++iTrack) {
-	StPicoTrack* trk = mPicoDst->track(iTrack);
-	
-	if (!trk || !mHFCuts->isGoodTrack(trk)) continue;
+    prepareTracks();
 
-	float const beta = getTofBeta(trk);
-	if (isPion(trk, beta))   mIdxPicoPions.push_back(iTrack);   // isPion method to be implemented by daughter class
-	if (isKaon(trk, beta))   mIdxPicoKaons.push_back(iTrack);   // isKaon method to be implemented by daughter class
-	if (isProton(trk, beta)) mIdxPicoProtons.push_back(iTrack); // isProton method to be implemented by daughter class
-      
-      } // .. end tracks loop
-    } // if (mMakerMode == StPicoHFMaker::kWrite || mMakerMode == StPicoHFMaker::kAnalyse) {
+    if (mCaptureWriter)
+      captureEvent();
 
     // -- call method of daughter class
+    mProfiler->start(kStageMakeHF);
     iReturn = MakeHF();
+    mProfiler->stop(kStageMakeHF);
+
+    mProfiler->count(kCountCandidates, mPicoHFEvent->nHFSecondaryVertices() + mPicoHFEvent->nHFTertiaryVertices());
+
+    // -- add daughters of stored candidates
+    if (mMakerMode == StPicoHFMaker::kWrite && mStoreDaughters)
+      storeDaughters();
 
   } // if (setupEvent()) {
   
   // -- save information about all events, good or bad
-  if (mMakerMode == StPicoHFMaker::kWrite)
-    mTree->Fill();
+  if (mMakerMode == StPicoHFMaker::kWrite) {
+    StHFStageTimer timer(*mProfiler, kStageTreeFill);
+
+    if (mFlatTree)
+      mFlatTree->fill(*mPicoHFEvent);
+    else
+      mPicoHFEvent->compactHFVertices();
+    Int_t const nBytes = mTree->Fill();
+    if (nBytes > 0)
+      mProfiler->count(kCountBytesWritten, nBytes);
+  }
   
   // -- reset event to be in a defined state
   resetEvent();
@@ -234,36 +484,272 @@ Int_t StPicoHFMaker::Make() {
   return (kStOK && iReturn);
 }
 
+// _________________________________________________________
+void StPicoHFMaker::prepareTracks() {
+  // -- fill vectors of particle types, track cache and track table
+  //    from mPicoDst or, for workers, from the event snapshot
+
+  StHFStageTimer timer(*mProfiler, kStageTrackSelection);
+
+  UInt_t nTracks = mSnapshot ? mSnapshot->numberOfTracks() : mPicoDst->numberOfTracks();
+
+  mTrackCache->reset(nTracks, mPrimVtx, mBField);
+  mTrackTable->reset(nTracks, mPrimVtx.x(), mPrimVtx.y(), mPrimVtx.z(), mBField);
+
+  if (mMakerMode != StPicoHFMaker::kWrite && mMakerMode != StPicoHFMaker::kAnalyse) 
+    return;
+
+  mProfiler->count(kCountTracks, nTracks);
+
+  if (mTrackSelectionMode == StPicoHFMaker::kBatchSelection)
+    selectTracks();
+  else
+    selectTracksPerTrack(nTracks);
+
+  mProfiler->count(kCountPions,   mIdxPicoPions.size());
+  mProfiler->count(kCountKaons,   mIdxPicoKaons.size());
+  mProfiler->count(kCountProtons, mIdxPicoProtons.size());
+}
+
+// _________________________________________________________
+void StPicoHFMaker::selectTracksPerTrack(UInt_t const nTracks) {
+  // -- kPerTrackSelection : fill vectors of particle types, track cache and track table
+  //    via isPion, isKaon, isProton per track
+
+  // -- track cuts for all tracks, predicate specialised once per event
+  mPerTrackTracks.resize(nTracks);
+  mPerTrackGood.resize(nTracks);
+  for (unsigned short iTrack = 0; iTrack < nTracks; ++iTrack)
+    mPerTrackTracks[iTrack] = picoTrack(iTrack);
+
+  GoodTrackLoop goodTrackLoop(mPerTrackTracks, mPerTrackGood);
+  StHFCutPredicates::dispatchTrack(*mHFCuts, goodTrackLoop);
+
+  for (unsigned short iTrack = 0; iTrack < nTracks; ++iTrack) {
+    if (!mPerTrackGood[iTrack]) continue;
+
+    StPicoTrack const* trk = mPerTrackTracks[iTrack];
+    
+    float const beta = mSnapshot ? mSnapshot->tofBeta(iTrack) : getTofBeta(trk);
+    bool bSelected = false;
+    if (isPion(trk, beta))   { mIdxPicoPions.push_back(iTrack);   bSelected = true; } // isPion method to be implemented by daughter class
+    if (isKaon(trk, beta))   { mIdxPicoKaons.push_back(iTrack);   bSelected = true; } // isKaon method to be implemented by daughter class
+    if (isProton(trk, beta)) { mIdxPicoProtons.push_back(iTrack); bSelected = true; } // isProton method to be implemented by daughter class
+    
+    // -- do helix setup only once per track and event
+    if (bSelected)
+      mTrackCache->add(trk, iTrack)->addToTable(*mTrackTable, beta);
+    
+  } // .. end tracks loop
+}
+
+// _________________________________________________________
+void StPicoHFMaker::selectTracks() {
+  // -- kBatchSelection : fill vectors of particle types, track cache and track table
+  //    evaluate cuts for all tracks at once, then select particles in one sweep
+
+  UInt_t nTracks = mSnapshot ? mSnapshot->numberOfTracks() : mPicoDst->numberOfTracks();
+
+  mTrackSelection->reset(nTracks);
+
+  for (unsigned short iTrack = 0; iTrack < nTracks; ++iTrack) {
+    StPicoTrack const* trk = picoTrack(iTrack);
+    if (!trk) continue;
+
+    StThreeVectorF const & pMom = trk->pMom();
+    float const beta = mSnapshot ? mSnapshot->tofBeta(iTrack) : getTofBeta(trk);
+
+    mTrackSelection->addTrack(iTrack, pMom.perp(), pMom.pseudoRapidity(), pMom.mag(), beta,
+			      trk->nSigmaPion(), trk->nSigmaKaon(), trk->nSigmaProton(), 
+			      trk->nHitsFit(), trk->isHFTTrack());
+  }
+
+  mTrackSelection->evaluate(*mHFCuts);
+
+  // -- evaluateTracks method to be implemented by daughter class (optional)
+  evaluateTracks(*mTrackSelection);
+
+  mSelectedTracks.clear();
+  mTrackSelection->select(mIdxPicoPions, mIdxPicoKaons, mIdxPicoProtons, mSelectedTracks);
+
+  // -- do helix setup only once per track and event
+  unsigned short const * idx     = mTrackSelection->idx();
+  float const *          tofBeta = mTrackSelection->tofBeta();
+
+  for (unsigned int ii = 0; ii < mSelectedTracks.size(); ++ii) {
+    unsigned int const entry = mSelectedTracks[ii];
+    mTrackCache->add(picoTrack(idx[entry]), idx[entry])->addToTable(*mTrackTable, tofBeta[entry]);
+  }
+}
+
+// _________________________________________________________
+void StPicoHFMaker::initTrackSelection() {
+  // -- get requirements of kBatchSelection from daughter class, 
+  //    fall back to isPion, isKaon, isProton if not implemented
+
+  if (mTrackSelectionMode != StPicoHFMaker::kBatchSelection)
+    return;
+
+  mTrackSelection->clearRequirements();
+
+  if (!setupTrackSelection(*mTrackSelection) || !mTrackSelection->hasRequirements()) {
+    LOG_WARN << " StPicoHFMaker - No requirements for kBatchSelection set via setupTrackSelection(...)," 
+	     << " use isPion, isKaon, isProton!" << endm;
+    mTrackSelectionMode = StPicoHFMaker::kPerTrackSelection;
+  }
+}
+
 // _________________________________________________________
 void StPicoHFMaker::createTertiaryK0Shorts() {
-  // -- Create candidate for tertiary K0shorts
-  //    only store pairs with opposite charge
+  // -- Create candidates for tertiary K0shorts
+  //    only pairs with opposite charge are tried and stored
+
+  createTertiaryV0s(mIdxPicoPions, M_PION_PLUS, mIdxPicoPions, M_PION_MINUS, true);
+}
+
+// _________________________________________________________
+void StPicoHFMaker::createTertiaryV0s(std::vector<unsigned short> const & idxList1, float const mass1,
+				      std::vector<unsigned short> const & idxList2, float const mass2, bool const bSameList) {
+  // -- Create candidates for tertiary V0s, pairs of particle 1 and particle 2 with opposite charge
+  //    (e.g. K0S -> pi+ pi-, Lambda -> p pi-)
+  //    lists are split by charge up front, like-sign pairs are never built
+  //    if both are the same list (bSameList), only idxList1 is used and every pair is tried once as (+,-)
+
+  splitByCharge(idxList1, mV0Positive1, mV0Negative1);
+  if (!bSameList)
+    splitByCharge(idxList2, mV0Positive2, mV0Negative2);
+
+  // -- candidate is constructed in the event, the slot is reused until a pair passes the cuts
+  StHFPair* candidateV0 = NULL;
+
+  addTertiaryV0s(mV0Positive1, mass1, bSameList ? mV0Negative1 : mV0Negative2, mass2, candidateV0);
+  if (!bSameList)
+    addTertiaryV0s(mV0Negative1, mass1, mV0Positive2, mass2, candidateV0);
+
+  if (candidateV0)
+    mPicoHFEvent->rollbackHFTertiaryVertex();
+}
+
+// _________________________________________________________
+void StPicoHFMaker::splitByCharge(std::vector<unsigned short> const & idxList,
+				  std::vector<unsigned short> & idxPositive, std::vector<unsigned short> & idxNegative) const {
+  // -- split list of particles by the charge of their track table rows, order is kept
+
+  idxPositive.clear();
+  idxNegative.clear();
+
+  float const * const charge = mTrackTable->charge();
 
-  for (unsigned short idxPion1 = 0; idxPion1 < mIdxPicoPions.size(); ++idxPion1) {
-    StPicoTrack const * pion1 = mPicoDst->track(mIdxPicoPions[idxPion1]);
+  for (unsigned int ii = 0; ii < idxList.size(); ++ii) {
+    int const row = mTrackTable->row(idxList[ii]);
+    if (row < 0)
+      continue;
 
-    for (unsigned short idxPion2 = idxPion1+1 ; idxPion2 < mIdxPicoPions.size(); ++idxPion2) {
-      StPicoTrack const * pion2 = mPicoDst->track(mIdxPicoPions[idxPion2]);      
+    if (charge[row] > 0)
+      idxPositive.push_back(idxList[ii]);
+    else if (charge[row] < 0)
+      idxNegative.push_back(idxList[ii]);
+  }
+}
+
+// _________________________________________________________
+void StPicoHFMaker::addTertiaryV0s(std::vector<unsigned short> const & idxList1, float const mass1,
+				   std::vector<unsigned short> const & idxList2, float const mass2, StHFPair* & candidate) {
+  // -- pair every particle of list 1 with the particles of list 2 (of opposite charge, so never the same track)
+  //    which can pass the tertiary pair cuts, keep pairs passing them
+
+  if (idxList1.empty() || idxList2.empty())
+    return;
+
+  // -- own pre-filters, the ones of setupPairPartners(...) may still be used by the daughter class
+  std::vector<unsigned short> & positions = mV0Partners;
+  setupPairPartners(*mV0MassFilter, *mV0Grid, mV0NPairPartners, idxList2, mass2);
 
-      if (mIdxPicoPions[idxPion1] == mIdxPicoPions[idxPion2]) 
+  for (unsigned short idx1 = 0; idx1 < idxList1.size(); ++idx1) {
+    int const row1 = mTrackTable->row(idxList1[idx1]);
+
+    pairPartners(*mV0MassFilter, *mV0Grid, mV0NPairPartners, idxList1[idx1], mass1, StHFCuts::kTertiaryPair, positions);
+
+    for (unsigned short iPos = 0; iPos < positions.size(); ++iPos) {
+      int const row2 = mTrackTable->row(idxList2[positions[iPos]]);
+
+      if (!candidate)
+	candidate = mPicoHFEvent->emplaceHFTertiaryVertexPair();
+
+      // -- pair is built in stages, mass and dcaDaughters cuts are applied first
+      unsigned int nCutsPassed = 0;
+      bool const bGood = mHFCuts->isGoodTertiaryVertexPair(*mTrackTable, row1, row2, mass1, mass2, *candidate, &nCutsPassed);
+      countPairCuts(nCutsPassed);
+      if (!bGood) 
 	continue;
 
-      StHFPair candidateK0Short(pion1, pion2, M_PION_PLUS, M_PION_MINUS, 
-				mIdxPicoPions[idxPion1], mIdxPicoPions[idxPion2], 
-				mPrimVtx, mBField);
+      // -- keep candidate
+      candidate = NULL;
+    }
+  }
+}
+
+// _________________________________________________________
+void StPicoHFMaker::createSecondaryCascades(std::vector<unsigned short> const & idxList1, float const mass1, float const massV0) {
+  // -- Create candidates for secondary pairs of a particle and a tertiary V0 of mPicoHFEvent
+  //    state of every V0 is set up once and used for all particles
+
+  TClonesArray const * aTertiary = mPicoHFEvent->aHFTertiaryVertices();
+  if (!aTertiary)
+    return;
+
+  StHFCascadeV0 v0;
+
+  for (unsigned int idxV0 = 0; idxV0 < mPicoHFEvent->nHFTertiaryVertices(); ++idxV0) {
+    StHFPair const* pairV0 = static_cast<StHFPair const*>(aTertiary->At(idxV0));
+    v0.setup(*pairV0, idxV0, mPrimVtx, mBField, mTrackCache);
 
-      if (!mHFCuts->isGoodTertiaryVertexPair(candidateK0Short)) 
+    for (unsigned short idx1 = 0; idx1 < idxList1.size(); ++idx1) {
+      StHFCachedTrack const * const p1 = cachedTrack(idxList1[idx1]);
+      if (!p1 || v0.isDaughter(*p1))
 	continue;
 
-      mPicoHFEvent->addHFTertiaryVertexPair(&candidateK0Short);
+      StHFPair const* candidate = mPicoHFEvent->emplaceHFSecondaryVertexPair(*p1, v0, mass1, massV0);
+
+      bool const bGood = mHFCuts->isGoodSecondaryVertexPair(*candidate);
+      countPairCuts(*candidate, StHFCuts::kSecondaryPair);
+      if (!bGood) 
+	mPicoHFEvent->rollbackHFSecondaryVertex();
     }
   }
 }
 
+// _________________________________________________________
+void StPicoHFMaker::createSecondaryTriplets(std::vector<unsigned short> const & idxList1, std::vector<unsigned short> const & idxList2,
+					    std::vector<unsigned short> const & idxList3, 
+					    float const mass1, float const mass2, float const mass3, 
+					    bool const sameList23) {
+  // -- Create candidates for secondary triplets, particle i of list i has mass hypothesis mass i
+  //    only combinations passing the dcaDaughters cuts are calculated (see StHFTripletBuilder)
+
+  mTripletBuilder->build(*mTrackCache, idxList1, idxList2, idxList3, sameList23, mass2 == mass3,
+			 mHFCuts->cutSecondaryTripletDcaDaughters12Max(), 
+			 mHFCuts->cutSecondaryTripletDcaDaughters23Max(),
+			 mHFCuts->cutSecondaryTripletDcaDaughters31Max());
+
+  mProfiler->count(kCountTripletPairsTried, mTripletBuilder->nPairsTried());
+  mProfiler->count(kCountTripletPairsPassDcaDaughters12, mTripletBuilder->nPairsPassed());
+  mProfiler->count(kCountTripletsTried, mTripletBuilder->nSeeds());
+
+  for (unsigned int ii = 0; ii < mTripletBuilder->nSeeds(); ++ii) {
+    StHFTriplet const * triplet = mPicoHFEvent->emplaceHFSecondaryVertexTriplet(mTripletBuilder->seed(ii), 
+										 mass1, mass2, mass3, mPrimVtx, mBField);
+    if (!mHFCuts->isGoodSecondaryVertexTriplet(*triplet))
+      mPicoHFEvent->rollbackHFSecondaryVertex();
+  }
+}
+
 // _________________________________________________________
 bool StPicoHFMaker::setupEvent() {
   // -- fill members from pico event, check for good eventa and fill event statistics
 
+  StHFStageTimer timer(*mProfiler, kStageEventSetup);
+
   mPicoEvent = mPicoDst->event();
   mPicoHFEvent->addPicoEvent(*mPicoEvent);
   
@@ -277,6 +763,9 @@ bool StPicoHFMaker::setupEvent() {
   // -- fill event statistics histograms
   fillEventStats(aEventStat);
 
+  if (bResult)
+    mProfiler->count(kCountGoodEvents);
+
   return bResult;
 }
 
@@ -292,6 +781,324 @@ float StPicoHFMaker::getTofBeta(StPicoTrack const * const trk) const {
   return  0.;
 }
 
+// _________________________________________________________
+StHFCachedTrack const * StPicoHFMaker::cachedTrack(unsigned short const idx) const {
+  // -- provide cached track for index in StPicoDst
+  //    tracks in mIdxPicoPions/Kaons/Protons are always cached, 
+  //    other tracks are added on first request
+
+  StHFCachedTrack const * cached = mTrackCache->get(idx);
+  if (cached)
+    return cached;
+
+  return mTrackCache->add(picoTrack(idx), idx);
+}
+
+// _________________________________________________________
+StPicoTrack const * StPicoHFMaker::picoTrack(unsigned short const idx) const {
+  // -- provide track for index in StPicoDst
+  //    workers use the copy of the event they process
+
+  if (mSnapshot)
+    return mSnapshot->track(idx);
+
+  return mPicoDst ? mPicoDst->track(idx) : NULL;
+}
+
+// _________________________________________________________
+StHFDaughter const * StPicoHFMaker::hfDaughter(unsigned short const idx) const {
+  // -- provide stored daughter track for index in StPicoDst
+  //    NULL if it has not been stored (see setStoreDaughters)
+
+  return mPicoHFEvent->hfDaughter(idx);
+}
+
+// _________________________________________________________
+int StPicoHFMaker::getHFEntries() const {
+  // -- number of entries in HF tree, for kRead and kReplay
+  return mHFChain ? mHFChain->GetEntries() : 0;
+}
+
+// _________________________________________________________
+void StPicoHFMaker::storeDaughters() {
+  // -- add copy of the daughter tracks of all candidates to the event, once per track
+  //    for kTwoAndTwoParticleDecay particle 2 of a secondary pair is the index of 
+  //    its tertiary vertex, the tracks of that tertiary pair are stored instead
+
+  StHFStageTimer timer(*mProfiler, kStageStoreDaughters);
+
+  unsigned int const nDaughtersMax = 3 * mPicoHFEvent->nHFSecondaryVertices() + 2 * mPicoHFEvent->nHFTertiaryVertices();
+  unsigned short* idxDaughters = mEventArena->allocate<unsigned short>(nDaughtersMax);
+  unsigned int    nDaughters   = 0;
+
+  TClonesArray const * aSecondary = mPicoHFEvent->aHFSecondaryVertices();
+  TClonesArray const * aTertiary  = mPicoHFEvent->aHFTertiaryVertices();
+
+  for (unsigned int idx = 0; idx < mPicoHFEvent->nHFSecondaryVertices(); ++idx) {
+    if (mDecayMode == StPicoHFEvent::kThreeParticleDecay) {
+      StHFTriplet const* triplet = static_cast<StHFTriplet const*>(aSecondary->At(idx));
+      idxDaughters[nDaughters++] = triplet->particle1Idx();
+      idxDaughters[nDaughters++] = triplet->particle2Idx();
+      idxDaughters[nDaughters++] = triplet->particle3Idx();
+    }
+    else if (mDecayMode == StPicoHFEvent::kTwoAndTwoParticleDecay) {
+      StHFPair const* pair = static_cast<StHFPair const*>(aSecondary->At(idx));
+      idxDaughters[nDaughters++] = pair->particle1Idx();
+
+      // -- never store the tertiary vertex index as track
+      if (pair->particle2Idx() < mPicoHFEvent->nHFTertiaryVertices()) {
+	StHFPair const* tertiary = static_cast<StHFPair const*>(aTertiary->At(pair->particle2Idx()));
+	idxDaughters[nDaughters++] = tertiary->particle1Idx();
+	idxDaughters[nDaughters++] = tertiary->particle2Idx();
+      }
+    }
+    else {
+      StHFPair const* pair = static_cast<StHFPair const*>(aSecondary->At(idx));
+      idxDaughters[nDaughters++] = pair->particle1Idx();
+      idxDaughters[nDaughters++] = pair->particle2Idx();
+    }
+  }
+
+  for (unsigned int idx = 0; idx < mPicoHFEvent->nHFTertiaryVertices(); ++idx) {
+    StHFPair const* pair = static_cast<StHFPair const*>(aTertiary->At(idx));
+    idxDaughters[nDaughters++] = pair->particle1Idx();
+    idxDaughters[nDaughters++] = pair->particle2Idx();
+  }
+
+  // -- sorted by index, as required by StPicoHFEvent::hfDaughter(...)
+  std::sort(idxDaughters, idxDaughters + nDaughters);
+  nDaughters = std::unique(idxDaughters, idxDaughters + nDaughters) - idxDaughters;
+
+  for (unsigned int ii = 0; ii < nDaughters; ++ii) {
+    if (idxDaughters[ii] >= mPicoDst->numberOfTracks())
+      continue;
+
+    StPicoTrack const* trk = picoTrack(idxDaughters[ii]);
+    if (trk)
+      mPicoHFEvent->addHFDaughter(*trk, idxDaughters[ii], getTofBeta(trk));
+  }
+}
+
+// _________________________________________________________
+void StPicoHFMaker::readHFEntry(Long64_t const entry) {
+  // -- read entry of HF tree, timed as stage of its own
+
+  StHFStageTimer timer(*mProfiler, kStageHFTreeRead);
+  mHFChain->GetEntry(entry);
+}
+
+// _________________________________________________________
+void StPicoHFMaker::countPairCuts(unsigned int const nCutsPassed) {
+  // -- count tried pairs and pairs passing the pair cuts in order of StHFCuts::cutPairOrder,
+  //    nCutsPassed is the index of the failed cut, as returned when the pair is built in stages
+
+  if (!mProfiler->isEnabled())
+    return;
+
+  mProfiler->count(kCountPairsTried);
+
+  for (unsigned int ii = 0; ii < nCutsPassed; ++ii)
+    mProfiler->count(kCountPairsPassDcaDaughters + mHFCuts->cutPairOrder(ii));
+}
+
+// _________________________________________________________
+void StPicoHFMaker::countPairCuts(StHFPair const & pair, int const pairType) {
+  // -- same for a fully built pair, its cuts are evaluated in order until the first failed one
+
+  if (!mProfiler->isEnabled())
+    return;
+
+  unsigned int nCutsPassed = 0;
+  while (nCutsPassed < StHFCuts::kPairCutMax && 
+	 mHFCuts->isGoodPairCut(mHFCuts->cutPairOrder(nCutsPassed), pairType, pair))
+    ++nCutsPassed;
+
+  countPairCuts(nCutsPassed);
+}
+
+// _________________________________________________________
+void StPicoHFMaker::writeProfile() {
+  // -- add summary histograms to output list and write JSON report
+
+  mOutList->Add(mProfiler->createTimeHistogram("hProfileTime"));
+  mOutList->Add(mProfiler->createCounterHistogram("hProfileCounters"));
+
+  TString const fileName = Form("%s.%s.profile.json", mOuputFileBaseName.Data(), GetName());
+  if (!mProfiler->writeJson(fileName.Data(), GetName()))
+    LOG_WARN << " StPicoHFMaker - Could not write profile " << fileName << endm;
+  else
+    LOG_INFO << " StPicoHFMaker - Profile written to " << fileName << endm;
+
+  // -- sum of the workers, stage times are CPU times summed over the threads
+  if (!mWorkerProfiler)
+    return;
+
+  mOutList->Add(mWorkerProfiler->createTimeHistogram("hProfileTimeWorkers"));
+  mOutList->Add(mWorkerProfiler->createCounterHistogram("hProfileCountersWorkers"));
+
+  TString const workerFileName = Form("%s.%s.workers.profile.json", mOuputFileBaseName.Data(), GetName());
+  if (!mWorkerProfiler->writeJson(workerFileName.Data(), Form("%s_workers", GetName())))
+    LOG_WARN << " StPicoHFMaker - Could not write profile " << workerFileName << endm;
+  else
+    LOG_INFO << " StPicoHFMaker - Profile of workers written to " << workerFileName << endm;
+}
+
+// _________________________________________________________
+void StPicoHFMaker::initCapture() {
+  // -- open capture file, only for kWrite/kAnalyse without workers
+
+  if (mMakerMode != StPicoHFMaker::kWrite && mMakerMode != StPicoHFMaker::kAnalyse) {
+    LOG_WARN << " StPicoHFMaker - Capture file only for kWrite and kAnalyse, no events are captured!" << endm;
+    return;
+  }
+
+  if (mNThreads > 1) {
+    LOG_WARN << " StPicoHFMaker - Capture file not available with setNThreads(...), no events are captured!" << endm;
+    return;
+  }
+
+  mCaptureWriter = new StHFCaptureWriter;
+  if (!mCaptureWriter->open(mCaptureFileName.Data())) {
+    LOG_ERROR << " StPicoHFMaker - Could not open capture file " << mCaptureFileName << ", no events are captured!" << endm;
+    delete mCaptureWriter;
+    mCaptureWriter = NULL;
+    return;
+  }
+
+  // -- cuts of the captured events, the replay uses them to reproduce this selection
+  TDirectory* const oldDirectory = gDirectory;
+  TFile cutsFile(Form("%s.cuts.root", mCaptureFileName.Data()), "RECREATE");
+  if (cutsFile.IsZombie() || mHFCuts->Write("hfCuts") <= 0)
+    LOG_WARN << " StPicoHFMaker - Could not write cuts to " << mCaptureFileName << ".cuts.root" << endm;
+  cutsFile.Close();
+  oldDirectory->cd();
+}
+
+// _________________________________________________________
+void StPicoHFMaker::captureEvent() {
+  // -- write event and its selected tracks to the capture file,
+  //    for every mCapturePrescale-th good event with enough selected tracks
+
+  if (mCaptureNEventsMax > 0 && mCaptureWriter->nEvents() >= mCaptureNEventsMax)
+    return;
+
+  if (mTrackTable->size() < mCaptureMinTracks)
+    return;
+
+  if ((mNCaptureCandidates++) % mCapturePrescale != 0)
+    return;
+
+  // -- particle lists of every row
+  unsigned short* particles = mEventArena->allocate<unsigned short>(mTrackTable->size(), 0);
+  for (unsigned int ii = 0; ii < mIdxPicoPions.size(); ++ii)
+    particles[mTrackTable->row(mIdxPicoPions[ii])] |= StHFCapturedTrack::kPion;
+  for (unsigned int ii = 0; ii < mIdxPicoKaons.size(); ++ii)
+    particles[mTrackTable->row(mIdxPicoKaons[ii])] |= StHFCapturedTrack::kKaon;
+  for (unsigned int ii = 0; ii < mIdxPicoProtons.size(); ++ii)
+    particles[mTrackTable->row(mIdxPicoProtons[ii])] |= StHFCapturedTrack::kProton;
+
+  StHFCapturedEvent event;
+  event.runId       = mPicoEvent->runId();
+  event.eventId     = mPicoEvent->eventId();
+  event.triggerWord = mPicoEvent->triggerWord();
+  event.nTracks     = 0;
+  event.vtxX        = mPrimVtx.x();
+  event.vtxY        = mPrimVtx.y();
+  event.vtxZ        = mPrimVtx.z();
+  event.vzVpd       = mPicoEvent->vzVpd();
+  event.bField      = mBField;
+
+  mCaptureWriter->beginEvent(event);
+  for (unsigned int row = 0; row < mTrackTable->size(); ++row)
+    mCaptureWriter->addTableRow(*mTrackTable, row, particles[row]);
+
+  if (!mCaptureWriter->endEvent())
+    LOG_WARN << " StPicoHFMaker - Could not write event " << event.eventId << " to capture file" << endm;
+}
+
+// _________________________________________________________
+void StPicoHFMaker::setupPairPartners(std::vector<unsigned short> const & idxList2, float const mass2) {
+  // -- prepare list of particles 2 for pairPartners, once per event
+  
+  setupPairPartners(*mMassFilter, *mGrid, mNPairPartners, idxList2, mass2);
+}
+
+// _________________________________________________________
+void StPicoHFMaker::pairPartners(unsigned short const idx1, float const mass1, int const pairType,
+				 std::vector<unsigned short> & positions) {
+  // -- provide positions in list of particles 2 (see setupPairPartners) 
+  //    to be paired with particle 1, in increasing order
+  //    pairType : use enum StHFCuts::ePairType to select the pair cuts
+
+  pairPartners(*mMassFilter, *mGrid, mNPairPartners, idx1, mass1, pairType, positions);
+}
+
+// _________________________________________________________
+void StPicoHFMaker::setupPairPartners(StHFMassWindowFilter & massFilter, StHFDirectionGrid & grid, unsigned int & nPairPartners,
+				      std::vector<unsigned short> const & idxList2, float const mass2) const {
+  // -- prepare list of particles 2 in the given pre-filters
+  
+  nPairPartners = idxList2.size();
+
+  if (mMassFilterMode != StHFMassWindowFilter::kNoMassFilter)
+    massFilter.setup(*mTrackTable, idxList2, mass2);
+
+  if (mDirectionGridMode != StHFDirectionGrid::kNoGrid)
+    grid.setup(*mTrackTable, idxList2);
+}
+
+// _________________________________________________________
+void StPicoHFMaker::pairPartners(StHFMassWindowFilter const & massFilter, StHFDirectionGrid const & grid, 
+				 unsigned int const nPairPartners, unsigned short const idx1, float const mass1, 
+				 int const pairType, std::vector<unsigned short> & positions) {
+  // -- positions of partners from the given pre-filters
+
+  bool const bSecondary = (pairType == StHFCuts::kSecondaryPair);
+  int  const row1       = mTrackTable->row(idx1);
+
+  // -- mass window
+  if (mMassFilterMode == StHFMassWindowFilter::kNoMassFilter) {
+    positions.resize(nPairPartners);
+    for (unsigned short ii = 0; ii < nPairPartners; ++ii)
+      positions[ii] = ii;
+  }
+  else {
+    float const massMin = bSecondary ? mHFCuts->cutSecondaryPairMassMin() : mHFCuts->cutTertiaryPairMassMin();
+    float const massMax = bSecondary ? mHFCuts->cutSecondaryPairMassMax() : mHFCuts->cutTertiaryPairMassMax();
+
+    massFilter.partners(*mTrackTable, row1, mass1, massMin, massMax, positions);
+
+    if (mMassFilterMode == StHFMassWindowFilter::kMassFilterVerify) {
+      unsigned int const nMissed = massFilter.verify(*mTrackTable, row1, mass1, massMin, massMax, positions);
+      if (nMissed) 
+	LOG_ERROR << " StPicoHFMaker::pairPartners - mass window pre-filter missed " << nMissed 
+		  << " pairs for track " << idx1 << endm;
+    }
+  }
+
+  // -- directions
+  //    the bound of the grid holds for straight lines, not for the helix vertexing modes
+  if (mDirectionGridMode != StHFDirectionGrid::kNoGrid && mHFCuts->vertexingMode() == StHFCuts::kStraightLine) {
+    float const dcaDaughtersMax = bSecondary ? mHFCuts->cutSecondaryPairDcaDaughtersMax() : mHFCuts->cutTertiaryPairDcaDaughtersMax();
+    float const decayLengthMin  = bSecondary ? mHFCuts->cutSecondaryPairDecayLengthMin()  : mHFCuts->cutTertiaryPairDecayLengthMin();
+
+    grid.partners(*mTrackTable, row1, dcaDaughtersMax, decayLengthMin, mGridPartners);
+
+    if (mDirectionGridMode == StHFDirectionGrid::kGridVerify) {
+      unsigned int const nMissed = grid.verify(*mTrackTable, row1, dcaDaughtersMax, decayLengthMin, mGridPartners);
+      if (nMissed) 
+	LOG_ERROR << " StPicoHFMaker::pairPartners - direction grid missed " << nMissed 
+		  << " pairs for track " << idx1 << endm;
+    }
+
+    // -- output range of set_intersection must not overlap its inputs
+    mPartnersIntersection.clear();
+    std::set_intersection(positions.begin(), positions.end(), mGridPartners.begin(), mGridPartners.end(),
+			  std::back_inserter(mPartnersIntersection));
+    positions.swap(mPartnersIntersection);
+  }
+}
+
 // _________________________________________________________
 void StPicoHFMaker::initializeEventStats() {
   // -- Initialize event statistics histograms
@@ -331,3 +1138,300 @@ void StPicoHFMaker::fillEventStats(int *aEventStat) {
     hEventStat1->Fill(idx);
   }
 }
+
+// _________________________________________________________
+bool StPicoHFMaker::startWorkers() {
+  // -- create one worker per thread and start the threads
+  //    called in Init(), after InitHF()
+
+  if (mMakerMode != StPicoHFMaker::kAnalyse) {
+    LOG_WARN << " StPicoHFMaker - Multiple threads only supported in kAnalyse mode!" << endm;
+    return false;
+  }
+
+  for (unsigned int ii = 0; ii < mNThreads; ++ii) {
+    StPicoHFMaker* worker = createWorker(Form("%s_worker%u", GetName(), ii));
+    if (!worker) {
+      LOG_WARN << " StPicoHFMaker - createWorker(...) not implemented by " << ClassName() << endm;
+      stopWorkers();
+      return false;
+    }
+
+    // -- workers are driven by this maker, not by the chain
+    worker->Shunt();
+
+    mWorkers.push_back(worker);
+  }
+
+  mEventQueue = new StHFWorkQueue;
+  mFreeQueue  = new StHFWorkQueue;
+
+  // -- two events per worker : one processed, one waiting in the queue
+  mNSnapshots = 2 * mNThreads;
+  for (unsigned int ii = 0; ii < mNSnapshots; ++ii)
+    mFreeQueue->push(new StHFEventSnapshot);
+
+  std::vector<void*> args;
+  for (unsigned int ii = 0; ii < mWorkers.size(); ++ii) {
+    mWorkers[ii]->initWorker(*this);
+    args.push_back(mWorkers[ii]);
+  }
+
+  // -- workers create TObjects (candidates, histograms) : switch ROOT to thread-safe mode
+  TThread::Initialize();
+
+  mThreadPool = new StHFThreadPool;
+  if (mThreadPool->start(&StPicoHFMaker::runWorker, args) != args.size()) {
+    stopWorkers();
+    return false;
+  }
+
+  LOG_INFO << " StPicoHFMaker - Started " << mWorkers.size() << " workers" << endm;
+
+  return true;
+}
+
+// _________________________________________________________
+void StPicoHFMaker::stopWorkers() {
+  // -- let workers finish all queued events, merge their histograms 
+  //    and delete them
+
+  if (mThreadPool) {
+    for (unsigned int ii = 0; ii < mThreadPool->size(); ++ii)
+      mEventQueue->push(NULL);
+    mThreadPool->join();
+
+    delete mThreadPool;
+    mThreadPool = NULL;
+
+    // -- stage times of workers are CPU times summed over the threads,
+    //    they are kept apart from the wall times of the maker
+    delete mWorkerProfiler;
+    mWorkerProfiler = new StHFStageProfiler;
+
+    unsigned int nEventsFailed = 0;
+    for (unsigned int ii = 0; ii < mWorkers.size(); ++ii) {
+      mergeOutList(mOutList, mWorkers[ii]->mOutList);
+      mWorkerProfiler->add(*mWorkers[ii]->mProfiler);
+      nEventsFailed += mWorkers[ii]->mNEventsFailed;
+    }
+
+    if (nEventsFailed)
+      LOG_WARN << " StPicoHFMaker - MakeHF() of workers failed for " << nEventsFailed << " events, they were skipped" << endm;
+  }
+
+  for (unsigned int ii = 0; ii < mWorkers.size(); ++ii)
+    delete mWorkers[ii];
+  mWorkers.clear();
+
+  if (mFreeQueue) {
+    for (unsigned int ii = 0; ii < mNSnapshots; ++ii)
+      delete static_cast<StHFEventSnapshot*>(mFreeQueue->pop());
+  }
+  mNSnapshots = 0;
+
+  delete mEventQueue;
+  mEventQueue = NULL;
+
+  delete mFreeQueue;
+  mFreeQueue = NULL;
+}
+
+// _________________________________________________________
+void StPicoHFMaker::initWorker(StPicoHFMaker const & master) {
+  // -- take over settings of master and initialize worker
+  //    replaces Init() for workers, no files are opened
+
+  mIsWorker          = true;
+  mHFCuts            = master.mHFCuts;
+  mHFCutsVariants    = master.mHFCutsVariants;
+  mDecayMode         = master.mDecayMode;
+  mMakerMode         = master.mMakerMode;
+  mMassFilterMode    = master.mMassFilterMode;
+  mDirectionGridMode = master.mDirectionGridMode;
+  mTrackSelectionMode = master.mTrackSelectionMode;
+  mProfiling         = master.mProfiling;
+
+  mEventQueue        = master.mEventQueue;
+  mFreeQueue         = master.mFreeQueue;
+
+  mPicoHFEvent = new StPicoHFEvent(mDecayMode);
+
+  mOutList = new TList();
+  mOutList->SetName(GetName());
+  mOutList->SetOwner(true);
+
+  createVariantOutLists();
+
+  mProfiler->setEnabled(mProfiling);
+
+  // -- call method of daughter class
+  InitHF();
+
+  initTrackSelection();
+
+  resetEvent();
+}
+
+// _________________________________________________________
+void StPicoHFMaker::queueEvent() {
+  // -- copy current event and put it in the queue of the workers
+  //    waits if all event copies are in use
+
+  StHFEventSnapshot* snapshot = static_cast<StHFEventSnapshot*>(mFreeQueue->pop());
+
+  UInt_t nTracks = mPicoDst->numberOfTracks();
+  snapshot->reset(*mPicoEvent, nTracks);
+
+  for (unsigned short iTrack = 0; iTrack < nTracks; ++iTrack) {
+    StPicoTrack const* trk = mPicoDst->track(iTrack);
+    snapshot->addTrack(trk, trk ? getTofBeta(trk) : 0.);
+  }
+
+  mEventQueue->push(snapshot);
+}
+
+// _________________________________________________________
+Int_t StPicoHFMaker::makeWorkerEvent(StHFEventSnapshot & snapshot) {
+  // -- process one event in worker, event cuts have been applied by the master
+  //    returns the return value of MakeHF()
+
+  mSnapshot  = &snapshot;
+  mPicoEvent = snapshot.event();
+  mPicoHFEvent->addPicoEvent(*mPicoEvent);
+  
+  mBField  = mPicoEvent->bField();
+  mPrimVtx = mPicoEvent->primaryVertex();
+
+  prepareTracks();
+
+  // -- call methods of daughter class
+  mProfiler->start(kStageMakeHF);
+  Int_t const iReturn = MakeHF();
+  mProfiler->stop(kStageMakeHF);
+
+  // -- failed events are skipped
+  if (iReturn == kStOK)
+    mProfiler->count(kCountCandidates, mPicoHFEvent->nHFSecondaryVertices() + mPicoHFEvent->nHFTertiaryVertices());
+  else
+    ++mNEventsFailed;
+
+  ClearHF();
+
+  resetEvent();
+
+  mPicoEvent = NULL;
+  mSnapshot  = NULL;
+
+  return iReturn;
+}
+
+// _________________________________________________________
+void StPicoHFMaker::processEvents() {
+  // -- worker loop : process events until end marker (NULL) is received
+
+  while (void* item = mEventQueue->pop()) {
+    StHFEventSnapshot* snapshot = static_cast<StHFEventSnapshot*>(item);
+    makeWorkerEvent(*snapshot);
+    mFreeQueue->push(snapshot);
+  }
+}
+
+// _________________________________________________________
+void* StPicoHFMaker::runWorker(void* worker) {
+  // -- thread function
+
+  static_cast<StPicoHFMaker*>(worker)->processEvents();
+  return NULL;
+}
+
+// _________________________________________________________
+void StPicoHFMaker::mergeOutList(TList* outList, TList const * list) {
+  // -- add histograms of list to the ones with the same name in outList,
+  //    lists (e.g. of cut variants) are merged recursively
+
+  if (!list)
+    return;
+
+  TIter next(outList);
+  while (TObject* obj = next()) {
+    TObject* other = list->FindObject(obj->GetName());
+    if (!other)
+      continue;
+
+    TList* subList = dynamic_cast<TList*>(obj);
+    TList* otherSubList = dynamic_cast<TList*>(other);
+    if (subList && otherSubList) {
+      mergeOutList(subList, otherSubList);
+      continue;
+    }
+
+    TH1* hist = dynamic_cast<TH1*>(obj);
+    TH1* otherHist = dynamic_cast<TH1*>(other);
+    if (hist && otherHist)
+      hist->Add(otherHist);
+    else
+      LOG_WARN << " StPicoHFMaker - Cannot merge " << obj->GetName() << " of workers, only histograms are merged!" << endm;
+  }
+}
+
+// _________________________________________________________
+void StPicoHFMaker::addHFCutsVariant(StHFCuts* cuts) {
+  // -- add cut variant, owned by the maker
+
+  if (mHFCutsVariants.size() >= StPicoHFMaker::kHFCutsVariantsMax) {
+    LOG_WARN << " StPicoHFMaker - More than " << StPicoHFMaker::kHFCutsVariantsMax << " cut variants, ignore " 
+	     << cuts->GetName() << endm;
+    delete cuts;
+    return;
+  }
+
+  mHFCutsVariants.push_back(cuts);
+}
+
+// _________________________________________________________
+void StPicoHFMaker::createVariantOutLists() {
+  // -- one histogram list per cut variant, added to mOutList
+
+  mVariantOutLists.clear();
+
+  for (unsigned int ii = 0; ii < mHFCutsVariants.size(); ++ii) {
+    TList* list = new TList();
+    list->SetName(Form("variant%u_%s", ii, mHFCutsVariants[ii]->GetName()));
+    list->SetOwner(true);
+
+    mOutList->Add(list);
+    mVariantOutLists.push_back(list);
+  }
+}
+
+// _________________________________________________________
+ULong64_t StPicoHFMaker::pairCutsVariants(StHFPair const & pair, int const pairType) const {
+  // -- bitmask of cut variants, whose pair cuts are passed by pair
+  //    use StHFCuts::ePairType for pairType
+
+  ULong64_t mask = 0;
+  
+  for (unsigned int ii = 0; ii < mHFCutsVariants.size(); ++ii) {
+    bool const bGood = (pairType == StHFCuts::kTertiaryPair) ? 
+      mHFCutsVariants[ii]->isGoodTertiaryVertexPair(pair) : mHFCutsVariants[ii]->isGoodSecondaryVertexPair(pair);
+    if (bGood)
+      mask |= (static_cast<ULong64_t>(1) << ii);
+  }
+
+  return mask;
+}
+
+// _________________________________________________________
+ULong64_t StPicoHFMaker::tripletCutsVariants(StHFTriplet const & triplet) const {
+  // -- bitmask of cut variants, whose triplet cuts are passed by triplet
+
+  ULong64_t mask = 0;
+  
+  for (unsigned int ii = 0; ii < mHFCutsVariants.size(); ++ii) {
+    if (mHFCutsVariants[ii]->isGoodSecondaryVertexTriplet(triplet))
+      mask |= (static_cast<ULong64_t>(1) << ii);
+  }
+
+  return mask;
+}
@@ -27,6 +27,18 @@
  *      StPicoHFMaker::kAnalyse - don't write candidate trees, just fill histograms
  *      StPicoHFMaker::kWrite   - write candidate trees
  *      StPicoHFMaker::kRead    - read candidate trees and fill histograms
+ *      StPicoHFMaker::kReplay  - read candidate trees only, without picoDst
+ *
+ *  - In kWrite compact copies of the daughter tracks of all stored candidates 
+ *    (StHFDaughter) can be added to the HF tree via setStoreDaughters(true)
+ *    (kObjectTree only).
+ *    Such trees can be analysed in kReplay, which reads only the HF tree:
+ *    mPicoDst is NULL, use hfDaughter(...) instead of picoTrack(...) and the 
+ *    StHFDaughter methods of StHFCuts. For kTwoAndTwoParticleDecay, particle 2
+ *    of a secondary pair is a tertiary vertex index : the tracks of that tertiary
+ *    pair are stored, not a track with this index. The event cuts are not applied again,
+ *    only events passing them have candidates. Use getHFEntries() for the
+ *    number of events to process, Make() returns kStEOF after the last entry.
  *
  *  - Implement in daughter class, methods from StHFCuts utility class can/should be used
  *     methods are used to fill vectors for 'good' identified particles
@@ -34,6 +46,158 @@
  *     isKaon
  *     isProton
  *
+ *  - Alternatively the tracks can be selected in a batch via 
+ *    setTrackSelectionMode(StPicoHFMaker::kBatchSelection) (see StHFTrackSelection)
+ *     - implement setupTrackSelection(...) in the daughter class, which sets
+ *       the requirements of pions, kaons and protons as combinations of 
+ *       cut bits, instead of isPion, isKaon and isProton
+ *     - the track and PID cuts of StHFCuts are evaluated for all tracks of
+ *       the event at once, the per-track virtual calls are avoided
+ *     - additional predicates can be implemented in evaluateTracks(...),
+ *       setting the user bits StHFTrackSelection::kUserBit, ... 
+ *     - if setupTrackSelection(...) is not implemented, isPion, isKaon and 
+ *       isProton are used
+ *
+ *  - Tracks which are selected by isPion, isKaon or isProton are added
+ *    to the event-wise track cache, which holds their helices moved to the
+ *    primary vertex. Use cachedTrack(...) to get them and build pairs/triplets 
+ *    from them, instead of passing the StPicoTrack
+ *
+ *  - The same tracks are also stored as rows of the structure-of-arrays
+ *    table mTrackTable (StHFTrackTable). Use mTrackTable->row(idx) and the
+ *    StHFPair(StHFTrackTable const &, ...) constructor in the hot pair loops
+ *
+ *  - Pair loops can be restricted to partners which can reach the pair
+ *    mass window, via setupPairPartners(...) and pairPartners(...)
+ *    Set mode via setMassFilterMode(...) in run macro
+ *     use enum of StHFMassWindowFilter::eMassFilterMode
+ *      StHFMassWindowFilter::kNoMassFilter      - all partners (default)
+ *      StHFMassWindowFilter::kMassFilter        - only partners within mass reach
+ *      StHFMassWindowFilter::kMassFilterVerify  - as kMassFilter, but check for 
+ *                                                 every particle that no pair is lost
+ *    In addition partners can be restricted to directions which can pass the
+ *    dcaDaughters and decayLength cuts, via setDirectionGridMode(...)
+ *     use enum of StHFDirectionGrid::eGridMode (kNoGrid, kGrid, kGridVerify)
+ *     (effective only for decayLengthMin > dcaDaughtersMax/2 + DCA of the tracks)
+ *     (used only with the straight line vertexing of StHFCuts, see below)
+ *
+ *  - Pairs built from the track table rows place the decay vertex according to
+ *    StHFCuts::setVertexingMode(mode, nIterations) in the run macro
+ *      StHFCuts::kStraightLine - straight lines at the DCA to the primary vertex (default)
+ *      StHFCuts::kHelixRefine  - nIterations Newton steps on the helices
+ *      StHFCuts::kHelixFull    - Newton steps on the helices until converged
+ *    the helix modes are more precise for low pT daughters and slower,
+ *    pairs from the track cache and triplets stay in straight line approximation
+ *    The straight lines are calculated in double precision or float only, via
+ *    StHFCuts::setKinematicsPrecision(StHFPairKernel::kSinglePrecision)
+ *
+ *  - Tertiary V0s (kTwoAndTwoParticleDecay) can be built via 
+ *    createTertiaryV0s(idxList1, mass1, idxList2, mass2), e.g. for Lambda -> p pi
+ *    (createTertiaryK0Shorts() for K0S -> pi+ pi-). The lists are split by charge 
+ *    first, only pairs of opposite charge are tried, built from the track table 
+ *    rows with the tertiary pair cuts (mass, dcaDaughters, ...) applied as early 
+ *    as possible. Pairs passing isGoodTertiaryVertexPair are stored in mPicoHFEvent.
+ *    Set sameList to true if both are the same list of particles (e.g. pions
+ *    for K0S), then only idxList1 is used and every pair is tried once.
+ *    The tertiary V0s have their own mass window pre-filter and direction grid,
+ *    setupPairPartners(...) of the secondary pair loop stays valid
+ *
+ *  - Secondary pairs of a particle and a tertiary V0 (kTwoAndTwoParticleDecay, 
+ *    e.g. D+ -> K0S pi, Lambda_c -> K0S p) can be built via 
+ *    createSecondaryCascades(idxList1, mass1, massV0), after the V0s have been
+ *    created. The state of each V0 (StHFCascadeV0) is set up once and reused for 
+ *    all particles, the V0 helix is not recreated per pair. Use StHFCascadeV0 
+ *    for the tertiary quantities with respect to the secondary vertex, 
+ *    instead of StHFPair::pointingAngle(vtx2), ... and StPicoTrack::dcaGeometry()
+ *
+ *  - Triplets (kThreeParticleDecay) can be built via createSecondaryTriplets(...)
+ *    out of three lists of particles (see StHFTripletBuilder), instead of a 
+ *    triple loop. 1-2 pairs are pruned with the dcaDaughters12 cut before the 
+ *    third particle is added, the 2-3 and 3-1 DCAs are calculated once per pair 
+ *    of tracks, the full StHFTriplet only for combinations passing all three 
+ *    dcaDaughters cuts. Triplets passing isGoodSecondaryVertexTriplet are stored
+ *    in mPicoHFEvent. Set sameList23 to true if list 2 and list 3 are the same
+ *    list of particles (e.g. pions for D+ -> K pi pi)
+ *
+ *  - Events can be processed by several threads via setNThreads(...) (kAnalyse only)
+ *     - the daughter class has to implement createWorker(...), returning a new 
+ *       instance with the same settings as the daughter class itself
+ *     - ROOT is switched to thread-safe mode (TThread::Initialize()) before
+ *       the workers are started
+ *     - one worker is created per thread, each with its own StPicoHFEvent, 
+ *       vectors of particles, track cache and histograms (via InitHF())
+ *     - Make() checks the event and puts a copy of it in a queue, 
+ *       the workers take events from the queue and run MakeHF() and ClearHF().
+ *       Events for which MakeHF() does not return kStOK are skipped (no candidates
+ *       are counted) and reported at Finish()
+ *     - at Finish() the histograms in mOutList of all workers are added 
+ *       to the ones of the maker, before FinishHF() is called
+ *     - in MakeHF() of workers mPicoDst is NULL, use picoTrack(...) instead of
+ *       mPicoDst->track(...). Only the worker itself and the const methods 
+ *       of StHFCuts must be used, no files or gDirectory (ROOT I/O is not thread safe)
+ *
+ *  - Several cut variants can be evaluated in one pass via addHFCutsVariant(...)
+ *     - the base cuts (setHFBaseCuts) are opened up to the loosest envelope of
+ *       all variants, particles and candidates are built once with them
+ *     - pairCutsVariants(...) / tripletCutsVariants(...) return for a candidate
+ *       the bitmask of variants whose candidate cuts it passes (bit idx = variant idx)
+ *     - for every variant a list variantOutList(idx) is added to mOutList, 
+ *       create the histograms of each variant there in InitHF()
+ *     - track and PID cuts of a variant can be checked via hfCutsVariant(idx)
+ *
+ *  - Per-event scratch arrays (indices, flags, ...) should be taken from
+ *    mEventArena->allocate<T>(n) instead of local std::vectors. They are valid 
+ *    during MakeHF(), the arena is reset at the end of every event. 
+ *    It grows to the largest event, then no heap allocations are done
+ *
+ *  - Timers and counters per stage can be switched on via setProfiling(true)
+ *    (see StHFStageProfiler, compiled out with -DST_HF_NO_PROFILING)
+ *     - stages (eProfileStage) : outside (time between two Make() calls, 
+ *       i.e. picoDst I/O and other makers), HF tree reading, event setup,
+ *       track selection, MakeHF(), storing daughters, tree filling
+ *     - counters (eProfileCounter) : events, good events, tracks, pions, kaons, 
+ *       protons, candidates, bytes written, pairs tried and passed per pair cut,
+ *       1-2 pairs tried and passed in createSecondaryTriplets(...) and the 
+ *       triplets calculated there
+ *     - pair counters are filled by countPairCuts(nCutsPassed), call it in the
+ *       pair loop with the number of passed cuts returned by 
+ *       StHFCuts::isGoodSecondaryVertexPair(table, ..., pair, &nCutsPassed),
+ *       kCountPairsPassXXX counts the pairs passing all cuts up to XXX (in the order
+ *       of StHFCuts::setCutPairOrder). For fully built pairs use countPairCuts(pair, pairType)
+ *     - daughter classes can add their own stages/counters via profiler()->addStage(...)
+ *       in InitHF() and time them with StHFStageTimer
+ *     - at Finish() the histograms hProfileTime and hProfileCounters are added to 
+ *       mOutList and the report <mOuputFileBaseName>.<GetName()>.profile.json is written
+ *     - workers have their own profilers. At Finish() they are summed into a separate
+ *       profiler, written as hProfileTimeWorkers and hProfileCountersWorkers and as
+ *       <mOuputFileBaseName>.<GetName()>.workers.profile.json. Its stage times are
+ *       summed over the threads (CPU time), the ones of the maker are wall time
+ *
+ *  - A sample of events can be captured to a compact binary file via
+ *    setCaptureFile(fileName, prescale, minTracks, nEventsMax) (kWrite, kAnalyse,
+ *    without workers), see StHFCaptureFile. Captured are every prescale-th good 
+ *    event with at least minTracks selected tracks, up to nEventsMax (0 : all) :
+ *    primary vertex, bField, trigger word, vzVpd and the track table rows of the
+ *    selected tracks. The cuts (mHFCuts) are written as "hfCuts" to 
+ *    <fileName>.cuts.root. hfKinematicsBenchmark/hfReplayBenchmark replays the
+ *    events through the candidate builders with these cuts, without picoDst
+ *
+ *  - Set format of the HF tree (kWrite, kRead) via setTreeFormat(...)
+ *     use enum of StPicoHFMaker::eTreeFormat
+ *      StPicoHFMaker::kObjectTree - StPicoHFEvent object branch "hfEvent" (default)
+ *      StPicoHFMaker::kFlatTree   - flat array branches per candidate quantity (see StHFCandidateTree)
+ *                                   not for kThreeParticleDecay
+ *    In kRead with kFlatTree only the columns set via setFlatTreeColumns(...) are read, 
+ *    (e.g. "m:pt:decayLength", empty for all), mPicoHFEvent stays empty. 
+ *    Use candidateTree() in MakeHF() to get them
+ *
+ *  - Set how kRead finds the HF tree entry of a picoDst event via setReadMode(...)
+ *     use enum of StPicoHFMaker::eReadMode
+ *      StPicoHFMaker::kSequentialRead - next entry, picoDst and HF tree have to be in sync (default)
+ *      StPicoHFMaker::kIndexedRead    - entry with same runId and eventId (StHFEventIndex),
+ *                                       picoDst events without entry are skipped
+ *    The index can be saved and reused via setHFTreeIndexFileName(...)
+ *
  * **************************************************
  *  Authors:  Xin Dong        (xdong@lbl.gov)
  *            Mustafa Mustafa (mmustafa@lbl.gov)
@@ -54,7 +218,23 @@ class StPicoTrack;
 class StPicoHFEvent;
 class StHFPair;
 class StHFTriplet;
+class StHFTripletBuilder;
 class StHFCuts;
+class StHFTrackCache;
+class StHFCachedTrack;
+class StHFTrackTable;
+class StHFDaughter;
+class StHFMassWindowFilter;
+class StHFDirectionGrid;
+class StHFEventSnapshot;
+class StHFWorkQueue;
+class StHFThreadPool;
+class StHFCandidateTree;
+class StHFEventIndex;
+class StHFTrackSelection;
+class StHFEventArena;
+class StHFStageProfiler;
+class StHFCaptureWriter;
 
 class StPicoHFMaker : public StMaker 
 {
@@ -70,14 +250,57 @@ class StPicoHFMaker : public StMaker
     virtual Int_t FinishHF()                { return kStOK; }
 
     void setHFBaseCuts(StHFCuts* cuts);
+    void addHFCutsVariant(StHFCuts* cuts);
     void setMakerMode(unsigned short us);
     void setDecayMode(unsigned short us);
+    void setMassFilterMode(unsigned short us);
+    void setDirectionGridMode(unsigned short us);
+    void setNThreads(unsigned int n);
+    void setTreeFormat(unsigned short us);
+    void setFlatTreeColumns(char const* columns);
+    void setReadMode(unsigned short us);
+    void setHFTreeIndexFileName(char const* fileName);
+    void setStoreDaughters(bool b);
+    void setTrackSelectionMode(unsigned short us);
+    void setProfiling(bool b);
+    void setCaptureFile(char const* fileName, unsigned int prescale = 1, 
+			unsigned int minTracks = 0, unsigned int nEventsMax = 0);
+
+    int  getHFEntries() const;
 
     // -- different modes to use the StPicoHFMaker class
     //    - kAnalyse - don't write candidate trees, just fill histograms
     //    - kWrite   - write candidate trees
     //    - kRead    - read candidate trees and fill histograms
-    enum eMakerMode {kAnalyse, kWrite, kRead};
+    //    - kReplay  - read candidate trees without picoDst and fill histograms
+    enum eMakerMode {kAnalyse, kWrite, kRead, kReplay};
+
+    // -- different formats of the HF tree
+    //    - kObjectTree - StPicoHFEvent object branch
+    //    - kFlatTree   - flat array branches, via StHFCandidateTree
+    enum eTreeFormat {kObjectTree, kFlatTree};
+
+    // -- maximum number of cut variants (bits of the mask)
+    enum {kHFCutsVariantsMax = 64};
+
+    // -- different ways to find the HF tree entry in kRead
+    //    - kSequentialRead - next entry
+    //    - kIndexedRead    - entry with runId and eventId of the picoDst event
+    enum eReadMode {kSequentialRead, kIndexedRead};
+
+    // -- different ways to select pions, kaons and protons
+    //    - kPerTrackSelection - isPion, isKaon, isProton per track
+    //    - kBatchSelection    - all tracks at once, via StHFTrackSelection
+    enum eTrackSelectionMode {kPerTrackSelection, kBatchSelection};
+
+    // -- stages and counters of the profiler, see setProfiling(...)
+    enum eProfileStage {kStageOutside, kStageHFTreeRead, kStageEventSetup, kStageTrackSelection, 
+			kStageMakeHF, kStageStoreDaughters, kStageTreeFill, kStageMax};
+    enum eProfileCounter {kCountEvents, kCountGoodEvents, kCountTracks, kCountPions, kCountKaons, kCountProtons, 
+			  kCountCandidates, kCountBytesWritten, kCountPairsTried, 
+			  kCountPairsPassDcaDaughters, kCountPairsPassMass,         // same order as StHFCuts::ePairCut
+			  kCountPairsPassDecayLength, kCountPairsPassPointingAngle, 
+			  kCountTripletPairsTried, kCountTripletPairsPassDcaDaughters12, kCountTripletsTried, kCountMax};
 
     // -- TO BE IMPLEMENTED BY DAUGHTER CLASS
     virtual bool  isPion(StPicoTrack const*, float const & bTofBeta) const   { return true; }
@@ -85,14 +308,49 @@ class StPicoHFMaker : public StMaker
     virtual bool  isProton(StPicoTrack const*, float const & bTofBeta) const { return true; }
 
   protected:
+    // -- TO BE IMPLEMENTED BY DAUGHTER CLASS for setNThreads(...)
+    //    return new instance with same settings, not attached to a chain or files
+    virtual StPicoHFMaker* createWorker(char const* name) const { return NULL; }
+
+    // -- TO BE IMPLEMENTED BY DAUGHTER CLASS for kBatchSelection
+    //    set requirements via selection.addRequirement(...), return false if not implemented
+    virtual bool  setupTrackSelection(StHFTrackSelection & selection) const { return false; }
+    //    optional : set user bits in selection.masks(), called after the StHFCuts bits are set
+    virtual void  evaluateTracks(StHFTrackSelection & selection) const { return; }
 
     void  createTertiaryK0Shorts();
+    void  createTertiaryV0s(std::vector<unsigned short> const & idxList1, float mass1,
+			    std::vector<unsigned short> const & idxList2, float mass2, bool sameList);
+    void  createSecondaryCascades(std::vector<unsigned short> const & idxList1, float mass1, float massV0);
+    void  createSecondaryTriplets(std::vector<unsigned short> const & idxList1, std::vector<unsigned short> const & idxList2,
+				  std::vector<unsigned short> const & idxList3, float mass1, float mass2, float mass3,
+				  bool sameList23);
 
     unsigned int isDecayMode();
     unsigned int isMakerMode();
 
     float getTofBeta(StPicoTrack const*) const;
 
+    StHFCachedTrack const * cachedTrack(unsigned short idx) const;
+    StPicoTrack     const * picoTrack(unsigned short idx) const;
+    StHFDaughter    const * hfDaughter(unsigned short idx) const;
+
+    StHFCandidateTree const * candidateTree() const;
+
+    StHFStageProfiler * profiler() const;
+    void  countPairCuts(unsigned int nCutsPassed);
+    void  countPairCuts(StHFPair const & pair, int pairType);
+
+    unsigned int     nHFCutsVariants() const;
+    StHFCuts const * hfCutsVariant(unsigned int idx) const;
+    TList*           variantOutList(unsigned int idx) const;
+    ULong64_t        pairCutsVariants(StHFPair const & pair, int pairType) const;
+    ULong64_t        tripletCutsVariants(StHFTriplet const & triplet) const;
+
+    void  setupPairPartners(std::vector<unsigned short> const & idxList2, float mass2);
+    void  pairPartners(unsigned short idx1, float mass1, int pairType,
+		       std::vector<unsigned short> & positions);
+
     // -- protected members ------------------------
 
     StPicoDst      *mPicoDst;
@@ -110,6 +368,14 @@ class StPicoHFMaker : public StMaker
     std::vector<unsigned short> mIdxPicoKaons;
     std::vector<unsigned short> mIdxPicoProtons;
 
+    StHFTrackCache *mTrackCache; // cache of tracks in mIdxPicoPions/Kaons/Protons
+    StHFTrackTable *mTrackTable; // same tracks as structure-of-arrays table
+
+    StHFMassWindowFilter *mMassFilter; // mass window pre-filter for pairPartners
+    StHFDirectionGrid    *mGrid;       // direction grid pre-filter for pairPartners
+
+    StHFEventArena *mEventArena; // per-event scratch memory, released in resetEvent()
+
   private:
     // -- Inhertited from StMaker 
     //    NOT TO BE OVERWRITTEN by daughter class
@@ -119,8 +385,39 @@ class StPicoHFMaker : public StMaker
     void  Clear(Option_t *opt="");
     Int_t Finish();
     
+    Int_t makeEvent();
+    void  readHFEntry(Long64_t entry);
+    void  writeProfile();
+    void  initCapture();
+    void  captureEvent();
     void  resetEvent();
     bool  setupEvent();
+    void  prepareTracks();
+    void  selectTracks();
+    void  selectTracksPerTrack(UInt_t nTracks);
+    void  initTrackSelection();
+    void  storeDaughters();
+
+    void  splitByCharge(std::vector<unsigned short> const & idxList,
+			std::vector<unsigned short> & idxPositive, std::vector<unsigned short> & idxNegative) const;
+    void  addTertiaryV0s(std::vector<unsigned short> const & idxList1, float mass1,
+			 std::vector<unsigned short> const & idxList2, float mass2, StHFPair* & candidate);
+
+    void  setupPairPartners(StHFMassWindowFilter & massFilter, StHFDirectionGrid & grid, unsigned int & nPairPartners,
+			    std::vector<unsigned short> const & idxList2, float mass2) const;
+    void  pairPartners(StHFMassWindowFilter const & massFilter, StHFDirectionGrid const & grid, unsigned int nPairPartners,
+		       unsigned short idx1, float mass1, int pairType, std::vector<unsigned short> & positions);
+
+    bool  startWorkers();
+    void  stopWorkers();
+    void  initWorker(StPicoHFMaker const & master);
+    void  queueEvent();
+    Int_t makeWorkerEvent(StHFEventSnapshot & snapshot);
+    void  processEvents();
+    void  mergeOutList(TList* outList, TList const * list);
+    void  createVariantOutLists();
+
+    static void* runWorker(void* worker);
     
     void  initializeEventStats();
     void  fillEventStats(int *aEventStat);
@@ -129,6 +426,33 @@ class StPicoHFMaker : public StMaker
 
     unsigned int    mDecayMode; // use enum of StPicoHFEvent::eHFEventMode
     unsigned int    mMakerMode; // use enum of StPicoEventMaker::eMakerMode
+    unsigned int    mMassFilterMode;  // use enum of StHFMassWindowFilter::eMassFilterMode
+    unsigned int    mDirectionGridMode; // use enum of StHFDirectionGrid::eGridMode
+    unsigned int    mNPairPartners;   // size of list of particles 2 in setupPairPartners
+    std::vector<unsigned short> mGridPartners; // partners from mGrid
+    std::vector<unsigned short> mPartnersIntersection; // positions also in mGridPartners
+    StHFMassWindowFilter* mV0MassFilter; // pre-filters of createTertiaryV0s, independent of mMassFilter/mGrid
+    StHFDirectionGrid*    mV0Grid;
+    unsigned int    mV0NPairPartners;
+    std::vector<unsigned short> mV0Partners;  // partners in createTertiaryV0s, kept between events
+    std::vector<unsigned short> mV0Positive1; // particles of createTertiaryV0s split by charge, kept between events
+    std::vector<unsigned short> mV0Negative1;
+    std::vector<unsigned short> mV0Positive2;
+    std::vector<unsigned short> mV0Negative2;
+    StHFTripletBuilder* mTripletBuilder;  // triplet seeds in createSecondaryTriplets, kept between events
+
+    std::vector<StHFCuts*> mHFCutsVariants; // cut variants, owned by the maker, shared with workers
+    std::vector<TList*>    mVariantOutLists; // histogram list per cut variant, owned by mOutList
+
+    unsigned int    mNThreads;          // number of worker threads, 0/1 : no workers
+    bool            mIsWorker;          // true for workers created via createWorker(...)
+    std::vector<StPicoHFMaker*> mWorkers; // workers, owned by the maker
+    StHFThreadPool* mThreadPool;        // threads running the workers
+    StHFWorkQueue*  mEventQueue;        // events to be processed by the workers
+    StHFWorkQueue*  mFreeQueue;         // event snapshots ready to be filled
+    unsigned int    mNSnapshots;        // number of event snapshots
+    StHFEventSnapshot* mSnapshot;       // event processed by this worker, NULL if not a worker
+    unsigned int    mNEventsFailed;     // n events, for which MakeHF() of the worker did not return kStOK
 
     TString         mOuputFileBaseName; // base name for output files
                                         //   for tree     -> <mOuputFileBaseName>.picoHFtree.root
@@ -143,9 +467,37 @@ class StPicoHFMaker : public StMaker
 
     TTree*          mTree;              // tree holding "mPicoHFEvent" for writing only
 
+    unsigned int    mTreeFormat;        // use enum of StPicoHFMaker::eTreeFormat
+    TString         mFlatTreeColumns;   // columns to be read for kFlatTree
+    StHFCandidateTree* mFlatTree;       // flat branches for kFlatTree, NULL otherwise
+
     TChain*         mHFChain;           // chain to read in HF tree
     int             mEventCounter;      // n Processed events in chain
 
+    unsigned int    mReadMode;          // use enum of StPicoHFMaker::eReadMode
+    TString         mHFTreeIndexFileName; // file to load/save the index of the HF tree
+    StHFEventIndex* mEventIndex;        // index of the HF tree for kIndexedRead, NULL otherwise
+    int             mNEventsNoHFEntry;  // n picoDst events without HF tree entry
+
+    bool            mStoreDaughters;    // store daughter tracks of candidates in kWrite
+
+    unsigned int    mTrackSelectionMode; // use enum of StPicoHFMaker::eTrackSelectionMode
+    StHFTrackSelection* mTrackSelection; // batch selection for kBatchSelection
+    std::vector<unsigned int> mSelectedTracks; // entries of mTrackSelection selected as any particle
+    std::vector<StPicoTrack const*> mPerTrackTracks; // tracks of the event for kPerTrackSelection
+    std::vector<unsigned char> mPerTrackGood;        // track cuts passed by mPerTrackTracks
+
+    bool            mProfiling;         // timers and counters per stage, see setProfiling(...)
+    StHFStageProfiler* mProfiler;       // profiler of this maker (each worker has its own)
+    StHFStageProfiler* mWorkerProfiler; // sum of the profilers of all workers, NULL without workers
+
+    TString         mCaptureFileName;   // capture file, see setCaptureFile(...)
+    unsigned int    mCapturePrescale;   // capture every mCapturePrescale-th good event
+    unsigned int    mCaptureMinTracks;  // .. with at least mCaptureMinTracks selected tracks
+    unsigned int    mCaptureNEventsMax; // .. up to mCaptureNEventsMax events (0 : all)
+    unsigned int    mNCaptureCandidates; // n good events with enough tracks seen so far
+    StHFCaptureWriter* mCaptureWriter;  // writer of the capture file, NULL if not capturing
+
     TFile*          mOutputFileTree;    // ptr to file saving the HFtree
     TFile*          mOutputFileList;    // ptr to file saving the list of histograms
     ClassDef(StPicoHFMaker, 1)
@@ -154,6 +506,29 @@ class StPicoHFMaker : public StMaker
 inline void StPicoHFMaker::setHFBaseCuts(StHFCuts* cuts)   { mHFCuts = cuts; }
 inline void StPicoHFMaker::setMakerMode(unsigned short us) { mMakerMode = us; }
 inline void StPicoHFMaker::setDecayMode(unsigned short us) { mDecayMode = us; }
+inline void StPicoHFMaker::setMassFilterMode(unsigned short us) { mMassFilterMode = us; }
+inline void StPicoHFMaker::setDirectionGridMode(unsigned short us) { mDirectionGridMode = us; }
+inline void StPicoHFMaker::setNThreads(unsigned int n)     { mNThreads = n; }
+inline void StPicoHFMaker::setTreeFormat(unsigned short us) { mTreeFormat = us; }
+inline void StPicoHFMaker::setFlatTreeColumns(char const* columns) { mFlatTreeColumns = columns; }
+inline void StPicoHFMaker::setReadMode(unsigned short us)  { mReadMode = us; }
+inline void StPicoHFMaker::setHFTreeIndexFileName(char const* fileName) { mHFTreeIndexFileName = fileName; }
+inline void StPicoHFMaker::setStoreDaughters(bool b)       { mStoreDaughters = b; }
+inline void StPicoHFMaker::setTrackSelectionMode(unsigned short us) { mTrackSelectionMode = us; }
+inline void StPicoHFMaker::setProfiling(bool b)            { mProfiling = b; }
+inline void StPicoHFMaker::setCaptureFile(char const* fileName, unsigned int prescale, 
+					  unsigned int minTracks, unsigned int nEventsMax) {
+  mCaptureFileName = fileName; mCapturePrescale = prescale > 0 ? prescale : 1; 
+  mCaptureMinTracks = minTracks; mCaptureNEventsMax = nEventsMax;
+}
+
+inline StHFStageProfiler * StPicoHFMaker::profiler() const { return mProfiler; }
+
+inline StHFCandidateTree const * StPicoHFMaker::candidateTree() const { return mFlatTree; }
+
+inline unsigned int     StPicoHFMaker::nHFCutsVariants() const { return mHFCutsVariants.size(); }
+inline StHFCuts const * StPicoHFMaker::hfCutsVariant(unsigned int idx) const { return mHFCutsVariants[idx]; }
+inline TList*           StPicoHFMaker::variantOutList(unsigned int idx) const { return mVariantOutLists[idx]; }
 
 inline unsigned int StPicoHFMaker::isDecayMode()           { return mDecayMode; }
 inline unsigned int StPicoHFMaker::isMakerMode()           { return mMakerMode; }
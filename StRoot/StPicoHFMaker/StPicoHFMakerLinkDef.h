@@ -0,0 +1,12 @@
+// -- schema evolution of the stored candidates of StPicoHFMaker,
+//    all other classes of the package are added from their ClassDef
+#ifdef __CINT__
+
+#pragma link C++ class StHFPair+;
+#pragma link C++ class StHFTriplet+;
+
+// -- version 1 stored the pointing angle, version 2 stores its cos
+#pragma read sourceClass="StHFPair" targetClass="StHFPair" version="[1]" source="float mPointingAngle" target="mCosPointingAngle" include="cmath" code="{ mCosPointingAngle = std::cos(onfile.mPointingAngle); }"
+#pragma read sourceClass="StHFTriplet" targetClass="StHFTriplet" version="[1]" source="float mPointingAngle" target="mCosPointingAngle" include="cmath" code="{ mCosPointingAngle = std::cos(onfile.mPointingAngle); }"
+
+#endif
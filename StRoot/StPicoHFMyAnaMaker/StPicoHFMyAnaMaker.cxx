@@ -16,6 +16,12 @@
 #include "StPicoHFMaker/StHFCuts.h"
 #include "StPicoHFMaker/StHFPair.h"
 #include "StPicoHFMaker/StHFTriplet.h"
+#include "StPicoHFMaker/StHFTrackCache.h"
+#include "StPicoHFMaker/StHFTrackTable.h"
+#include "StPicoHFMaker/StHFTrackSelection.h"
+#include "StPicoHFMaker/StHFCandidateTree.h"
+#include "StPicoHFMaker/StHFDaughter.h"
+#include "StPicoHFMaker/StHFStageProfiler.h"
 
 #include "StPicoHFMyAnaMaker.h"
 
@@ -25,7 +31,7 @@ ClassImp(StPicoHFMyAnaMaker)
 StPicoHFMyAnaMaker::StPicoHFMyAnaMaker(char const* name, StPicoDstMaker* picoMaker, char const* outputBaseFileName,  
 					   char const* inputHFListHFtree = "") :
   StPicoHFMaker(name, picoMaker, outputBaseFileName, inputHFListHFtree),
-  mDecayChannel(kChannel1) {
+  mDecayChannel(kChannel1), mPionPositions(), mStageCreateCandidates(-1), mStageAnalyseCandidates(-1) {
   // constructor
 }
 
@@ -34,6 +40,17 @@ StPicoHFMyAnaMaker::~StPicoHFMyAnaMaker() {
   // destructor
 }
 
+// _________________________________________________________
+StPicoHFMaker* StPicoHFMyAnaMaker::createWorker(char const* name) const {
+  // -- worker for setNThreads(...), needs the same settings as this maker
+  //    ADD USER SETTINGS HERE
+
+  StPicoHFMyAnaMaker* worker = new StPicoHFMyAnaMaker(name, NULL, "", "");
+  worker->setDecayChannel(mDecayChannel);
+
+  return worker;
+}
+
 // _________________________________________________________
 int StPicoHFMyAnaMaker::InitHF() {
   // -- INITIALIZE USER HISTOGRAMS ETC HERE -------------------
@@ -41,6 +58,14 @@ int StPicoHFMyAnaMaker::InitHF() {
 
   // EXAMPLE //  mOutList->Add(new TH1F(...));
   // EXAMPLE //  TH1F* hist = static_cast<TH1F*>(mOutList->Last());
+
+  // -- histograms per cut variant (addHFCutsVariant(...) in run macro)
+  // EXAMPLE //  for (unsigned int ii = 0; ii < nHFCutsVariants(); ++ii)
+  // EXAMPLE //    variantOutList(ii)->Add(new TH1F("hMass", "mass;m (GeV/c^{2})", 100, 1.6, 2.1));
+
+  // -- own stages for setProfiling(true), see timedCreateCandidates() and timedAnalyseCandidates()
+  mStageCreateCandidates  = profiler()->addStage("createCandidates");
+  mStageAnalyseCandidates = profiler()->addStage("analyseCandidates");
   
   return kStOK;
 }
@@ -64,20 +89,34 @@ int StPicoHFMyAnaMaker::MakeHF() {
   //     - analyseCandidates()
 
   if (isMakerMode() == StPicoHFMaker::kWrite) {
-    createCandidates();
+    timedCreateCandidates();
   }
-  else if (isMakerMode() == StPicoHFMaker::kRead) {
+  else if (isMakerMode() == StPicoHFMaker::kRead || isMakerMode() == StPicoHFMaker::kReplay) {
     // -- the reading back of the perviously written trees happens in the background
-    analyseCandidates();
+    timedAnalyseCandidates();
   }
   else if (isMakerMode() == StPicoHFMaker::kAnalyse) {
-    createCandidates();
-    analyseCandidates();
+    timedCreateCandidates();
+    timedAnalyseCandidates();
   }
 
   return kStOK;
 }
 
+// _________________________________________________________
+int StPicoHFMyAnaMaker::timedCreateCandidates() {
+  // -- createCandidates() as own stage for setProfiling(true)
+  StHFStageTimer timer(*profiler(), mStageCreateCandidates);
+  return createCandidates();
+}
+
+// _________________________________________________________
+int StPicoHFMyAnaMaker::timedAnalyseCandidates() {
+  // -- analyseCandidates() as own stage for setProfiling(true)
+  StHFStageTimer timer(*profiler(), mStageAnalyseCandidates);
+  return analyseCandidates();
+}
+
 // _________________________________________________________
 int StPicoHFMyAnaMaker::createCandidates() {
   // create candidate pairs/ triplet and fill them in arrays (in StPicoHFEvent)
@@ -85,28 +124,58 @@ int StPicoHFMyAnaMaker::createCandidates() {
   // -- ADD USER CODE TO CREATE PARTICLE CANDIDATES --------
   //    - vectors mIdxPicoKaons, mIdxPicoPions mIdxPicoProtons
   //      have been filled in the background using the cuts in HFCuts
+  //    - cachedTrack(idx) provides the tracks with their helices 
+  //      already moved to the primary vertex
+  //    - mTrackTable->row(idx) provides the row of the tracks in the
+  //      structure-of-arrays track table, used in the pair loops
 
   // -- Decay channel1 --- EXAMPLE
   if (mDecayChannel == StPicoHFMyAnaMaker::kChannel1) {
+    // -- pair is constructed directly in the event, the slot is reused until a pair passes the cuts
+    StHFPair* pair = NULL;
+
+    // -- pions which can form a pair passing the secondary pair cuts with a given kaon
+    std::vector<unsigned short> & pionPositions = mPionPositions;
+    setupPairPartners(mIdxPicoPions, M_PION_PLUS);
 
     for (unsigned short idxKaon = 0; idxKaon < mIdxPicoKaons.size(); ++idxKaon) {
-      StPicoTrack const *kaon = mPicoDst->track(mIdxPicoKaons[idxKaon]);
+      int const kaonRow = mTrackTable->row(mIdxPicoKaons[idxKaon]);
+
+      pairPartners(mIdxPicoKaons[idxKaon], M_KAON_PLUS, StHFCuts::kSecondaryPair, pionPositions);
       
-      for (unsigned short idxPion = 0; idxPion < mIdxPicoPions.size(); ++idxPion) {
-	StPicoTrack const *pion = mPicoDst->track(mIdxPicoPions[idxPion]);
+      for (unsigned short iPos = 0; iPos < pionPositions.size(); ++iPos) {
+	unsigned short const idxPion = pionPositions[iPos];
+	int const pionRow = mTrackTable->row(mIdxPicoPions[idxPion]);
 	
 	if (mIdxPicoKaons[idxKaon] == mIdxPicoPions[idxPion]) 
 	  continue;
       
-	StHFPair pair(kaon, pion, M_KAON_PLUS, M_PION_PLUS, mIdxPicoKaons[idxKaon], mIdxPicoPions[idxPion], mPrimVtx, mBField);
-	if (!mHFCuts->isGoodSecondaryVertexPair(pair)) 
+	if (!pair)
+	  pair = mPicoHFEvent->emplaceHFSecondaryVertexPair();
+
+	// -- pair is built in stages, cuts are applied as early as possible
+	unsigned int nCutsPassed = 0;
+	bool const bGood = mHFCuts->isGoodSecondaryVertexPair(*mTrackTable, kaonRow, pionRow, M_KAON_PLUS, M_PION_PLUS, *pair, &nCutsPassed);
+	countPairCuts(nCutsPassed);
+	if (!bGood) 
 	    continue;
-	mPicoHFEvent->addHFSecondaryVertexPair(&pair);
+
+	// -- keep pair
+	pair = NULL;
 	
-      } // for (unsigned short idxPion = 0; idxPion < mIdxPicoPions.size(); ++idxPion) {
+      } // for (unsigned short iPos = 0; iPos < pionPositions.size(); ++iPos) {
     } // for (unsigned short idxKaon = 0; idxKaon < mIdxPicoKaons.size(); ++idxKaon) {
+
+    if (pair)
+      mPicoHFEvent->rollbackHFSecondaryVertex();
   } // else  if (mDecayChannel == StPicoHFMyAnaMaker::Channel1) {
 
+  // -- Decay channel2 --- EXAMPLE : three body decay (kThreeParticleDecay), e.g. Lambda_c -> p K pi
+  //    1-2 pairs are pruned before the third particle is added, see StHFTripletBuilder
+  else if (mDecayChannel == StPicoHFMyAnaMaker::kChannel2) {
+    createSecondaryTriplets(mIdxPicoProtons, mIdxPicoKaons, mIdxPicoPions, M_PROTON, M_KAON_PLUS, M_PION_PLUS, false);
+  } // else  if (mDecayChannel == StPicoHFMyAnaMaker::kChannel2) {
+
  return kStOK;
 }
 
@@ -123,14 +192,45 @@ int StPicoHFMyAnaMaker::analyseCandidates() {
   // -- Decay channel1
   if (mDecayChannel == StPicoHFMyAnaMaker::kChannel1) {
 
+    // -- flat HF tree : only the requested columns are read
+    StHFCandidateTree const * flatTree = candidateTree();
+    if ((isMakerMode() == StPicoHFMaker::kRead || isMakerMode() == StPicoHFMaker::kReplay) && flatTree) {
+      float const * aM  = flatTree->column(StHFCandidateTree::kSecondary, StHFCandidateTree::kM);
+      float const * aPt = flatTree->column(StHFCandidateTree::kSecondary, StHFCandidateTree::kPt);
+      if (!aM || !aPt)
+	return kStOK;
+
+      for (unsigned int idx = 0; idx < flatTree->nCandidates(StHFCandidateTree::kSecondary); ++idx) {
+	// EXAMPLE //  static_cast<TH2F*>(mOutList->FindObject("hMassPt"))->Fill(aM[idx], aPt[idx]);
+      } // for (unsigned int idx = 0; idx < flatTree->nCandidates(StHFCandidateTree::kSecondary); ++idx) {
+      return kStOK;
+    }
+
     // -- fill nTuple / hists for secondary pairs
     TClonesArray const * aCandidates= mPicoHFEvent->aHFSecondaryVertices();
     
     for (unsigned int idx = 0; idx <  mPicoHFEvent->nHFSecondaryVertices(); ++idx) {
       StHFPair const* pair = static_cast<StHFPair*>(aCandidates->At(idx));
 
-      StPicoTrack const* kaon = mPicoDst->track(pair->particle1Idx());
-      StPicoTrack const* pion = mPicoDst->track(pair->particle2Idx());
+      // -- cut variants passed by the pair, one bit per variant
+      // EXAMPLE //  ULong64_t const variants = pairCutsVariants(*pair, StHFCuts::kSecondaryPair);
+      // EXAMPLE //  for (unsigned int ii = 0; ii < nHFCutsVariants(); ++ii)
+      // EXAMPLE //    if (variants & (static_cast<ULong64_t>(1) << ii))
+      // EXAMPLE //      static_cast<TH1F*>(variantOutList(ii)->FindObject("hMass"))->Fill(pair->m());
+
+      // -- kReplay : no picoDst, use the stored daughters and the StHFDaughter cuts
+      if (isMakerMode() == StPicoHFMaker::kReplay) {
+	StHFDaughter const* kaon = hfDaughter(pair->particle1Idx());
+	StHFDaughter const* pion = hfDaughter(pair->particle2Idx());
+	if (!kaon || !pion)
+	  continue;
+
+	// ... e.g. mHFCuts->isTPCKaon(kaon), kaon->pt(), kaon->tofBeta()
+	continue;
+      }
+
+      StPicoTrack const* kaon = picoTrack(pair->particle1Idx());
+      StPicoTrack const* pion = picoTrack(pair->particle2Idx());
 
     } // for (unsigned int idx = 0; idx <  mPicoHFEvent->nHFSecondaryVertices(); ++idx) {
   } // else  if (mDecayChannel == StPicoHFMyAnaMaker::kChannel1) {
@@ -156,3 +256,18 @@ bool StPicoHFMyAnaMaker::isProton(StPicoTrack const * const trk, float const & t
   return (mHFCuts->isGoodTrack(trk) && mHFCuts->isTPCProton(trk));
 }
 
+// _________________________________________________________
+bool StPicoHFMyAnaMaker::setupTrackSelection(StHFTrackSelection & selection) const {
+  // -- same selection as isPion, isKaon, isProton for kBatchSelection
+  //    StHFTrackSelection::kGoodTrack is always required
+  //    e.g. TPC or TOF kaon :
+  //      selection.addRequirement(StHFTrackSelection::kKaon, StHFTrackSelection::bit(StHFTrackSelection::kTPCKaon));
+  //      selection.addRequirement(StHFTrackSelection::kKaon, StHFTrackSelection::bit(StHFTrackSelection::kTOFKaon));
+
+  selection.addRequirement(StHFTrackSelection::kPion,   0);
+  selection.addRequirement(StHFTrackSelection::kKaon,   StHFTrackSelection::bit(StHFTrackSelection::kTPCKaon));
+  selection.addRequirement(StHFTrackSelection::kProton, StHFTrackSelection::bit(StHFTrackSelection::kTPCProton));
+
+  return true;
+}
+
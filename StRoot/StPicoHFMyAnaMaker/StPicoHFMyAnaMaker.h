@@ -42,6 +42,8 @@
  *       isPion
  *       isKaon
  *       isProton
+ *    or, for setTrackSelectionMode(StPicoHFMaker::kBatchSelection), the same 
+ *    selection as requirements in setupTrackSelection
  *
  *  --------------------------------------------------
  *  Authors:  Xin Dong (xdong@lbl.gov)
@@ -61,6 +63,7 @@ class StPicoHFEvent;
 class StHFPair;
 class StHFTriplet;
 class StHFCuts;
+class StHFTrackSelection;
 
 class StPicoHFMyAnaMaker : public StPicoHFMaker 
 {
@@ -83,16 +86,27 @@ class StPicoHFMyAnaMaker : public StPicoHFMaker
   virtual bool isPion(StPicoTrack const*, float const & bTofBeta) const;
   virtual bool isKaon(StPicoTrack const*, float const & bTofBeta) const;
   virtual bool isProton(StPicoTrack const*, float const & bTofBeta) const;
+
+  virtual bool setupTrackSelection(StHFTrackSelection & selection) const;
+
+  virtual StPicoHFMaker* createWorker(char const* name) const;
   
  private:
   
   int createCandidates();
   int analyseCandidates();
+  int timedCreateCandidates();
+  int timedAnalyseCandidates();
 
   // -- private members --------------------------
 
   unsigned int mDecayChannel;
 
+  std::vector<unsigned short> mPionPositions; // pair partners, kept between events
+
+  int mStageCreateCandidates;                 // profiler stages, see setProfiling(...)
+  int mStageAnalyseCandidates;
+
   // -- ADD USER MEMBERS HERE ------------------- 
 
 
@@ -0,0 +1,682 @@
+/* **************************************************
+ *  Standalone micro-benchmark of the pair and triplet
+ *  kinematics of StPicoHFMaker and StPicoD0EventMaker
+ *
+ *  - synthetic Au+Au 200 GeV like events : helices of charged
+ *    tracks in |eta| < 1 with centrality dependent multiplicity,
+ *    pT spectrum, DCA resolution and a fraction of secondaries.
+ *    No StPicoTrack and no picoDst file is needed.
+ *
+ *  - timed constructors (ns/pair and pairs/s) :
+ *     pairHelix     - StHFPair(StHFCachedTrack, StHFCachedTrack, ...)
+ *     pairTable     - StHFPair(StHFTrackTable, row1, row2, ...)
+ *     pairTableStraightLine, pairTableHelixRefine, pairTableHelixFull
+ *                   - StHFPair::createGoodPair(StHFTrackTable, ...) with open
+ *                     cuts, in the vertexing modes of StHFCuts
+ *     pairTableSingle     - as pairTableStraightLine, float only kinematics
+ *     kaonPionHelix - StKaonPion(StHFCachedTrack, StHFCachedTrack, ...)
+ *     kaonPionTable - StKaonPion(StHFTrackTable, kRow, pRow)
+ *     kaonPionTableSingle - StKaonPion(StHFTrackTable, kRow, pRow, true), float only
+ *     tertiaryPair  - StHFPair(StHFCachedTrack, StHFPair const*, ...)
+ *     triplet       - StHFTriplet(StHFCachedTrack x 3, ...)
+ *
+ *  - validation of the float only kinematics : maximum absolute and relative
+ *    deviation from the double precision path per stored variable of StHFPair
+ *    and StKaonPion, on the same pairs as the timed constructors
+ *
+ *  - decay vertex resolution of the vertexing modes : true two-body
+ *    decays of low pT daughters (0.15 - 1 GeV/c) at a known decay vertex,
+ *    distance of the reconstructed to the true decay vertex (mean and RMS in um).
+ *    The helices are not smeared, only the error of the method is seen
+ *
+ *  - results are written as JSON (-o), a previous JSON can be given
+ *    as baseline (-b) : the exit code is 1 if a benchmark is slower
+ *    than the baseline by more than the tolerance (-r)
+ *
+ *  Usage : hfKinematicsBenchmark [-e nEvents] [-m nTracksCentral] [-p maxPairsPerEvent]
+ *                                [-k nTertiaryPairs] [-t maxTripletsPerEvent] [-d nDecays] [-s seed]
+ *                                [-o result.json] [-b baseline.json] [-r tolerance]
+ *
+ * **************************************************
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <unistd.h>
+
+#include "TRandom3.h"
+
+#include "StThreeVectorF.hh"
+#include "StThreeVectorD.hh"
+#include "StPhysicalHelixD.hh"
+#include "SystemOfUnits.h"
+#include "phys_constants.h"
+
+#include "StPicoHFMaker/StHFTrackCache.h"
+#include "StPicoHFMaker/StHFTrackTable.h"
+#include "StPicoHFMaker/StHFPair.h"
+#include "StPicoHFMaker/StHFTriplet.h"
+#include "StPicoHFMaker/StHFCuts.h"
+#include "StPicoHFMaker/StHFPairKernel.h"
+#include "StPicoD0EventMaker/StKaonPion.h"
+
+using namespace std;
+
+// -- benchmarks, in order of the output
+enum eBenchmark {kPairHelix, kPairTable, kPairTableStraightLine, kPairTableHelixRefine, kPairTableHelixFull, kPairTableSingle,
+                 kKaonPionHelix, kKaonPionTable, kKaonPionTableSingle, kTertiaryPair, kTriplet, kBenchmarkMax};
+char const * const benchmarkNames[kBenchmarkMax] = {"pairHelix", "pairTable", "pairTableStraightLine", "pairTableHelixRefine",
+                                                    "pairTableHelixFull", "pairTableSingle", "kaonPionHelix", "kaonPionTable",
+                                                    "kaonPionTableSingle", "tertiaryPair", "triplet"};
+
+// -- stored variables compared between float only and double precision kinematics
+enum eVariable {kVarM, kVarPt, kVarEta, kVarPhi, kVarCosPointingAngle, kVarDecayLength, kVarDcaDaughters, kVarCosThetaStar,
+                kVarV0x, kVarV0y, kVarV0z, kVariableMax};
+char const * const variableNames[kVariableMax] = {"m", "pt", "eta", "phi", "cosPointingAngle", "decayLength", "dcaDaughters",
+                                                  "cosThetaStar", "v0x", "v0y", "v0z"};
+
+// -- vertexing modes of StHFCuts, in order of the resolution output
+int const nVertexingModes = 3;
+char const * const vertexingModeNames[nVertexingModes] = {"straightLine", "helixRefine", "helixFull"};
+
+//-----------------------------------------------------------------------------
+struct BenchmarkConfig
+{
+   BenchmarkConfig() : nEvents(100), nTracksCentral(1000), maxPairs(20000), nTertiaryPairs(20), maxTriplets(20000),
+                       nDecays(100000), seed(4357), bField(4.98), tolerance(0.1) {}
+
+   unsigned int nEvents;
+   unsigned int nTracksCentral; // mean number of tracks in |eta| < 1 for the most central events
+   unsigned int maxPairs;       // pairs per event and two-track benchmark
+   unsigned int nTertiaryPairs; // pairs per event used as particle 2 of tertiaryPair
+   unsigned int maxTriplets;    // triplets per event
+   unsigned int nDecays;        // decays of the vertex resolution study
+   unsigned int seed;
+   float bField;                // kGauss
+   double tolerance;            // allowed slow-down with respect to the baseline
+   string outputFile;
+   string baselineFile;
+};
+
+//-----------------------------------------------------------------------------
+struct BenchmarkResult
+{
+   BenchmarkResult() : n(0), seconds(0.) {}
+
+   double nsPerPair() const { return n ? 1.e9 * seconds / n : 0.; }
+   double pairsPerSecond() const { return seconds > 0. ? n / seconds : 0.; }
+
+   unsigned long long n;
+   double seconds;
+};
+
+//-----------------------------------------------------------------------------
+// deviation of one stored variable of the float only path from the double precision path
+struct DeviationResult
+{
+   DeviationResult() : n(0), nMismatch(0), maxAbsolute(0.), maxRelative(0.) {}
+
+   void fill(double value, double reference, bool isAngle = false)
+   {
+      if (std::isnan(value) || std::isnan(reference))
+      {
+         if (std::isnan(value) != std::isnan(reference)) ++nMismatch;
+         return;
+      }
+
+      double delta = fabs(value - reference);
+      if (isAngle && delta > M_PI) delta = 2. * M_PI - delta;
+
+      ++n;
+      if (delta > maxAbsolute) maxAbsolute = delta;
+      if (reference != 0. && delta / fabs(reference) > maxRelative) maxRelative = delta / fabs(reference);
+   }
+
+   unsigned long long n;
+   unsigned long long nMismatch; // NaN in only one of the paths
+   double maxAbsolute;
+   double maxRelative;
+};
+
+//-----------------------------------------------------------------------------
+struct ResolutionResult
+{
+   ResolutionResult() : n(0), sumDistance(0.), sumDistance2(0.), sumDcaDaughters(0.) {}
+
+   double meanUm() const { return n ? 1.e4 * sumDistance / n : 0.; }
+   double rmsUm() const { return n ? 1.e4 * sqrt(sumDistance2 / n) : 0.; }
+   double meanDcaDaughtersUm() const { return n ? 1.e4 * sumDcaDaughters / n : 0.; }
+
+   unsigned long long n;
+   double sumDistance;          // cm
+   double sumDistance2;         // cm^2
+   double sumDcaDaughters;      // cm
+};
+
+//-----------------------------------------------------------------------------
+// synthetic event : primary vertex and helices of all tracks
+class SyntheticEventGenerator
+{
+  public:
+   SyntheticEventGenerator(BenchmarkConfig const& config) : mConfig(config), mRandom(config.seed) {}
+
+   void generate(StThreeVectorF& vtx, vector<StHFCachedTrack>& tracks);
+
+  private:
+   double samplePt();
+
+   BenchmarkConfig const& mConfig;
+   TRandom3 mRandom;
+};
+
+//-----------------------------------------------------------------------------
+void SyntheticEventGenerator::generate(StThreeVectorF& vtx, vector<StHFCachedTrack>& tracks)
+{
+   // centrality 0-80%, multiplicity falls roughly exponentially with centrality
+   double const centrality = mRandom.Uniform(0., 0.8);
+   unsigned int const nTracks = mRandom.Poisson(mConfig.nTracksCentral * exp(-centrality / 0.2));
+
+   double vz = 0.;
+   do vz = mRandom.Gaus(0., 3.); while (fabs(vz) > 6.);
+   vtx = StThreeVectorF(mRandom.Gaus(0., 0.02), mRandom.Gaus(0., 0.02), vz);
+
+   tracks.clear();
+   tracks.reserve(nTracks);
+
+   for (unsigned int i = 0; i < nTracks; ++i)
+   {
+      double const pt = samplePt();
+      double const eta = mRandom.Uniform(-1., 1.);
+      double const phi = mRandom.Uniform(0., 2. * M_PI);
+      short const charge = mRandom.Rndm() < 0.5 ? -1 : 1;
+
+      StThreeVectorD const mom(pt * cos(phi), pt * sin(phi), pt * sinh(eta));
+
+      // DCA to the primary vertex : resolution of HFT tracks, 10% secondaries
+      double dcaXY = 0.;
+      double dcaZ = 0.;
+      if (mRandom.Rndm() < 0.1)
+      {
+         dcaXY = mRandom.Exp(0.1) * (mRandom.Rndm() < 0.5 ? -1. : 1.);
+         dcaZ = mRandom.Exp(0.1) * (mRandom.Rndm() < 0.5 ? -1. : 1.);
+      }
+      else
+      {
+         double const p = mom.mag();
+         double const sigma = 1.e-4 * sqrt(20. * 20. + 50. * 50. / (p * p)); // cm
+         dcaXY = mRandom.Gaus(0., sigma);
+         dcaZ = mRandom.Gaus(0., sigma);
+      }
+
+      // origin displaced perpendicular to the transverse momentum
+      StThreeVectorD const origin(vtx.x() - dcaXY * sin(phi), vtx.y() + dcaXY * cos(phi), vtx.z() + dcaZ);
+      StPhysicalHelixD const helix(mom, origin, mConfig.bField * kilogauss, charge);
+
+      tracks.push_back(StHFCachedTrack(helix, charge, i, i, vtx, mConfig.bField));
+   }
+}
+
+//-----------------------------------------------------------------------------
+double SyntheticEventGenerator::samplePt()
+{
+   // dN/dpT ~ pT exp(-pT/T), <pT> = 0.5 GeV/c, pT > 0.15 GeV/c
+   double pt = 0.;
+   do pt = mRandom.Exp(0.25) + mRandom.Exp(0.25); while (pt < 0.15);
+   return pt;
+}
+
+//-----------------------------------------------------------------------------
+double now()
+{
+   timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + 1.e-9 * ts.tv_nsec;
+}
+
+//-----------------------------------------------------------------------------
+// run all benchmarks on one event, checksum keeps the compiler from dropping the constructors
+// vertexingCuts : open cuts, one per vertexing mode, singleCuts : open cuts with float only kinematics
+void runEvent(BenchmarkConfig const& config, StThreeVectorF const& vtx, vector<StHFCachedTrack> const& tracks,
+              StHFCuts const* vertexingCuts, StHFCuts const& singleCuts, StHFTrackTable& table, BenchmarkResult* results,
+              DeviationResult* pairDeviation, DeviationResult* kaonPionDeviation, double& checksum)
+{
+   float const bField = config.bField;
+   unsigned int const nTracks = tracks.size();
+
+   table.reset(nTracks, vtx.x(), vtx.y(), vtx.z(), bField);
+   for (unsigned int i = 0; i < nTracks; ++i) tracks[i].addToTable(table, 0.);
+
+   // pairs (i, j), i < j, up to config.maxPairs
+   vector<unsigned int> pair1;
+   vector<unsigned int> pair2;
+   for (unsigned int i = 0; i < nTracks && pair1.size() < config.maxPairs; ++i)
+   {
+      for (unsigned int j = i + 1; j < nTracks && pair1.size() < config.maxPairs; ++j)
+      {
+         pair1.push_back(i);
+         pair2.push_back(j);
+      }
+   }
+   unsigned int const nPairs = pair1.size();
+
+   double start = now();
+   for (unsigned int i = 0; i < nPairs; ++i)
+   {
+      StHFPair const pair(tracks[pair1[i]], tracks[pair2[i]], M_KAON_PLUS, M_PION_PLUS, vtx, bField);
+      checksum += pair.m();
+   }
+   results[kPairHelix].seconds += now() - start;
+   results[kPairHelix].n += nPairs;
+
+   start = now();
+   for (unsigned int i = 0; i < nPairs; ++i)
+   {
+      StHFPair const pair(table, table.row(pair1[i]), table.row(pair2[i]), M_KAON_PLUS, M_PION_PLUS);
+      checksum += pair.m();
+   }
+   results[kPairTable].seconds += now() - start;
+   results[kPairTable].n += nPairs;
+
+   for (int iMode = 0; iMode < nVertexingModes; ++iMode)
+   {
+      start = now();
+      for (unsigned int i = 0; i < nPairs; ++i)
+      {
+         StHFPair pair;
+         pair.createGoodPair(table, table.row(pair1[i]), table.row(pair2[i]), M_KAON_PLUS, M_PION_PLUS,
+                             vertexingCuts[iMode], StHFCuts::kSecondaryPair);
+         checksum += pair.m();
+      }
+      results[kPairTableStraightLine + iMode].seconds += now() - start;
+      results[kPairTableStraightLine + iMode].n += nPairs;
+   }
+
+   start = now();
+   for (unsigned int i = 0; i < nPairs; ++i)
+   {
+      StHFPair pair;
+      pair.createGoodPair(table, table.row(pair1[i]), table.row(pair2[i]), M_KAON_PLUS, M_PION_PLUS,
+                          singleCuts, StHFCuts::kSecondaryPair);
+      checksum += pair.m();
+   }
+   results[kPairTableSingle].seconds += now() - start;
+   results[kPairTableSingle].n += nPairs;
+
+   start = now();
+   for (unsigned int i = 0; i < nPairs; ++i)
+   {
+      StKaonPion const kaonPion(tracks[pair1[i]], tracks[pair2[i]], vtx, bField);
+      checksum += kaonPion.m();
+   }
+   results[kKaonPionHelix].seconds += now() - start;
+   results[kKaonPionHelix].n += nPairs;
+
+   start = now();
+   for (unsigned int i = 0; i < nPairs; ++i)
+   {
+      StKaonPion const kaonPion(table, table.row(pair1[i]), table.row(pair2[i]));
+      checksum += kaonPion.m();
+   }
+   results[kKaonPionTable].seconds += now() - start;
+   results[kKaonPionTable].n += nPairs;
+
+   start = now();
+   for (unsigned int i = 0; i < nPairs; ++i)
+   {
+      StKaonPion const kaonPion(table, table.row(pair1[i]), table.row(pair2[i]), true);
+      checksum += kaonPion.m();
+   }
+   results[kKaonPionTableSingle].seconds += now() - start;
+   results[kKaonPionTableSingle].n += nPairs;
+
+   // float only versus double precision, not timed
+   for (unsigned int i = 0; i < nPairs; ++i)
+   {
+      int const row1 = table.row(pair1[i]);
+      int const row2 = table.row(pair2[i]);
+
+      StHFPair pairDouble;
+      StHFPair pairSingle;
+      bool const bGoodDouble = pairDouble.createGoodPair(table, row1, row2, M_KAON_PLUS, M_PION_PLUS,
+                                                         vertexingCuts[StHFCuts::kStraightLine], StHFCuts::kSecondaryPair);
+      bool const bGoodSingle = pairSingle.createGoodPair(table, row1, row2, M_KAON_PLUS, M_PION_PLUS,
+                                                         singleCuts, StHFCuts::kSecondaryPair);
+      if (bGoodDouble && bGoodSingle)
+      {
+         pairDeviation[kVarM].fill(pairSingle.m(), pairDouble.m());
+         pairDeviation[kVarPt].fill(pairSingle.pt(), pairDouble.pt());
+         pairDeviation[kVarEta].fill(pairSingle.eta(), pairDouble.eta());
+         pairDeviation[kVarPhi].fill(pairSingle.phi(), pairDouble.phi(), true);
+         pairDeviation[kVarCosPointingAngle].fill(pairSingle.cosPointingAngle(), pairDouble.cosPointingAngle());
+         pairDeviation[kVarDecayLength].fill(pairSingle.decayLength(), pairDouble.decayLength());
+         pairDeviation[kVarDcaDaughters].fill(pairSingle.dcaDaughters(), pairDouble.dcaDaughters());
+         pairDeviation[kVarCosThetaStar].fill(pairSingle.cosThetaStar(), pairDouble.cosThetaStar());
+         pairDeviation[kVarV0x].fill(pairSingle.v0x(), pairDouble.v0x());
+         pairDeviation[kVarV0y].fill(pairSingle.v0y(), pairDouble.v0y());
+         pairDeviation[kVarV0z].fill(pairSingle.v0z(), pairDouble.v0z());
+      }
+      else if (bGoodDouble != bGoodSingle)
+      {
+         ++pairDeviation[kVarM].nMismatch;
+      }
+
+      StKaonPion const kaonPionDouble(table, row1, row2);
+      StKaonPion const kaonPionSingle(table, row1, row2, true);
+      kaonPionDeviation[kVarM].fill(kaonPionSingle.m(), kaonPionDouble.m());
+      kaonPionDeviation[kVarPt].fill(kaonPionSingle.pt(), kaonPionDouble.pt());
+      kaonPionDeviation[kVarEta].fill(kaonPionSingle.eta(), kaonPionDouble.eta());
+      kaonPionDeviation[kVarPhi].fill(kaonPionSingle.phi(), kaonPionDouble.phi(), true);
+      kaonPionDeviation[kVarCosPointingAngle].fill(kaonPionSingle.cosPointingAngle(), kaonPionDouble.cosPointingAngle());
+      kaonPionDeviation[kVarDecayLength].fill(kaonPionSingle.decayLength(), kaonPionDouble.decayLength());
+      kaonPionDeviation[kVarDcaDaughters].fill(kaonPionSingle.dcaDaughters(), kaonPionDouble.dcaDaughters());
+      kaonPionDeviation[kVarCosThetaStar].fill(kaonPionSingle.cosThetaStar(), kaonPionDouble.cosThetaStar());
+   }
+
+   // tertiary : tracks with the first opposite charge pairs, e.g. pi + K0s
+   vector<StHFPair*> v0s;
+   for (unsigned int i = 0; i < nPairs && v0s.size() < config.nTertiaryPairs; ++i)
+   {
+      if (tracks[pair1[i]].charge() == tracks[pair2[i]].charge()) continue;
+      v0s.push_back(new StHFPair(tracks[pair1[i]], tracks[pair2[i]], M_PION_PLUS, M_PION_MINUS, vtx, bField));
+   }
+
+   unsigned long long nTertiary = 0;
+   start = now();
+   for (unsigned int iV0 = 0; iV0 < v0s.size(); ++iV0)
+   {
+      for (unsigned int i = 0; i < nTracks && nTertiary < config.maxPairs; ++i, ++nTertiary)
+      {
+         StHFPair const pair(tracks[i], v0s[iV0], M_PION_PLUS, M_KAON_0_SHORT, iV0, vtx, bField);
+         checksum += pair.m();
+      }
+   }
+   results[kTertiaryPair].seconds += now() - start;
+   results[kTertiaryPair].n += nTertiary;
+
+   for (unsigned int iV0 = 0; iV0 < v0s.size(); ++iV0) delete v0s[iV0];
+
+   // triplets (i, j, k), i < j < k, up to config.maxTriplets
+   unsigned long long nTriplets = 0;
+   start = now();
+   for (unsigned int i = 0; i < nTracks && nTriplets < config.maxTriplets; ++i)
+   {
+      for (unsigned int j = i + 1; j < nTracks && nTriplets < config.maxTriplets; ++j)
+      {
+         for (unsigned int k = j + 1; k < nTracks && nTriplets < config.maxTriplets; ++k, ++nTriplets)
+         {
+            StHFTriplet const triplet(tracks[i], tracks[j], tracks[k], M_KAON_PLUS, M_PION_PLUS, M_PROTON, vtx, bField);
+            checksum += triplet.m();
+         }
+      }
+   }
+   results[kTriplet].seconds += now() - start;
+   results[kTriplet].n += nTriplets;
+}
+
+//-----------------------------------------------------------------------------
+// decay vertex resolution of the vertexing modes : two-body decays at a known decay vertex,
+// primary vertex at the origin, daughters with pT 0.15 - 1 GeV/c, decay length ~ exp(1 cm)
+void runResolution(BenchmarkConfig const& config, ResolutionResult* resolution)
+{
+   TRandom3 random(config.seed + 1);
+   StHFTrackTable table;
+   StThreeVectorF const vtx(0., 0., 0.);
+
+   for (unsigned int iDecay = 0; iDecay < config.nDecays; ++iDecay)
+   {
+      double const decayLength = random.Exp(1.);
+      double const theta = acos(random.Uniform(-0.76, 0.76)); // |eta| < 1
+      double const phi = random.Uniform(0., 2. * M_PI);
+      StThreeVectorD const decayVertex(decayLength * sin(theta) * cos(phi), decayLength * sin(theta) * sin(phi),
+                                       decayLength * cos(theta));
+
+      table.reset(2, vtx.x(), vtx.y(), vtx.z(), config.bField);
+
+      int rows[2];
+      for (int iDaughter = 0; iDaughter < 2; ++iDaughter)
+      {
+         double const pt = random.Uniform(0.15, 1.);
+         double const eta = random.Uniform(-1., 1.);
+         double const phiDaughter = random.Uniform(0., 2. * M_PI);
+         short const charge = iDaughter ? -1 : 1;
+
+         StThreeVectorD const mom(pt * cos(phiDaughter), pt * sin(phiDaughter), pt * sinh(eta));
+         StPhysicalHelixD const helix(mom, decayVertex, config.bField * kilogauss, charge);
+
+         rows[iDaughter] = StHFCachedTrack(helix, charge, iDaughter, iDaughter, vtx, config.bField).addToTable(table, 0.);
+      }
+
+      for (int iMode = 0; iMode < nVertexingModes; ++iMode)
+      {
+         StHFPairKinematics kin;
+         StHFPairKernel::straightLineDca(table, rows[0], rows[1], kin);
+
+         if (iMode == StHFCuts::kHelixRefine)
+            StHFPairKernel::refineHelixDca(table, rows[0], rows[1], 2, 0., kin);
+         else if (iMode == StHFCuts::kHelixFull)
+            StHFPairKernel::refineHelixDca(table, rows[0], rows[1], StHFPairKernel::helixFullIterationsMax,
+                                           StHFPairKernel::helixFullTolerance, kin);
+
+         StThreeVectorD const reco(kin.v0[0], kin.v0[1], kin.v0[2]);
+         double const distance = (reco - decayVertex).mag();
+
+         ++resolution[iMode].n;
+         resolution[iMode].sumDistance += distance;
+         resolution[iMode].sumDistance2 += distance * distance;
+         resolution[iMode].sumDcaDaughters += kin.dcaDaughters;
+      }
+   }
+}
+
+//-----------------------------------------------------------------------------
+// deviations of one candidate class as JSON object, variables without entries are skipped
+void writeJsonDeviations(ostream& out, char const* name, DeviationResult const* deviation, bool last)
+{
+   out << "    \"" << name << "\": {";
+
+   bool first = true;
+   for (int i = 0; i < kVariableMax; ++i)
+   {
+      if (deviation[i].n == 0 && deviation[i].nMismatch == 0) continue;
+
+      out << (first ? "\n" : ",\n") << "      \"" << variableNames[i] << "\": {\"n\": " << deviation[i].n
+          << ", \"nMismatch\": " << deviation[i].nMismatch << ", \"maxAbsolute\": " << deviation[i].maxAbsolute
+          << ", \"maxRelative\": " << deviation[i].maxRelative << "}";
+      first = false;
+   }
+
+   out << "\n    }" << (last ? "\n" : ",\n");
+}
+
+//-----------------------------------------------------------------------------
+void printDeviations(char const* name, DeviationResult const* deviation)
+{
+   cout << "  " << name << " :" << endl;
+   for (int i = 0; i < kVariableMax; ++i)
+   {
+      if (deviation[i].n == 0 && deviation[i].nMismatch == 0) continue;
+
+      cout << "    " << variableNames[i] << " : max |delta| " << deviation[i].maxAbsolute << ", max |delta|/|double| "
+           << deviation[i].maxRelative << ", " << deviation[i].nMismatch << " mismatches in " << deviation[i].n << endl;
+   }
+}
+
+//-----------------------------------------------------------------------------
+bool writeJson(string const& fileName, BenchmarkConfig const& config, BenchmarkResult const* results,
+               DeviationResult const* pairDeviation, DeviationResult const* kaonPionDeviation,
+               ResolutionResult const* resolution)
+{
+   ofstream out(fileName.c_str());
+   if (!out) return false;
+
+   out << "{\n"
+       << "  \"benchmark\": \"hfKinematics\",\n"
+       << "  \"config\": {\"nEvents\": " << config.nEvents << ", \"nTracksCentral\": " << config.nTracksCentral
+       << ", \"maxPairs\": " << config.maxPairs << ", \"nTertiaryPairs\": " << config.nTertiaryPairs
+       << ", \"maxTriplets\": " << config.maxTriplets << ", \"nDecays\": " << config.nDecays << ", \"seed\": " << config.seed << ", \"bField\": " << config.bField << "},\n"
+       << "  \"results\": {\n";
+
+   for (int i = 0; i < kBenchmarkMax; ++i)
+   {
+      out << "    \"" << benchmarkNames[i] << "\": {\"n\": " << results[i].n << ", \"seconds\": " << results[i].seconds
+          << ", \"nsPerPair\": " << results[i].nsPerPair() << ", \"pairsPerSecond\": " << results[i].pairsPerSecond() << "}"
+          << (i + 1 < kBenchmarkMax ? ",\n" : "\n");
+   }
+
+   out << "  },\n"
+       << "  \"singlePrecision\": {\n";
+
+   writeJsonDeviations(out, "pair", pairDeviation, false);
+   writeJsonDeviations(out, "kaonPion", kaonPionDeviation, true);
+
+   out << "  },\n"
+       << "  \"resolution\": {\n";
+
+   for (int i = 0; i < nVertexingModes; ++i)
+   {
+      out << "    \"" << vertexingModeNames[i] << "\": {\"n\": " << resolution[i].n << ", \"meanUm\": " << resolution[i].meanUm()
+          << ", \"rmsUm\": " << resolution[i].rmsUm() << ", \"meanDcaDaughtersUm\": " << resolution[i].meanDcaDaughtersUm() << "}"
+          << (i + 1 < nVertexingModes ? ",\n" : "\n");
+   }
+
+   out << "  }\n"
+       << "}\n";
+
+   return out.good();
+}
+
+//-----------------------------------------------------------------------------
+// nsPerPair of a benchmark in a JSON written by writeJson, negative if not found
+double readBaseline(string const& json, char const* name)
+{
+   string::size_type pos = json.find(string("\"") + name + "\"");
+   if (pos == string::npos) return -1.;
+
+   pos = json.find("\"nsPerPair\":", pos);
+   if (pos == string::npos) return -1.;
+
+   return atof(json.c_str() + pos + 12);
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+   BenchmarkConfig config;
+
+   int opt;
+   while ((opt = getopt(argc, argv, "e:m:p:k:t:d:s:o:b:r:")) != -1)
+   {
+      switch (opt)
+      {
+         case 'e': config.nEvents = atoi(optarg); break;
+         case 'm': config.nTracksCentral = atoi(optarg); break;
+         case 'p': config.maxPairs = atoi(optarg); break;
+         case 'k': config.nTertiaryPairs = atoi(optarg); break;
+         case 't': config.maxTriplets = atoi(optarg); break;
+         case 'd': config.nDecays = atoi(optarg); break;
+         case 's': config.seed = atoi(optarg); break;
+         case 'o': config.outputFile = optarg; break;
+         case 'b': config.baselineFile = optarg; break;
+         case 'r': config.tolerance = atof(optarg); break;
+         default:
+            cerr << "Usage: " << argv[0] << " [-e nEvents] [-m nTracksCentral] [-p maxPairsPerEvent] [-k nTertiaryPairs]"
+                 << " [-t maxTripletsPerEvent] [-d nDecays] [-s seed] [-o result.json] [-b baseline.json] [-r tolerance]" << endl;
+            return 2;
+      }
+   }
+
+   SyntheticEventGenerator generator(config);
+   StHFTrackTable table;
+   vector<StHFCachedTrack> tracks;
+   StThreeVectorF vtx;
+
+   // open pair cuts, one per vertexing mode
+   StHFCuts vertexingCuts[nVertexingModes];
+   for (int iMode = 0; iMode < nVertexingModes; ++iMode)
+   {
+      vertexingCuts[iMode].setCutSecondaryPair(1.e3, 0., 1.e3, -2., 0., 1.e3);
+      vertexingCuts[iMode].setVertexingMode(iMode, 2);
+      vertexingCuts[iMode].finalize();
+   }
+
+   StHFCuts singleCuts;
+   singleCuts.setCutSecondaryPair(1.e3, 0., 1.e3, -2., 0., 1.e3);
+   singleCuts.setKinematicsPrecision(StHFPairKernel::kSinglePrecision);
+   singleCuts.finalize();
+
+   DeviationResult pairDeviation[kVariableMax];
+   DeviationResult kaonPionDeviation[kVariableMax];
+
+   BenchmarkResult results[kBenchmarkMax];
+   double checksum = 0.;
+   unsigned long long nTracksTotal = 0;
+
+   for (unsigned int iEvent = 0; iEvent < config.nEvents; ++iEvent)
+   {
+      generator.generate(vtx, tracks);
+      nTracksTotal += tracks.size();
+      runEvent(config, vtx, tracks, vertexingCuts, singleCuts, table, results, pairDeviation, kaonPionDeviation, checksum);
+   }
+
+   ResolutionResult resolution[nVertexingModes];
+   runResolution(config, resolution);
+
+   cout << "hfKinematicsBenchmark : " << config.nEvents << " events, " << nTracksTotal << " tracks, checksum " << checksum << endl;
+   for (int i = 0; i < kBenchmarkMax; ++i)
+   {
+      cout << "  " << benchmarkNames[i] << " : " << results[i].n << " pairs, " << results[i].nsPerPair() << " ns/pair, "
+           << results[i].pairsPerSecond() << " pairs/s" << endl;
+   }
+
+   cout << "float only versus double precision kinematics :" << endl;
+   printDeviations("pair", pairDeviation);
+   printDeviations("kaonPion", kaonPionDeviation);
+
+   cout << "decay vertex resolution : " << config.nDecays << " decays, daughters with pT 0.15 - 1 GeV/c" << endl;
+   for (int i = 0; i < nVertexingModes; ++i)
+   {
+      cout << "  " << vertexingModeNames[i] << " : mean " << resolution[i].meanUm() << " um, RMS " << resolution[i].rmsUm()
+           << " um, mean dcaDaughters " << resolution[i].meanDcaDaughtersUm() << " um" << endl;
+   }
+
+   if (!config.outputFile.empty() && !writeJson(config.outputFile, config, results, pairDeviation, kaonPionDeviation, resolution))
+   {
+      cerr << "Could not write " << config.outputFile << endl;
+      return 2;
+   }
+
+   if (config.baselineFile.empty()) return 0;
+
+   ifstream in(config.baselineFile.c_str());
+   if (!in)
+   {
+      cerr << "Could not read baseline " << config.baselineFile << endl;
+      return 2;
+   }
+   stringstream buffer;
+   buffer << in.rdbuf();
+   string const baseline = buffer.str();
+
+   int iReturn = 0;
+   cout << "comparison to " << config.baselineFile << " (tolerance " << 100. * config.tolerance << "%) :" << endl;
+   for (int i = 0; i < kBenchmarkMax; ++i)
+   {
+      double const nsBaseline = readBaseline(baseline, benchmarkNames[i]);
+      if (nsBaseline <= 0. || results[i].n == 0) continue;
+
+      double const ratio = results[i].nsPerPair() / nsBaseline;
+      bool const slower = ratio > 1. + config.tolerance;
+      if (slower) iReturn = 1;
+
+      cout << "  " << benchmarkNames[i] << " : " << results[i].nsPerPair() << " ns/pair, baseline " << nsBaseline
+           << " ns/pair, ratio " << ratio << (slower ? "  <-- SLOWER" : "") << endl;
+   }
+
+   return iReturn;
+}
@@ -0,0 +1,20 @@
+// dictionaries for the classes linked into hfKinematicsBenchmark
+#if defined(__CINT__) || defined(__CLING__)
+
+#pragma link off all globals;
+#pragma link off all classes;
+#pragma link off all functions;
+
+#pragma link C++ class StThreeVector<float>+;
+#pragma link C++ class StThreeVector<double>+;
+#pragma link C++ class StLorentzVector<float>+;
+#pragma link C++ class StLorentzVector<double>+;
+#pragma link C++ class StHelix+;
+#pragma link C++ class StPhysicalHelix+;
+
+#pragma link C++ class StHFPair+;
+#pragma link C++ class StHFTriplet+;
+#pragma link C++ class StHFCuts+;
+#pragma link C++ class StKaonPion+;
+
+#endif
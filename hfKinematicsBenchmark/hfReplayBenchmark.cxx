@@ -0,0 +1,369 @@
+/* **************************************************
+ *  Replay of events captured by StPicoHFMaker::setCaptureFile(...)
+ *  through the candidate builders and cuts of StPicoHFMaker,
+ *  without StPicoDst and without the STAR environment
+ *
+ *  - the track table and the track cache (helices) are rebuilt
+ *    from the captured rows, the particle lists from the captured bits
+ *  - the file is replayed nRepeats times, timed builders :
+ *     secondaryPairs  - Kπ pairs, StHFCuts::isGoodSecondaryVertexPair(table, ...)
+ *     tertiaryPairs   - ππ pairs of opposite charge, StHFCuts::isGoodTertiaryVertexPair(table, ...)
+ *     triplets        - Kπp triplets from the track cache, StHFCuts::isGoodSecondaryVertexTriplet(...)
+ *  - the number of accepted candidates and the sum of their masses
+ *    are printed, to compare the output of two kernels (A/B)
+ *  - pair loops can use the mass window pre-filter (-m) and the
+ *    direction grid (-g), as StPicoHFMaker::pairPartners(...)
+ *  - the cuts are the StHFCuts "hfCuts" written by the capturing maker
+ *    to <capture>.cuts.root (or the file given with -c), so that the
+ *    replay reproduces the selection of the production
+ *
+ *  Usage : hfReplayBenchmark -f capture.bin [-c cuts.root] [-n nRepeats] [-m massFilterMode] 
+ *                            [-g gridMode] [-t maxTripletsPerEvent] [-o result.json]
+ *
+ * **************************************************
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstdlib>
+#include <ctime>
+#include <unistd.h>
+
+#include "StThreeVectorF.hh"
+#include "StThreeVectorD.hh"
+#include "StPhysicalHelixD.hh"
+#include "SystemOfUnits.h"
+#include "phys_constants.h"
+
+#include "StPicoHFMaker/StHFCaptureFile.h"
+#include "StPicoHFMaker/StHFTrackCache.h"
+#include "StPicoHFMaker/StHFTrackTable.h"
+#include "StPicoHFMaker/StHFMassWindowFilter.h"
+#include "StPicoHFMaker/StHFDirectionGrid.h"
+#include "StPicoHFMaker/StHFPair.h"
+#include "StPicoHFMaker/StHFTriplet.h"
+#include "StPicoHFMaker/StHFCuts.h"
+
+#include "TFile.h"
+
+using namespace std;
+
+// -- builders, in order of the output
+enum eBuilder {kSecondaryPairs, kTertiaryPairs, kTriplets, kBuilderMax};
+char const * const builderNames[kBuilderMax] = {"secondaryPairs", "tertiaryPairs", "triplets"};
+
+//-----------------------------------------------------------------------------
+struct ReplayConfig
+{
+   ReplayConfig() : nRepeats(10), massFilterMode(StHFMassWindowFilter::kNoMassFilter),
+                    gridMode(StHFDirectionGrid::kNoGrid), maxTriplets(100000) {}
+
+   string captureFile;
+   string cutsFile;             // default : <captureFile>.cuts.root
+   unsigned int nRepeats;
+   unsigned int massFilterMode; // StHFMassWindowFilter::eMassFilterMode
+   unsigned int gridMode;       // StHFDirectionGrid::eGridMode
+   unsigned int maxTriplets;
+   string outputFile;
+};
+
+//-----------------------------------------------------------------------------
+struct BuilderResult
+{
+   BuilderResult() : nTried(0), nAccepted(0), seconds(0.), massSum(0.) {}
+
+   unsigned long long nTried;
+   unsigned long long nAccepted;
+   double seconds;
+   double massSum;
+};
+
+//-----------------------------------------------------------------------------
+// one replayed event : track table, track cache and particle lists
+struct ReplayEvent
+{
+   StThreeVectorF vtx;
+   float bField;
+   StHFTrackTable table;
+   vector<StHFCachedTrack> tracks; // same order as the rows of the table
+   vector<unsigned short> pions;   // StPicoDst indices, as mIdxPicoPions
+   vector<unsigned short> kaons;
+   vector<unsigned short> protons;
+};
+
+//-----------------------------------------------------------------------------
+double now()
+{
+   timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + 1.e-9 * ts.tv_nsec;
+}
+
+//-----------------------------------------------------------------------------
+void setupEvent(StHFCapturedEvent const& captured, vector<StHFCapturedTrack> const& capturedTracks, ReplayEvent& event)
+{
+   event.vtx = StThreeVectorF(captured.vtxX, captured.vtxY, captured.vtxZ);
+   event.bField = captured.bField;
+
+   // rows are addressed by StPicoDst index, size the table for the largest index
+   unsigned int nIdx = 0;
+   for (unsigned int i = 0; i < capturedTracks.size(); ++i) nIdx = max(nIdx, capturedTracks[i].idx + 1u);
+
+   event.table.reset(nIdx, captured.vtxX, captured.vtxY, captured.vtxZ, captured.bField);
+   event.tracks.clear();
+   event.pions.clear();
+   event.kaons.clear();
+   event.protons.clear();
+
+   for (unsigned int i = 0; i < capturedTracks.size(); ++i)
+   {
+      StHFCapturedTrack const& trk = capturedTracks[i];
+      trk.addToTable(event.table);
+
+      StThreeVectorD const mom(trk.px, trk.py, trk.pz);
+      StThreeVectorD const origin(captured.vtxX + trk.dcaX, captured.vtxY + trk.dcaY, captured.vtxZ + trk.dcaZ);
+      short const charge = trk.charge > 0 ? 1 : -1;
+      StPhysicalHelixD const helix(mom, origin, captured.bField * kilogauss, charge);
+      event.tracks.push_back(StHFCachedTrack(helix, charge, trk.id, trk.idx, event.vtx, captured.bField));
+
+      if (trk.particles & StHFCapturedTrack::kPion) event.pions.push_back(trk.idx);
+      if (trk.particles & StHFCapturedTrack::kKaon) event.kaons.push_back(trk.idx);
+      if (trk.particles & StHFCapturedTrack::kProton) event.protons.push_back(trk.idx);
+   }
+}
+
+//-----------------------------------------------------------------------------
+// positions in list2 to be paired with row1, as StPicoHFMaker::pairPartners(...)
+void pairPartners(ReplayConfig const& config, ReplayEvent const& event, StHFCuts const& cuts, bool secondary,
+                  StHFMassWindowFilter const& massFilter, StHFDirectionGrid const& grid, unsigned int nList2,
+                  int row1, float mass1, vector<unsigned short>& positions, vector<unsigned short>& gridPositions,
+                  vector<unsigned short>& intersection)
+{
+   if (config.massFilterMode == StHFMassWindowFilter::kNoMassFilter)
+   {
+      positions.resize(nList2);
+      for (unsigned short i = 0; i < nList2; ++i) positions[i] = i;
+   }
+   else
+   {
+      float const massMin = secondary ? cuts.cutSecondaryPairMassMin() : cuts.cutTertiaryPairMassMin();
+      float const massMax = secondary ? cuts.cutSecondaryPairMassMax() : cuts.cutTertiaryPairMassMax();
+      massFilter.partners(event.table, row1, mass1, massMin, massMax, positions);
+   }
+
+   if (config.gridMode != StHFDirectionGrid::kNoGrid)
+   {
+      float const dcaDaughtersMax = secondary ? cuts.cutSecondaryPairDcaDaughtersMax() : cuts.cutTertiaryPairDcaDaughtersMax();
+      float const decayLengthMin = secondary ? cuts.cutSecondaryPairDecayLengthMin() : cuts.cutTertiaryPairDecayLengthMin();
+      grid.partners(event.table, row1, dcaDaughtersMax, decayLengthMin, gridPositions);
+
+      // output range of set_intersection must not overlap its inputs
+      intersection.clear();
+      set_intersection(positions.begin(), positions.end(), gridPositions.begin(), gridPositions.end(), back_inserter(intersection));
+      positions.swap(intersection);
+   }
+}
+
+//-----------------------------------------------------------------------------
+void runEvent(ReplayConfig const& config, ReplayEvent const& event, StHFCuts const& cuts,
+              StHFMassWindowFilter& massFilter, StHFDirectionGrid& grid, BuilderResult* results)
+{
+   StHFTrackTable const& table = event.table;
+   vector<unsigned short> positions;
+   vector<unsigned short> gridPositions;
+   vector<unsigned short> intersection;
+   StHFPair pair;
+
+   // -- secondary Kπ pairs
+   double start = now();
+   if (config.massFilterMode != StHFMassWindowFilter::kNoMassFilter) massFilter.setup(table, event.pions, M_PION_PLUS);
+   if (config.gridMode != StHFDirectionGrid::kNoGrid) grid.setup(table, event.pions);
+
+   for (unsigned int ik = 0; ik < event.kaons.size(); ++ik)
+   {
+      int const kRow = table.row(event.kaons[ik]);
+      pairPartners(config, event, cuts, true, massFilter, grid, event.pions.size(), kRow, M_KAON_PLUS, positions, gridPositions, intersection);
+
+      for (unsigned int iPos = 0; iPos < positions.size(); ++iPos)
+      {
+         int const pRow = table.row(event.pions[positions[iPos]]);
+         if (event.kaons[ik] == event.pions[positions[iPos]]) continue;
+
+         ++results[kSecondaryPairs].nTried;
+         if (!cuts.isGoodSecondaryVertexPair(table, kRow, pRow, M_KAON_PLUS, M_PION_PLUS, pair)) continue;
+
+         ++results[kSecondaryPairs].nAccepted;
+         results[kSecondaryPairs].massSum += pair.m();
+      }
+   }
+   results[kSecondaryPairs].seconds += now() - start;
+
+   // -- tertiary ππ pairs of opposite charge, partners are the pions as above
+   start = now();
+
+   for (unsigned int ip1 = 0; ip1 < event.pions.size(); ++ip1)
+   {
+      int const row1 = table.row(event.pions[ip1]);
+      pairPartners(config, event, cuts, false, massFilter, grid, event.pions.size(), row1, M_PION_PLUS, positions, gridPositions, intersection);
+
+      for (vector<unsigned short>::const_iterator iPos = upper_bound(positions.begin(), positions.end(), ip1); iPos != positions.end(); ++iPos)
+      {
+         int const row2 = table.row(event.pions[*iPos]);
+         if (table.charge()[row1] * table.charge()[row2] > 0) continue;
+
+         ++results[kTertiaryPairs].nTried;
+         if (!cuts.isGoodTertiaryVertexPair(table, row1, row2, M_PION_PLUS, M_PION_MINUS, pair)) continue;
+
+         ++results[kTertiaryPairs].nAccepted;
+         results[kTertiaryPairs].massSum += pair.m();
+      }
+   }
+   results[kTertiaryPairs].seconds += now() - start;
+
+   // -- Kπp triplets from the track cache
+   start = now();
+   unsigned int nTriplets = 0;
+   for (unsigned int ik = 0; ik < event.kaons.size() && nTriplets < config.maxTriplets; ++ik)
+   {
+      StHFCachedTrack const& kaon = event.tracks[table.row(event.kaons[ik])];
+
+      for (unsigned int ip = 0; ip < event.pions.size() && nTriplets < config.maxTriplets; ++ip)
+      {
+         if (event.kaons[ik] == event.pions[ip]) continue;
+         StHFCachedTrack const& pion = event.tracks[table.row(event.pions[ip])];
+
+         for (unsigned int ipr = 0; ipr < event.protons.size() && nTriplets < config.maxTriplets; ++ipr)
+         {
+            if (event.protons[ipr] == event.kaons[ik] || event.protons[ipr] == event.pions[ip]) continue;
+            StHFCachedTrack const& proton = event.tracks[table.row(event.protons[ipr])];
+
+            ++nTriplets;
+            StHFTriplet const triplet(kaon, pion, proton, M_KAON_PLUS, M_PION_PLUS, M_PROTON, event.vtx, event.bField);
+            if (!cuts.isGoodSecondaryVertexTriplet(triplet)) continue;
+
+            ++results[kTriplets].nAccepted;
+            results[kTriplets].massSum += triplet.m();
+         }
+      }
+   }
+   results[kTriplets].nTried += nTriplets;
+   results[kTriplets].seconds += now() - start;
+}
+
+//-----------------------------------------------------------------------------
+bool writeJson(string const& fileName, ReplayConfig const& config, unsigned int nEvents, BuilderResult const* results)
+{
+   ofstream out(fileName.c_str());
+   if (!out) return false;
+
+   out << "{\n"
+       << "  \"benchmark\": \"hfReplay\",\n"
+       << "  \"config\": {\"captureFile\": \"" << config.captureFile << "\", \"cutsFile\": \"" << config.cutsFile 
+       << "\", \"nEvents\": " << nEvents
+       << ", \"nRepeats\": " << config.nRepeats << ", \"massFilterMode\": " << config.massFilterMode
+       << ", \"gridMode\": " << config.gridMode << ", \"maxTriplets\": " << config.maxTriplets << "},\n"
+       << "  \"results\": {\n";
+
+   for (int i = 0; i < kBuilderMax; ++i)
+   {
+      BuilderResult const& r = results[i];
+      out << "    \"" << builderNames[i] << "\": {\"nTried\": " << r.nTried << ", \"nAccepted\": " << r.nAccepted
+          << ", \"seconds\": " << r.seconds << ", \"nsPerCandidate\": " << (r.nTried ? 1.e9 * r.seconds / r.nTried : 0.)
+          << ", \"massSum\": " << r.massSum << "}" << (i + 1 < kBuilderMax ? ",\n" : "\n");
+   }
+
+   out << "  }\n"
+       << "}\n";
+
+   return out.good();
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+   ReplayConfig config;
+
+   int opt;
+   while ((opt = getopt(argc, argv, "f:c:n:m:g:t:o:")) != -1)
+   {
+      switch (opt)
+      {
+         case 'f': config.captureFile = optarg; break;
+         case 'c': config.cutsFile = optarg; break;
+         case 'n': config.nRepeats = atoi(optarg); break;
+         case 'm': config.massFilterMode = atoi(optarg); break;
+         case 'g': config.gridMode = atoi(optarg); break;
+         case 't': config.maxTriplets = atoi(optarg); break;
+         case 'o': config.outputFile = optarg; break;
+         default: config.captureFile.clear(); optind = argc; break;
+      }
+   }
+
+   if (config.captureFile.empty())
+   {
+      cerr << "Usage: " << argv[0] << " -f capture.bin [-c cuts.root] [-n nRepeats] [-m massFilterMode] [-g gridMode]"
+           << " [-t maxTripletsPerEvent] [-o result.json]" << endl;
+      return 2;
+   }
+
+   if (config.cutsFile.empty()) config.cutsFile = config.captureFile + ".cuts.root";
+
+   StHFCaptureReader reader;
+   if (!reader.open(config.captureFile.c_str()))
+   {
+      cerr << "Could not open capture file " << config.captureFile << endl;
+      return 2;
+   }
+
+   // -- cuts of the capturing maker, including vertexing mode and precision
+   TFile* cutsFile = TFile::Open(config.cutsFile.c_str());
+   StHFCuts* capturedCuts = cutsFile ? dynamic_cast<StHFCuts*>(cutsFile->Get("hfCuts")) : NULL;
+   if (!capturedCuts)
+   {
+      cerr << "Could not read cuts \"hfCuts\" from " << config.cutsFile << endl;
+      return 2;
+   }
+   capturedCuts->finalize();
+   StHFCuts const& cuts = *capturedCuts;
+
+   StHFMassWindowFilter massFilter;
+   StHFDirectionGrid grid;
+
+   // -- read all events once, replay them from memory
+   vector<ReplayEvent*> events;
+   StHFCapturedEvent captured;
+   vector<StHFCapturedTrack> capturedTracks;
+   while (reader.read(captured, capturedTracks))
+   {
+      ReplayEvent* event = new ReplayEvent;
+      setupEvent(captured, capturedTracks, *event);
+      events.push_back(event);
+   }
+
+   BuilderResult results[kBuilderMax];
+   for (unsigned int iRepeat = 0; iRepeat < config.nRepeats; ++iRepeat)
+   {
+      for (unsigned int iEvent = 0; iEvent < events.size(); ++iEvent) runEvent(config, *events[iEvent], cuts, massFilter, grid, results);
+   }
+
+   cout << "hfReplayBenchmark : " << events.size() << " events x " << config.nRepeats << " from " << config.captureFile << endl;
+   for (int i = 0; i < kBuilderMax; ++i)
+   {
+      BuilderResult const& r = results[i];
+      cout << "  " << builderNames[i] << " : " << r.nTried << " tried, " << r.nAccepted << " accepted, "
+           << (r.nTried ? 1.e9 * r.seconds / r.nTried : 0.) << " ns/candidate, mass sum " << r.massSum << endl;
+   }
+
+   bool const bWritten = config.outputFile.empty() || writeJson(config.outputFile, config, events.size(), results);
+   if (!bWritten) cerr << "Could not write " << config.outputFile << endl;
+
+   for (unsigned int iEvent = 0; iEvent < events.size(); ++iEvent) delete events[iEvent];
+   delete capturedCuts;
+   delete cutsFile;
+
+   return bWritten ? 0 : 2;
+}